@@ -60,6 +60,8 @@ var Program = (function () {
         this.liveBuffer = "";
         this.liveSimulationInitializationLines = [];
         this.liveSimulationName = "";
+        // the last full nodestats line of every node
+        this.liveNodeStats = [];
         LISTENER_PORT = parseInt((typeof args[0] === 'undefined') ? "7707" : args[0]);
         HTTP_PORT = parseInt((typeof args[1] === 'undefined') ? "8080" : args[1]);
         BIND_ADDRESS = (typeof args[2] === 'undefined') ? "" : args[2];
@@ -142,6 +144,12 @@ var Program = (function () {
                 var initLine = _a[_i];
                 sock.emit("entry", new Entry("live", initLine));
             }
+            // the nodestatsdelta records that follow only have the changes since these
+            for (var _b = 0, _c = this.liveNodeStats; _b < _c.length; _b++) {
+                var statsLine = _c[_b];
+                if (typeof statsLine != "undefined")
+                    sock.emit("entry", new Entry("live", statsLine));
+            }
             onDone();
         }
         else {
@@ -210,6 +218,7 @@ var Program = (function () {
         var parts = line.split(';');
         if (parts[1] == "start") {
             this.liveSimulationInitializationLines = [];
+            this.liveNodeStats = [];
             this.liveSimulationName = parts[13] + ".nss";
             try {
                 if (this.liveSimulationName != "") {
@@ -222,6 +231,19 @@ var Program = (function () {
         }
         else if (parts[1] == "stanodeadd" || parts[1] == "apnodeadd" || parts[1] == "stanodeassoc" || parts[1] == "rawconfig")
             this.liveSimulationInitializationLines.push(line);
+        else if (parts[1] == "nodestats")
+            this.liveNodeStats[parseInt(parts[2])] = line;
+        else if (parts[1] == "nodestatsdelta") {
+            // pairs of the index in the nodestats line and the new value
+            var last = this.liveNodeStats[parseInt(parts[2])];
+            if (typeof last != "undefined") {
+                var statsParts = last.split(';');
+                statsParts[0] = parts[0];
+                for (var i = 3; i + 1 < parts.length; i += 2)
+                    statsParts[parseInt(parts[i])] = parts[i + 1];
+                this.liveNodeStats[parseInt(parts[2])] = statsParts.join(';');
+            }
+        }
         for (var _i = 0, _a = this.activeSocketManager.getSocketsFor("live"); _i < _a.length; _i++) {
             var s = _a[_i];
             s.emit("entry", new Entry("live", line));
@@ -160,6 +160,11 @@ export class Program {
         if (stream == "live") {
             for (let initLine of this.liveSimulationInitializationLines)
                 sock.emit("entry", new Entry("live", initLine));
+            // the nodestatsdelta records that follow only have the changes since these
+            for (let statsLine of this.liveNodeStats) {
+                if (typeof statsLine != "undefined")
+                    sock.emit("entry", new Entry("live", statsLine));
+            }
             onDone();
         }
         else {
@@ -236,6 +241,8 @@ export class Program {
 
     liveSimulationInitializationLines: string[] = [];
     liveSimulationName: string = "";
+    // the last full nodestats line of every node
+    liveNodeStats: string[] = [];
     private processMessage(line: string) {
 
 
@@ -243,6 +250,7 @@ export class Program {
         var parts = line.split(';');
         if (parts[1] == "start") {
             this.liveSimulationInitializationLines = [];
+            this.liveNodeStats = [];
             this.liveSimulationName = parts[13] + ".nss";
 
             try {
@@ -257,6 +265,19 @@ export class Program {
         }
         else if (parts[1] == "stanodeadd" || parts[1] == "apnodeadd" || parts[1] == "stanodeassoc" || parts[1] == "rawconfig")
             this.liveSimulationInitializationLines.push(line);
+        else if (parts[1] == "nodestats")
+            this.liveNodeStats[parseInt(parts[2])] = line;
+        else if (parts[1] == "nodestatsdelta") {
+            // pairs of the index in the nodestats line and the new value
+            let last = this.liveNodeStats[parseInt(parts[2])];
+            if (typeof last != "undefined") {
+                let statsParts = last.split(';');
+                statsParts[0] = parts[0];
+                for (let i = 3; i + 1 < parts.length; i += 2)
+                    statsParts[parseInt(parts[i])] = parts[i + 1];
+                this.liveNodeStats[parseInt(parts[2])] = statsParts.join(';');
+            }
+        }
 
         for (let s of this.activeSocketManager.getSocketsFor("live")) {
             s.emit("entry", new Entry("live", line));
@@ -3,6 +3,9 @@ class EventManager {
 
     events: SimulationEvent[] = [];
 
+    // last full nodestats parts of each node per stream, nodestatsdelta records only contain the changes
+    private lastNodeStats: { [stream: string]: string[][] } = {};
+
     private updateGUI: boolean;
 
     constructor(private sim: SimulationGUI) {
@@ -123,13 +126,47 @@ class EventManager {
         let time = parseInt(parts[0]);
         //console.log("evManager3 " + parts);
         
-        
+        if (parts[1] == "nodestatsdelta") {
+            parts = this.applyNodeStatsDelta(entry.stream, parts);
+            if (parts == null) // no full nodestats of the node yet
+                return;
+        }
+        else if (parts[1] == "nodestats")
+            this.getLastNodeStats(entry.stream)[parseInt(parts[2])] = parts;
+        else if (parts[1] == "start")
+            this.lastNodeStats[entry.stream] = [];
+
         time = time / (1000 * 1000); // ns -> ms
 
         let ev = new SimulationEvent(entry.stream, time, parts);
         this.events.push(ev);
     }
 
+    private getLastNodeStats(stream: string): string[][] {
+        if (typeof this.lastNodeStats[stream] == "undefined")
+            this.lastNodeStats[stream] = [];
+        return this.lastNodeStats[stream];
+    }
+
+    /**
+     * Returns the full nodestats parts of a nodestatsdelta record, which lists
+     * pairs of the index of a value in the nodestats record and the new value
+     */
+    private applyNodeStatsDelta(stream: string, deltaParts: string[]): string[] {
+        let id = parseInt(deltaParts[2]);
+        let last = this.getLastNodeStats(stream)[id];
+        if (typeof last == "undefined")
+            return null;
+
+        let parts = last.slice();
+        parts[0] = deltaParts[0];
+        for (let i = 3; i + 1 < deltaParts.length; i += 2)
+            parts[parseInt(deltaParts[i])] = deltaParts[i + 1];
+
+        this.getLastNodeStats(stream)[id] = parts;
+        return parts;
+    }
+
     onStart(stream: string, aidRAWRange: number,
         dataMode: string, dataRate: number, bandwidth: number, trafficInterval: number, trafficPacketsize: number, beaconInterval: number,
         name: string, propagationLossExponent: number, propagationLossReferenceLoss: number, apAlwaysSchedulesForNextSlot: string, minRTO: number, simulationTime: number,
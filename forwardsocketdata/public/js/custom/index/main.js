@@ -704,6 +704,8 @@ var EventManager = (function () {
     function EventManager(sim) {
         this.sim = sim;
         this.events = [];
+        // last full nodestats parts of each node per stream, nodestatsdelta records only contain the changes
+        this.lastNodeStats = {};
     }
     EventManager.prototype.processEvents = function () {
         var eventsProcessed = this.events.length > 0;
@@ -779,10 +781,40 @@ var EventManager = (function () {
         var parts = entry.line.split(';');
         var time = parseInt(parts[0]);
         //console.log("evManager3 " + parts);
+        if (parts[1] == "nodestatsdelta") {
+            parts = this.applyNodeStatsDelta(entry.stream, parts);
+            if (parts == null)
+                return;
+        }
+        else if (parts[1] == "nodestats")
+            this.getLastNodeStats(entry.stream)[parseInt(parts[2])] = parts;
+        else if (parts[1] == "start")
+            this.lastNodeStats[entry.stream] = [];
         time = time / (1000 * 1000); // ns -> ms
         var ev = new SimulationEvent(entry.stream, time, parts);
         this.events.push(ev);
     };
+    EventManager.prototype.getLastNodeStats = function (stream) {
+        if (typeof this.lastNodeStats[stream] == "undefined")
+            this.lastNodeStats[stream] = [];
+        return this.lastNodeStats[stream];
+    };
+    /**
+     * Returns the full nodestats parts of a nodestatsdelta record, which lists
+     * pairs of the index of a value in the nodestats record and the new value
+     */
+    EventManager.prototype.applyNodeStatsDelta = function (stream, deltaParts) {
+        var id = parseInt(deltaParts[2]);
+        var last = this.getLastNodeStats(stream)[id];
+        if (typeof last == "undefined")
+            return null;
+        var parts = last.slice();
+        parts[0] = deltaParts[0];
+        for (var i = 3; i + 1 < deltaParts.length; i += 2)
+            parts[parseInt(deltaParts[i])] = deltaParts[i + 1];
+        this.getLastNodeStats(stream)[id] = parts;
+        return parts;
+    };
     EventManager.prototype.onStart = function (stream, aidRAWRange, dataMode, dataRate, bandwidth, trafficInterval, trafficPacketsize, beaconInterval, name, propagationLossExponent, propagationLossReferenceLoss, apAlwaysSchedulesForNextSlot, minRTO, simulationTime, trafficType, trafficIntervalDeviation, tcpSegmentSize, tcpInitialSlowStartThreshold, tcpInitialCWnd, maxTimeOfPacketsInQueue, ipCameraMotionPercentage, ipCameraMotionDuration, ipCameraDataRate, nsta, cooldownPeriod, firmwareSize, firmwareBlockSize, firmwareCorruptionProbability, firmwareNewUpdateProbability, sensorMeasurementSize, numberOfRAWGroups, RAWSlotFormat, RAWSlotCount, numberOfRAWSlots, contentionPerRAWSlot, contentionPerRAWSlotOnlyInFirstGroup, numRpsElements) {
         var simulation = this.sim.simulationContainer.getSimulation(stream);
         if (typeof simulation == "undefined") {
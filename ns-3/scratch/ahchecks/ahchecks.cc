@@ -0,0 +1,430 @@
+/*
+ * Checks of the parts of ahsimulation that can be exercised without running
+ * a simulation: the columnar nss format, the node statistics it carries, the
+ * statistics kept per node and the bookkeeping of the stations.
+ * Prints every failed check and exits with 1 if there was one:
+ *
+ *   ./waf --run ahchecks
+ */
+
+#include "../ahsimulation/NssColumnar.h"
+#include "../ahsimulation/NssColumnarWriter.h"
+#include "../ahsimulation/DelayStatistics.h"
+#include "../ahsimulation/StationIndex.h"
+#include "../ahsimulation/PhyInFlight.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <unistd.h>
+
+using namespace std;
+
+static int failures = 0;
+
+static void check(bool ok, const char* condition, int line) {
+	if (!ok) {
+		cerr << "ahchecks.cc:" << line << ": check failed: " << condition << endl;
+		failures++;
+	}
+}
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+/*
+ * Columnar nss format
+ */
+
+static void checkVarint() {
+	const uint64_t values[] = { 0, 1, 127, 128, 300, 16383, 16384, 1ull << 32, numeric_limits<uint64_t>::max() };
+	for (uint64_t value : values) {
+		string encoded;
+		nsscolumnar::putVarint(encoded, value);
+		size_t pos = 0;
+		uint64_t decoded = 0;
+		CHECK(nsscolumnar::getVarint(encoded, pos, decoded));
+		CHECK(decoded == value);
+		CHECK(pos == encoded.size());
+
+		// a varint cut short is an error, not a smaller value
+		string truncated = encoded.substr(0, encoded.size() - 1);
+		pos = 0;
+		CHECK(truncated.empty() || !nsscolumnar::getVarint(truncated, pos, decoded));
+	}
+
+	string small;
+	nsscolumnar::putVarint(small, 127);
+	CHECK(small.size() == 1);
+}
+
+static void checkZigzag() {
+	const int64_t values[] = { 0, 1, -1, 2, -2, 63, -64, numeric_limits<int64_t>::max(), numeric_limits<int64_t>::min() };
+	for (int64_t value : values)
+		CHECK(nsscolumnar::unzigzag(nsscolumnar::zigzag(value)) == value);
+
+	// small differences of either sign take a single byte
+	CHECK(nsscolumnar::zigzag(-1) == 1);
+	CHECK(nsscolumnar::zigzag(1) == 2);
+	CHECK(nsscolumnar::zigzag(-64) == 127);
+}
+
+// a table of the shape of the node statistics, with a row per node
+static nsscolumnar::Table makeTable(int64_t time, uint32_t nodes, int64_t offset) {
+	nsscolumnar::Table table;
+	for (uint32_t i = 0; i < nodes; i++) {
+		table.beginRow();
+		table.add((int)i);
+		table.add((long)(1000 - offset * i));
+		table.add(0.1 * (i + offset));
+		table.add((long double)1e18 + offset + 0.25L);
+		table.add(vector<int64_t> { offset, -(int64_t)i, numeric_limits<int64_t>::min() + offset });
+		table.endRow();
+	}
+	const char* names[] = { "NodeId", "Counter", "Ratio", "Total", "DropReasons" };
+	for (size_t c = 0; c < table.columns.size(); c++)
+		table.columns[c].name = names[c];
+	table.time = time;
+	return table;
+}
+
+static string formatTable(const nsscolumnar::Table& table) {
+	string text;
+	for (uint32_t row = 0; row < table.rows; row++) {
+		text += to_string(table.time) + ";";
+		table.formatRow(text, "nodestats", row);
+		text += '\n';
+	}
+	return text;
+}
+
+static void checkBlocks() {
+	nsscolumnar::Table first = makeTable(1000000000, 3, 5);
+	// counters go down as well as up between intervals
+	nsscolumnar::Table second = makeTable(2000000000, 3, -7);
+
+	string schema;
+	nsscolumnar::encodeSchema(schema, first);
+	nsscolumnar::Table decodedFirst;
+	CHECK(nsscolumnar::decodeSchema(schema, decodedFirst));
+	CHECK(decodedFirst.columns.size() == first.columns.size());
+	CHECK(decodedFirst.columns[4].name == "DropReasons" && decodedFirst.columns[4].width == 3);
+	nsscolumnar::Table decodedSecond = decodedFirst;
+
+	string block;
+	nsscolumnar::encodeBlock(block, first, nsscolumnar::Table());
+	CHECK(nsscolumnar::decodeBlock(block, decodedFirst, nsscolumnar::Table()));
+	CHECK(formatTable(decodedFirst) == formatTable(first));
+
+	block.clear();
+	nsscolumnar::encodeBlock(block, second, first);
+	CHECK(nsscolumnar::decodeBlock(block, decodedSecond, decodedFirst));
+	CHECK(formatTable(decodedSecond) == formatTable(second));
+	for (size_t c = 0; c < second.columns.size(); c++)
+		for (uint32_t row = 0; row < second.rows; row++)
+			CHECK(decodedSecond.columns[c].hasSameValue(row, second.columns[c]));
+
+	// a block cut short is rejected
+	CHECK(!nsscolumnar::decodeBlock(block.substr(0, block.size() - 1), decodedSecond, decodedFirst));
+}
+
+static vector<string> split(const string& line) {
+	vector<string> fields;
+	stringstream stream(line);
+	string field;
+	while (getline(stream, field, ';'))
+		fields.push_back(field);
+	return fields;
+}
+
+// what the readers of the nss file do: patch the last nodestats line of the node with a nodestatsdelta line
+static string applyDelta(const string& nodestats, const string& delta) {
+	vector<string> fields = split(nodestats);
+	vector<string> changes = split(delta);
+	fields[0] = changes[0];
+	for (size_t i = 3; i + 1 < changes.size(); i += 2)
+		fields.at(stoi(changes[i])) = changes[i + 1];
+	string line;
+	for (size_t i = 0; i < fields.size(); i++)
+		line += (i == 0 ? "" : ";") + fields[i];
+	return line;
+}
+
+static string formatLine(const nsscolumnar::Table& table, uint32_t row, bool delta, const nsscolumnar::Table& previous) {
+	string line = to_string(table.time) + ";";
+	if (delta)
+		table.formatDeltaRow(line, row, previous);
+	else
+		table.formatRow(line, "nodestats", row);
+	return line;
+}
+
+static void checkDeltaRows() {
+	nsscolumnar::Table previous = makeTable(1000000000, 3, 5);
+	nsscolumnar::Table table = previous;
+	table.time = 2000000000;
+	// node 1 changes a counter and a drop reason, node 2 a double by less than the text shows
+	table.columns[1].ints[1]++;
+	table.columns[4].ints[1 * 3 + 2] = -3;
+	table.columns[2].doubles[2] += 1e-12;
+
+	string line = "unchanged";
+	CHECK(!table.formatDeltaRow(line, 0, previous));
+	CHECK(line == "unchanged");
+
+	string delta = formatLine(table, 1, true, previous);
+	CHECK(split(delta).size() == 3 + 2 * 2);
+	CHECK(split(delta)[1] == "nodestatsdelta" && split(delta)[2] == "1");
+	CHECK(applyDelta(formatLine(previous, 1, false, previous), delta) == formatLine(table, 1, false, previous));
+
+	CHECK(table.formatDeltaRow(line, 2, previous));
+	CHECK(applyDelta(formatLine(previous, 2, false, previous), formatLine(table, 2, true, previous)) == formatLine(table, 2, false, previous));
+}
+
+static void checkColumnarFile() {
+	string filename = "ahchecks-" + to_string(getpid()) + ".nsc";
+	nsscolumnar::Table first = makeTable(1000000000, 2, 1);
+	nsscolumnar::Table second = makeTable(2000000000, 2, 3);
+	string event = "1500000000;nodeassociated;0;1\n";
+	{
+		NssColumnarWriter writer(filename);
+		writer.writeStatistics(first);
+		writer.writeEvent(event);
+		// the file is closed in between, the next records append to it
+		writer.flush();
+		writer.writeStatistics(second);
+		writer.flush();
+	}
+
+	ifstream in(filename, ios::binary);
+	ostringstream text;
+	CHECK(nsscolumnar::convertToText(in, text));
+	CHECK(text.str() == formatTable(first) + event + formatTable(second));
+	in.close();
+	remove(filename.c_str());
+
+	istringstream notColumnar("0;nodestats;1\n");
+	ostringstream ignored;
+	CHECK(!nsscolumnar::convertToText(notColumnar, ignored));
+}
+
+/*
+ * Node statistics
+ */
+
+// the value percentile percent of the values don't exceed
+static uint64_t getExactPercentile(vector<uint64_t> values, double percentile) {
+	sort(values.begin(), values.end());
+	uint64_t rank = max((uint64_t)ceil(percentile / 100 * values.size()), (uint64_t)1);
+	return values[rank - 1];
+}
+
+static void checkHistogram() {
+	LogLinearHistogram empty;
+	CHECK(empty.getCount() == 0 && empty.getPercentile(50) == 0);
+
+	mt19937_64 random(1);
+	lognormal_distribution<double> latency(9, 1.5);
+	for (uint32_t subBucketBits : { 4, 5 }) {
+		LogLinearHistogram histogram(subBucketBits);
+		vector<uint64_t> values;
+		for (int i = 0; i < 20000; i++) {
+			uint64_t value = latency(random);
+			values.push_back(value);
+			histogram.add(value);
+		}
+		// small values have a bucket each
+		for (uint64_t value = 0; value < 40; value++) {
+			values.push_back(value);
+			histogram.add(value);
+		}
+
+		CHECK(histogram.getCount() == values.size());
+		CHECK(histogram.getMax() == *max_element(values.begin(), values.end()));
+		for (double percentile : { 0.0, 0.01, 1.0, 50.0, 95.0, 99.0, 99.9, 100.0 }) {
+			uint64_t exact = getExactPercentile(values, percentile);
+			uint64_t estimate = histogram.getPercentile(percentile);
+			// never below the value and within the width of its bucket above it
+			CHECK(estimate >= exact);
+			CHECK(estimate - exact <= exact >> subBucketBits);
+		}
+		CHECK(histogram.getPercentile(100) == histogram.getMax());
+
+		histogram.clear();
+		CHECK(histogram.getCount() == 0 && histogram.getMax() == 0 && histogram.getPercentile(99) == 0);
+	}
+}
+
+// the latency summary merges the histograms of the stations per RAW slot and for the network
+static void checkHistogramMerge() {
+	mt19937_64 random(3);
+	lognormal_distribution<double> latency(10, 1);
+	LogLinearHistogram pooled(5);
+	LogLinearHistogram merged(5);
+	for (int station = 0; station < 10; station++) {
+		LogLinearHistogram histogram(5);
+		// later stations have higher latencies, every fourth station has none
+		for (int i = 0; i < 100 * (station % 4); i++) {
+			uint64_t value = latency(random) * (station + 1);
+			histogram.add(value);
+			pooled.add(value);
+		}
+		merged.merge(histogram);
+	}
+
+	CHECK(merged.getCount() == pooled.getCount());
+	CHECK(merged.getMax() == pooled.getMax());
+	for (double percentile : { 1.0, 50.0, 95.0, 99.0, 99.9, 100.0 })
+		CHECK(merged.getPercentile(percentile) == pooled.getPercentile(percentile));
+}
+
+static void checkDelayStatistics() {
+	DelayStatistics empty;
+	CHECK(empty.getCount() == 0);
+	CHECK(empty.getAverage() == Time());
+	CHECK(empty.getDeviation() == -1);
+
+	// the same as summing the squared differences with the average in whole microseconds
+	mt19937_64 random(2);
+	uniform_int_distribution<int64_t> delay(0, 5000000);
+	DelayStatistics statistics;
+	vector<int64_t> delays;
+	Time total;
+	for (int i = 0; i < 10000; i++) {
+		delays.push_back(delay(random));
+		total += MicroSeconds(delays.back());
+		statistics.add(MicroSeconds(delays.back()));
+	}
+	CHECK(statistics.getCount() == delays.size());
+	CHECK(statistics.getAverage() == total / delays.size());
+	int64_t mean = statistics.getAverage().GetMicroSeconds();
+	long double squares = 0;
+	for (int64_t d : delays)
+		squares += (long double)(d - mean) * (d - mean);
+	long double deviation = sqrt(squares / delays.size());
+	CHECK(fabsl(statistics.getDeviation() - deviation) <= deviation * 1e-12L);
+
+	vector<uint64_t> values(delays.begin(), delays.end());
+	Time median = statistics.getPercentile(50);
+	CHECK(median >= MicroSeconds(getExactPercentile(values, 50)));
+	CHECK(median <= MicroSeconds(getExactPercentile(values, 50) * 17 / 16));
+
+	// the squares of delays of a few hours overflow 64 bits after a few samples
+	DelayStatistics hours;
+	int64_t hour = 3600LL * 1000000;
+	for (int i = 0; i < 1000; i++) {
+		hours.add(MicroSeconds(5 * hour));
+		hours.add(MicroSeconds(5 * hour + 2));
+	}
+	CHECK(hours.getAverage() == MicroSeconds(5 * hour + 1));
+	CHECK(hours.getDeviation() == 1);
+}
+
+/*
+ * Stations
+ */
+
+static void checkStationIndex() {
+	uint32_t nrOfStations = 3000;
+	Mac48Address ap = Mac48Address::Allocate();
+	vector<Mac48Address> macs;
+	StationIndex index(nrOfStations);
+	for (uint32_t i = 0; i < nrOfStations; i++) {
+		macs.push_back(Mac48Address::Allocate());
+		index.add(i, macs[i]);
+		index.add(i, Ipv4Address(0x0a000002 + i));
+		index.add(i, Ipv6Address::MakeAutoconfiguredAddress(macs[i], Ipv6Address("2001:db8::")));
+	}
+
+	uint32_t found = 0;
+	for (uint32_t i = 0; i < nrOfStations; i++) {
+		found += index.find(macs[i]) == (int)i
+				&& index.find(Ipv4Address(0x0a000002 + i)) == (int)i
+				&& index.find(Ipv6Address::MakeAutoconfiguredAddress(macs[i], Ipv6Address("2001:db8::"))) == (int)i;
+	}
+	CHECK(found == nrOfStations);
+
+	// the addresses of the AP and beyond the last station aren't stations
+	CHECK(index.find(ap) == -1);
+	CHECK(index.find(Mac48Address::GetBroadcast()) == -1);
+	CHECK(index.find(Ipv4Address(0x0a000001)) == -1);
+	CHECK(index.find(Ipv4Address(0x0a000002 + nrOfStations)) == -1);
+	CHECK(index.find(Ipv6Address::MakeAutoconfiguredAddress(ap, Ipv6Address("2001:db8::"))) == -1);
+
+	CHECK(index.getNumberOfAssociated() == 0 && !index.isEveryStationAssociated());
+	for (uint32_t i = 0; i < nrOfStations; i++) {
+		index.setAssociated(i);
+		// a station that is already associated isn't counted twice
+		index.setAssociated(i);
+	}
+	CHECK(index.getNumberOfAssociated() == nrOfStations && index.isEveryStationAssociated());
+	index.setDeassociated(7);
+	index.setDeassociated(7);
+	CHECK(index.getNumberOfAssociated() == nrOfStations - 1 && !index.isEveryStationAssociated());
+	index.setAssociated(7);
+	CHECK(index.isEveryStationAssociated());
+}
+
+static void checkPhyInFlight() {
+	PhyInFlight inFlight(3);
+	Time duration;
+
+	// one transmission per node, a new one takes the place of one that never ended
+	CHECK(inFlight.beginTransmit(0, 100, MicroSeconds(10)) == 1);
+	CHECK(inFlight.beginTransmit(0, 100, MicroSeconds(20)) == 1);
+	CHECK(inFlight.beginTransmit(0, 101, MicroSeconds(30)) == 1);
+	CHECK(!inFlight.endTransmit(0, 100, MicroSeconds(40), duration));
+	CHECK(inFlight.endTransmit(0, 101, MicroSeconds(40), duration) && duration == MicroSeconds(10));
+	CHECK(!inFlight.endTransmit(0, 101, MicroSeconds(50), duration));
+
+	// overlapping receptions end in any order, a frame already in flight keeps its begin
+	for (uint64_t uid = 1; uid <= PhyInFlight::RECEIVE_SLOTS; uid++)
+		CHECK(inFlight.beginReceive(1, uid, MicroSeconds(uid)) == (int)uid);
+	CHECK(inFlight.beginReceive(1, 2, MicroSeconds(100)) == PhyInFlight::RECEIVE_SLOTS);
+	CHECK(inFlight.endReceive(1, 2, MicroSeconds(102), duration) && duration == MicroSeconds(100));
+	CHECK(inFlight.endReceive(1, 4, MicroSeconds(104), duration) && duration == MicroSeconds(100));
+	CHECK(inFlight.endReceive(1, 1, MicroSeconds(101), duration) && duration == MicroSeconds(100));
+
+	// with every slot taken the oldest reception is given up, the count stays at the slots in use
+	for (uint64_t uid = 10; uid < 10 + PhyInFlight::RECEIVE_SLOTS; uid++)
+		inFlight.beginReceive(2, uid, MicroSeconds(uid));
+	CHECK(inFlight.beginReceive(2, 98, MicroSeconds(98)) == PhyInFlight::RECEIVE_SLOTS);
+	CHECK(inFlight.beginReceive(2, 99, MicroSeconds(99)) == PhyInFlight::RECEIVE_SLOTS);
+	CHECK(!inFlight.endReceive(2, 10, MicroSeconds(200), duration));
+	CHECK(!inFlight.endReceive(2, 11, MicroSeconds(200), duration));
+	CHECK(inFlight.endReceive(2, 12, MicroSeconds(200), duration) && duration == MicroSeconds(188));
+	CHECK(inFlight.endReceive(2, 99, MicroSeconds(200), duration) && duration == MicroSeconds(101));
+	// the two receptions left and a new one
+	CHECK(inFlight.beginReceive(2, 100, MicroSeconds(200)) == 3);
+	CHECK(inFlight.endReceive(2, 13, MicroSeconds(200), duration) && duration == MicroSeconds(187));
+	CHECK(inFlight.endReceive(2, 98, MicroSeconds(200), duration) && duration == MicroSeconds(102));
+	CHECK(inFlight.endReceive(2, 100, MicroSeconds(210), duration) && duration == MicroSeconds(10));
+	CHECK(inFlight.beginReceive(2, 101, MicroSeconds(210)) == 1);
+
+	// the nodes don't share slots
+	CHECK(inFlight.endReceive(1, 3, MicroSeconds(103), duration) && duration == MicroSeconds(100));
+	CHECK(!inFlight.endReceive(0, 3, MicroSeconds(103), duration));
+}
+
+int main(int argc, char** argv) {
+	checkVarint();
+	checkZigzag();
+	checkBlocks();
+	checkDeltaRows();
+	checkColumnarFile();
+	checkHistogram();
+	checkHistogramMerge();
+	checkDelayStatistics();
+	checkStationIndex();
+	checkPhyInFlight();
+
+	if (failures > 0) {
+		cerr << failures << " checks failed" << endl;
+		return 1;
+	}
+	cout << "All checks passed" << endl;
+	return 0;
+}
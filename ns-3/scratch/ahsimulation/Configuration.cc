@@ -1,4 +1,5 @@
 #include "Configuration.h"
+#include <sstream>
 
 Configuration::Configuration() {
     
@@ -6,6 +7,28 @@ Configuration::Configuration() {
 
 Configuration::Configuration(int argc, char** argv) {
     CommandLine cmd;
+    AddCommandLineValues(cmd);
+    cmd.Parse(argc, argv);
+}
+
+void Configuration::Apply(string settings) {
+    vector<string> args = {"fork"};
+    std::stringstream stream(settings);
+    string setting;
+    while (std::getline(stream, setting, ',')) {
+        if (setting != "")
+            args.push_back("--" + setting);
+    }
+    vector<char*> argv;
+    for (auto& arg : args)
+        argv.push_back(&arg[0]);
+
+    CommandLine cmd;
+    AddCommandLineValues(cmd);
+    cmd.Parse(argv.size(), argv.data());
+}
+
+void Configuration::AddCommandLineValues(CommandLine& cmd) {
     cmd.AddValue("useIpv6", "Use Ipv6 (true/false)", useV6);
     cmd.AddValue("nControlLoops", "Number of control loops. If -1 all the stations will be in the loops if NSta is even", nControlLoops);
     cmd.AddValue("CoapPayloadSize", "Size of CoAP payload",coapPayloadSize);
@@ -28,6 +51,22 @@ Configuration::Configuration(int argc, char** argv) {
     cmd.AddValue("BeaconInterval", "Beacon interval time in us", BeaconInterval);
     cmd.AddValue("APAlwaysSchedulesForNextSlot", "AP Always schedules for next slot (true/false)", APAlwaysSchedulesForNextSlot);
     cmd.AddValue("APScheduleTransmissionForNextSlotIfLessThan", "AP schedules transmission for next slot if slot time is less than (microseconds)", APScheduleTransmissionForNextSlotIfLessThan);
+    cmd.AddValue("PsPoll", "Announce buffered downlink data per station in the TIM and let the stations poll for it with a PS-Poll in their slot, instead of the AP transmitting in the slot it expects the station to listen in (true/false)", PsPoll);
+
+    cmd.AddValue("DistributedAuthentication", "Let the stations back off in random authentication slots instead of admitting them with the centralized threshold of the AP (true/false)", DistributedAuthentication);
+    cmd.AddValue("EnergyModel", "Attach a Li-ion battery and a radio energy model to every station and report the energy consumed (true/false)", EnergyModel);
+    cmd.AddValue("EnergyIdleCurrentA", "Current drawn by the radio of a station in idle state in A", EnergyIdleCurrentA);
+    cmd.AddValue("EnergyRxCurrentA", "Current drawn by the radio of a station while receiving or sensing a busy channel in A", EnergyRxCurrentA);
+    cmd.AddValue("EnergyTxEfficiency", "Power amplifier efficiency used to derive the transmit current from the transmit power [0-1]", EnergyTxEfficiency);
+    cmd.AddValue("EnergySleepCurrentA", "Current drawn by the radio of a station while dozing in A", EnergySleepCurrentA);
+    cmd.AddValue("RadioWakeUpTime", "Time the radio of a station needs to go from sleep to receiving, it wakes up at least this long before a beacon or RAW slot, in us", RadioWakeUpTime);
+    cmd.AddValue("ClockDrift", "Worst-case clock drift between a station and the AP in ppm, a station wakes up earlier by this fraction of the time since it last received a beacon", ClockDrift);
+    cmd.AddValue("SlotEndGuardTime", "Time a station keeps listening after its RAW slot has ended to catch a late ACK, in us", SlotEndGuardTime);
+    cmd.AddValue("LifetimeProjection", "Project the battery lifetime of every station from its average power once every station is associated, and stop the simulation as soon as the projection of every station has converged (true/false)", LifetimeProjection);
+    cmd.AddValue("LifetimeProjectionPrecision", "Relative half width of the 95% confidence interval of the average power of a station before its lifetime projection has converged", LifetimeProjectionPrecision);
+    cmd.AddValue("LifetimeProjectionMinSamples", "Minimum number of sampling windows (whole DTIM cycles spanning at least one traffic interval) per station before its lifetime projection has converged", LifetimeProjectionMinSamples);
+    cmd.AddValue("SlimStaMac", "Only create the best effort EDCA queue in the MAC of the stations instead of one queue per access category, this saves memory and setup time with many stations (true/false)", SlimStaMac);
+    cmd.AddValue("WarmStart", "Start with every station associated instead of letting them associate over the air, traffic starts at t=0 (true/false)", warmStart);
 
     cmd.AddValue("TrafficInterval", "Traffic interval time in ms", trafficInterval);
     cmd.AddValue("TrafficIntervalDeviation", "Traffic interval deviation time in ms, each interval will have a random deviation between - dev/2 and + dev/2", trafficIntervalDeviation);
@@ -67,15 +106,17 @@ Configuration::Configuration(int argc, char** argv) {
     cmd.AddValue("VisualizerIP", "IP or hostname for the visualizer server, leave empty to not send data", visualizerIP);
     cmd.AddValue("VisualizerPort", "Port for the visualizer server", visualizerPort);
     cmd.AddValue("VisualizerSamplingInterval", "Sampling interval of statistics in seconds", visualizerSamplingInterval);
+    cmd.AddValue("NodeStatsKeyframeInterval", "Number of sampling intervals between full nodestats records, in between only the changed statistics are written as nodestatsdelta. 1 always writes the full records", nodeStatsKeyframeInterval);
 
 
     cmd.AddValue("APPcapFile", "Name of the pcap file to generate at the AP, leave empty to omit generation", APPcapFile);
 
     cmd.AddValue("NSSFile", "Path of the nss file to write. Note: if a visualizer is active it will also save the nss file", NSSFile);
+    cmd.AddValue("NSSColumnarFile", "Path of the compact binary columnar nss file (.nsc) to write, leave empty to omit. Set NSSFile to none to only write this one, the nssconvert program converts it to the text nss format", NSSColumnarFile);
     cmd.AddValue("Name", "Name of the simulation", name);
 
     cmd.AddValue("CoolDownPeriod", "Period of no more traffic generation after simulation time (to allow queues to be processed) in seconds", CoolDownPeriod);
 
-
-    cmd.Parse(argc, argv);
+    cmd.AddValue("ForkVariants", "Fork a run per variant once every station is associated, variants are separated by ';' and contain comma separated Name=Value options (e.g. TrafficInterval=500,CoapPayloadSize=32;TrafficInterval=1000). Each run writes its own nss file, the visualizer is not used by the forked runs", forkVariants);
+    cmd.AddValue("ForkMaxParallel", "Maximum number of forked runs at the same time", forkMaxParallel);
 }
@@ -56,12 +56,15 @@ struct Configuration {
 
 	bool APAlwaysSchedulesForNextSlot = false;
 	uint32_t APScheduleTransmissionForNextSlotIfLessThan = 5000;
+	bool PsPoll = false; // stations poll for the data the TIM announces
 
 	string DataMode = "MCS2_0"; //MCS2_8--------------------------------
 
 	string visualizerIP = "10.0.2.15"; /// prayan string ""
 	int visualizerPort = 7707;
 	double visualizerSamplingInterval = 1;
+	// every how many sampling intervals all node statistics are sent, in between only the changes
+	int nodeStatsKeyframeInterval = 1;
 
 	string rho = "500.0"; //100
 
@@ -69,6 +72,7 @@ struct Configuration {
 
 	string APPcapFile = "appcap"; //prayan string
 	string NSSFile = "test.nss";
+	string NSSColumnarFile = ""; // binary columnar nss file, converted to text by nssconvert
 
 	int trafficPacketSize = 4096; //-1
 	string trafficType = "coap"; //tcpfirmware
@@ -89,7 +93,35 @@ struct Configuration {
 
 	uint16_t CoolDownPeriod = 0; //60
 
+	bool warmStart = false; // start with every station associated
+	bool SlimStaMac = false; // only create the best effort queue in the MAC of the stations
+	bool DistributedAuthentication = false;
+
+	bool EnergyModel = false; // attach a Li-ion battery and a radio energy model to every station
+	double EnergyIdleCurrentA = 0.010;
+	double EnergyRxCurrentA = 0.012; // also used while the channel is busy
+	double EnergyTxEfficiency = 0.03; // power amplifier efficiency of the linear tx current model
+	double EnergySleepCurrentA = 0.000005;
+
+	uint32_t RadioWakeUpTime = 4000; // us
+	double ClockDrift = 20; // ppm between the clocks of a station and the AP
+	uint32_t SlotEndGuardTime = 0; // us
+
+	bool LifetimeProjection = false; // stop once the battery lifetime of every station can be projected
+	double LifetimeProjectionPrecision = 0.02; // relative half width of the 95% confidence interval of the average power
+	uint32_t LifetimeProjectionMinSamples = 10;
+
+	string forkVariants = ""; // traffic settings of the runs forked once every station is associated
+	uint32_t forkMaxParallel = 4;
+
 	Configuration();
 	Configuration(int argc, char** argv);
 
+	void AddCommandLineValues(CommandLine& cmd);
+	/*
+	 * Override the configuration with comma separated Name=Value pairs,
+	 * using the names of the command line options
+	 */
+	void Apply(string settings);
+
 };
@@ -0,0 +1,36 @@
+#include "DelayStatistics.h"
+#include <cmath>
+
+void DelayStatistics::add(Time delay) {
+	int64_t us = delay.GetMicroSeconds();
+	count++;
+	total += delay;
+	totalMicroSeconds += us;
+	totalSquaredMicroSeconds += (__int128)us * us;
+	histogram.add(us < 0 ? 0 : us);
+}
+
+uint64_t DelayStatistics::getCount() const {
+	return count;
+}
+
+Time DelayStatistics::getAverage() const {
+	if (count != 0)
+		return total / count;
+	else
+		return Time();
+}
+
+long double DelayStatistics::getDeviation() const {
+	if (count == 0)
+		return -1;
+
+	// sum of (delay - mean)^2 = sum of delay^2 - 2 * mean * sum of delay + count * mean^2
+	__int128 mean = getAverage().GetMicroSeconds();
+	__int128 dev = totalSquaredMicroSeconds - 2 * mean * totalMicroSeconds + count * mean * mean;
+	return sqrt((long double)dev / count);
+}
+
+Time DelayStatistics::getPercentile(double percentile) const {
+	return MicroSeconds(histogram.getPercentile(percentile));
+}
@@ -0,0 +1,38 @@
+#ifndef DELAYSTATISTICS_H
+#define DELAYSTATISTICS_H
+
+#include "LogLinearHistogram.h"
+#include "ns3/core-module.h"
+
+using namespace std;
+using namespace ns3;
+
+/*
+ * Average, standard deviation and percentiles of a stream of delays in
+ * constant memory. The sums of the delays in microseconds and of their
+ * squares are kept as integers, so the deviation is exactly the one of
+ * summing the squared differences with the average over all delays.
+ */
+class DelayStatistics {
+
+private:
+	uint64_t count = 0;
+	Time total = Time();
+	int64_t totalMicroSeconds = 0;
+	__int128 totalSquaredMicroSeconds = 0;
+	// delays in microseconds
+	LogLinearHistogram histogram;
+
+public:
+	void add(Time delay);
+
+	uint64_t getCount() const;
+	// Time() if there are no delays
+	Time getAverage() const;
+	// standard deviation in microseconds around the average in whole microseconds, -1 if there are no delays
+	long double getDeviation() const;
+	// within the relative error of the histogram
+	Time getPercentile(double percentile) const;
+};
+
+#endif /* DELAYSTATISTICS_H */
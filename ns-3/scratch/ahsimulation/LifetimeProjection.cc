@@ -0,0 +1,71 @@
+#include "LifetimeProjection.h"
+#include <cmath>
+#include <limits>
+
+LifetimeProjection::LifetimeProjection() {
+}
+
+LifetimeProjection::LifetimeProjection(int nrOfNodes, double precision, long minSamples)
+	: samples(nrOfNodes), precision(precision), minSamples(max(minSamples, 2L)) {
+}
+
+void LifetimeProjection::addSample(int index, double energy, Time window) {
+	// Welford's online mean and variance of the power per window
+	Accumulator& acc = samples.at(index);
+	double power = energy / window.GetSeconds();
+	acc.n++;
+	double delta = power - acc.mean;
+	acc.mean += delta / acc.n;
+	acc.m2 += delta * (power - acc.mean);
+}
+
+long LifetimeProjection::getNumberOfSamples(int index) const {
+	return samples.at(index).n;
+}
+
+double LifetimeProjection::getAveragePower(int index) const {
+	return samples.at(index).mean;
+}
+
+double LifetimeProjection::getAveragePowerHalfWidth(int index) const {
+	const Accumulator& acc = samples.at(index);
+	if (acc.n < 2)
+		return std::numeric_limits<double>::infinity();
+
+	// Student t quantile for 97.5%, first order Cornish-Fisher expansion around the normal quantile
+	double z = 1.959964;
+	double t = z + (z * z * z + z) / (4 * (acc.n - 1));
+	return t * sqrt(acc.m2 / (acc.n - 1) / acc.n);
+}
+
+bool LifetimeProjection::hasConverged(int index) const {
+	if (getNumberOfSamples(index) < minSamples)
+		return false;
+	return getAveragePowerHalfWidth(index) <= precision * getAveragePower(index);
+}
+
+bool LifetimeProjection::hasConverged() const {
+	for (uint32_t i = 0; i < samples.size(); i++) {
+		if (!hasConverged(i))
+			return false;
+	}
+	return samples.size() > 0;
+}
+
+static Time timeToDeplete(double remainingEnergy, double power) {
+	if (power <= 0 || remainingEnergy / power >= Time::Max().GetSeconds())
+		return Time::Max();
+	return Seconds(remainingEnergy / power);
+}
+
+Time LifetimeProjection::getLifetime(int index, double remainingEnergy) const {
+	return timeToDeplete(remainingEnergy, getAveragePower(index));
+}
+
+Time LifetimeProjection::getLifetimeLowerBound(int index, double remainingEnergy) const {
+	return timeToDeplete(remainingEnergy, getAveragePower(index) + getAveragePowerHalfWidth(index));
+}
+
+Time LifetimeProjection::getLifetimeUpperBound(int index, double remainingEnergy) const {
+	return timeToDeplete(remainingEnergy, getAveragePower(index) - getAveragePowerHalfWidth(index));
+}
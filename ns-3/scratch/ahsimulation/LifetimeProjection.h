@@ -0,0 +1,60 @@
+#ifndef LIFETIMEPROJECTION_H
+#define LIFETIMEPROJECTION_H
+
+#include "ns3/core-module.h"
+#include <vector>
+
+using namespace std;
+using namespace ns3;
+
+/*
+ * Estimates the average power of every station from the energy it consumes in
+ * consecutive sampling windows (batch means). A window spans whole DTIM cycles
+ * and at least one traffic interval, so the windows of a station in steady state
+ * are close to independent and identically distributed. The battery lifetime is
+ * then projected from the remaining energy instead of simulating until the
+ * battery runs out.
+ */
+class LifetimeProjection {
+
+private:
+	struct Accumulator {
+		long n = 0;
+		double mean = 0;
+		double m2 = 0;
+	};
+
+	vector<Accumulator> samples;
+	double precision = 0;
+	long minSamples = 0;
+
+public:
+	LifetimeProjection();
+	/*
+	 * precision is the relative half width of the 95% confidence interval of
+	 * the average power a station needs before it has converged
+	 */
+	LifetimeProjection(int nrOfNodes, double precision, long minSamples);
+
+	// energy in Joule consumed by the station during a window of the given length
+	void addSample(int index, double energy, Time window);
+
+	long getNumberOfSamples(int index) const;
+	double getAveragePower(int index) const;
+	// half width of the 95% confidence interval of the average power
+	double getAveragePowerHalfWidth(int index) const;
+
+	bool hasConverged(int index) const;
+	bool hasConverged() const;
+
+	/*
+	 * Time until the remaining energy is used up at the average power and at the
+	 * upper and lower bound of its confidence interval. A bound that does not
+	 * deplete the battery is returned as Time::Max().
+	 */
+	Time getLifetime(int index, double remainingEnergy) const;
+	Time getLifetimeLowerBound(int index, double remainingEnergy) const;
+	Time getLifetimeUpperBound(int index, double remainingEnergy) const;
+};
+
+#endif /* LIFETIMEPROJECTION_H */
@@ -0,0 +1,77 @@
+#include "LogLinearHistogram.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+LogLinearHistogram::LogLinearHistogram(uint32_t subBucketBits)
+	: subBucketBits(subBucketBits) {
+}
+
+uint32_t LogLinearHistogram::getBucket(uint64_t value) const {
+	uint64_t subBuckets = (uint64_t)1 << subBucketBits;
+	if (value < subBuckets)
+		return value;
+
+	// the power of two of the value selects the group, the bits below its top bit the linear bucket in it
+	uint32_t magnitude = 63 - __builtin_clzll(value);
+	uint32_t shift = magnitude - subBucketBits;
+	uint64_t subBucket = (value >> shift) - subBuckets;
+	return (shift + 1) * subBuckets + subBucket;
+}
+
+uint64_t LogLinearHistogram::getBucketUpperBound(uint32_t bucket) const {
+	uint64_t subBuckets = (uint64_t)1 << subBucketBits;
+	if (bucket < subBuckets)
+		return bucket;
+
+	uint32_t shift = bucket / subBuckets - 1;
+	uint64_t subBucket = bucket % subBuckets;
+	return (((subBuckets + subBucket + 1) << shift) - 1);
+}
+
+void LogLinearHistogram::add(uint64_t value) {
+	uint32_t bucket = getBucket(value);
+	if (bucket >= counts.size())
+		counts.resize(bucket + 1);
+	counts[bucket]++;
+	count++;
+	max = std::max(max, value);
+}
+
+void LogLinearHistogram::merge(const LogLinearHistogram& other) {
+	assert(other.subBucketBits == subBucketBits);
+	if (other.counts.size() > counts.size())
+		counts.resize(other.counts.size());
+	for (uint32_t bucket = 0; bucket < other.counts.size(); bucket++)
+		counts[bucket] += other.counts[bucket];
+	count += other.count;
+	max = std::max(max, other.max);
+}
+
+uint64_t LogLinearHistogram::getCount() const {
+	return count;
+}
+
+uint64_t LogLinearHistogram::getMax() const {
+	return max;
+}
+
+uint64_t LogLinearHistogram::getPercentile(double percentile) const {
+	if (count == 0)
+		return 0;
+
+	uint64_t rank = std::max((uint64_t)ceil(percentile / 100 * count), (uint64_t)1);
+	uint64_t seen = 0;
+	for (uint32_t bucket = 0; bucket < counts.size(); bucket++) {
+		seen += counts[bucket];
+		if (seen >= rank)
+			return std::min(getBucketUpperBound(bucket), max);
+	}
+	return max;
+}
+
+void LogLinearHistogram::clear() {
+	counts.clear();
+	count = 0;
+	max = 0;
+}
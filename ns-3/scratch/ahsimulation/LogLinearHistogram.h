@@ -0,0 +1,46 @@
+#ifndef LOGLINEARHISTOGRAM_H
+#define LOGLINEARHISTOGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/*
+ * Counts non-negative integer values in a bounded number of buckets. Values
+ * below 2^subBucketBits have a bucket each, every higher power of two is
+ * split into 2^subBucketBits linear buckets, so a value is known within a
+ * relative error of 2^-subBucketBits whatever its magnitude. The buckets are
+ * only allocated up to the highest value seen.
+ */
+class LogLinearHistogram {
+
+private:
+	uint32_t subBucketBits;
+	vector<uint32_t> counts;
+	uint64_t count = 0;
+	uint64_t max = 0;
+
+	uint32_t getBucket(uint64_t value) const;
+	// highest value that falls in the bucket
+	uint64_t getBucketUpperBound(uint32_t bucket) const;
+
+public:
+	LogLinearHistogram(uint32_t subBucketBits = 4);
+
+	void add(uint64_t value);
+	// adds the counts of a histogram with the same number of sub buckets
+	void merge(const LogLinearHistogram& other);
+
+	uint64_t getCount() const;
+	uint64_t getMax() const;
+	/*
+	 * The value that percentile percent of the values don't exceed, rounded up
+	 * to the end of its bucket but never above the largest value. 0 if empty.
+	 */
+	uint64_t getPercentile(double percentile) const;
+
+	void clear();
+};
+
+#endif /* LOGLINEARHISTOGRAM_H */
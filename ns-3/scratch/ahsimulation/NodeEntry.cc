@@ -23,10 +23,7 @@ void NodeEntry::SetAssociation(std::string context, Mac48Address address) {
 	this->isAssociated = true;
 
 	// determine AID
-	auto matches = Config::LookupMatches(
-			"/NodeList/" + std::to_string(this->id)
-					+ "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::StaWifiMac/");
-	auto obj = matches.Get(0)->GetObject<StaWifiMac>();
+	auto obj = DynamicCast<WifiNetDevice>(this->device)->GetMac()->GetObject<StaWifiMac>();
 	this->aId = obj->GetAID();
 
 	//cout << "Associated with aId " << this->aId;
@@ -58,14 +55,20 @@ void NodeEntry::OnS1gBeaconMissed(std::string context, bool nextBeaconIsDTIM) {
 	stats->get(this->id).NumberOfBeaconsMissed++;
 }
 
-void NodeEntry::OnPhyTxBegin(std::string context, Ptr<const Packet> packet) {
+void NodeEntry::OnWakeUpGuard(std::string context, Time guard, Time sinceSync) {
 	unused(context);
+	unused(sinceSync);
+	stats->get(this->id).TotalEarlyWakeTime += guard;
+	stats->get(this->id).MaxEarlyWakeTime = std::max(stats->get(this->id).MaxEarlyWakeTime, guard);
+}
+
+void NodeEntry::OnPhyTxBegin(Ptr<const Packet> packet) {
 	if(showLog) cout << Simulator::Now().GetMicroSeconds() << " [" << this->aId << "] "
 			<< "Begin Tx " << packet->GetUid() << endl;
-	txMap.emplace(packet->GetUid(), Simulator::Now());
+	int nrOfTransmissions = stats->getPhyInFlight().beginTransmit(this->id, packet->GetUid(), Simulator::Now());
 
-	if (txMap.size() > 1)
-		cout << "warning: more than 1 transmission active: " << txMap.size()
+	if (nrOfTransmissions > 1)
+		cout << "warning: more than 1 transmission active: " << nrOfTransmissions
 				<< " transmissions" << endl;
 
 	/*if (aId >= lastBeaconAIDStart && aId <= lastBeaconAIDEnd) {
@@ -76,31 +79,28 @@ void NodeEntry::OnPhyTxBegin(std::string context, Ptr<const Packet> packet) {
 	stats->get(this->id).NumberOfTransmissions++;
 }
 
-void NodeEntry::OnPhyTxEnd(std::string context, Ptr<const Packet> packet) {
-	unused(context);
+void NodeEntry::OnPhyTxEnd(Ptr<const Packet> packet) {
 	if(showLog) cout << Simulator::Now().GetMicroSeconds() << " [" << this->aId << "] "
 			<< "End Tx " << packet->GetUid() << endl;
 
-	if (txMap.find(packet->GetUid()) != txMap.end()) {
-		Time oldTime = txMap[packet->GetUid()];
-		txMap.erase(packet->GetUid());
-		stats->get(this->id).TotalTransmitTime += (Simulator::Now() - oldTime);
-	} else
+	Time duration;
+	if (stats->getPhyInFlight().endTransmit(this->id, packet->GetUid(), Simulator::Now(), duration))
+		stats->get(this->id).TotalTransmitTime += duration;
+	else
 		if(showLog) cout << "[" << this->id << "] " << Simulator::Now().GetMicroSeconds()
 				<< " End tx for packet " << packet->GetUid()
 				<< " without a begin tx" << endl;
 }
 
-void NodeEntry::OnPhyTxDrop(std::string context, Ptr<const Packet> packet, DropReason reason) {
-	unused(context);
+void NodeEntry::OnPhyTxDrop(Ptr<const Packet> packet, DropReason reason, const WifiMacHeader& hdr) {
+	unused(hdr);
 	if(showLog) cout << "[" << this->aId << "] " << "Tx Dropped " << packet->GetUid()
 			<< endl;
 
-	if (txMap.find(packet->GetUid()) != txMap.end()) {
-		Time oldTime = txMap[packet->GetUid()];
-		txMap.erase(packet->GetUid());
-		stats->get(this->id).TotalTransmitTime += (Simulator::Now() - oldTime);
-	} else
+	Time duration;
+	if (stats->getPhyInFlight().endTransmit(this->id, packet->GetUid(), Simulator::Now(), duration))
+		stats->get(this->id).TotalTransmitTime += duration;
+	else
 		if(showLog) cout << "[" << this->id << "] " << Simulator::Now().GetMicroSeconds()
 				<< " End tx for packet " << packet->GetUid()
 				<< " without a begin tx" << endl;
@@ -111,21 +111,19 @@ void NodeEntry::OnPhyTxDrop(std::string context, Ptr<const Packet> packet, DropR
 
 }
 
-void NodeEntry::OnPhyRxBegin(std::string context, Ptr<const Packet> packet) {
+void NodeEntry::OnPhyRxBegin(Ptr<const Packet> packet) {
 	//cout << "[" << this->aId << "] " << Simulator::Now().GetMicroSeconds()
 	//<< " Begin Rx " << packet->GetUid() << endl;
-	unused(context);
-	rxMap.emplace(packet->GetUid(), Simulator::Now());
+	int nrOfReceives = stats->getPhyInFlight().beginReceive(this->id, packet->GetUid(), Simulator::Now());
 
-	if (rxMap.size() > 1)
-		if(showLog) cout << "warning: more than 1 receive active: " << rxMap.size()
+	if (nrOfReceives > 1)
+		if(showLog) cout << "warning: more than 1 receive active: " << nrOfReceives
 				<< " receives" << endl;
 }
 
-void NodeEntry::OnPhyRxEnd(std::string context, Ptr<const Packet> packet) {
+void NodeEntry::OnPhyRxEnd(Ptr<const Packet> packet) {
 	//cout  << Simulator::Now().GetMicroSeconds() << "[" << this->aId << "] "
 	//<< " End Rx " << packet->GetUid() << endl;
-	unused(context);
 	this->OnEndOfReceive(packet);
 }
 
@@ -134,29 +132,33 @@ void NodeEntry::OnEndOfReceive(Ptr<const Packet> packet) {
 	packet->PeekHeader(hdr);
 
 	stats->get(this->id).NumberOfReceives++;
-	if (rxMap.find(packet->GetUid()) != rxMap.end()) {
-		Time oldTime = rxMap[packet->GetUid()];
-		rxMap.erase(packet->GetUid());
-
-		stats->get(this->id).TotalReceiveTime += (Simulator::Now() - oldTime);
+	Time duration;
+	if (stats->getPhyInFlight().endReceive(this->id, packet->GetUid(), Simulator::Now(), duration)) {
+		stats->get(this->id).TotalReceiveTime += duration;
 
 		if (hdr.IsS1gBeacon()) {
 			lastBeaconReceivedOn = Simulator::Now();
 
-			auto pCopy = packet->Copy();
-			S1gBeaconHeader s1gBeaconHeader;
-			pCopy->RemoveHeader(hdr);
-			pCopy->RemoveHeader(s1gBeaconHeader);
+			// the AP attaches the parsed beacon, only deserialize when it's not available
+			Ptr<const S1gBeaconView> s1gBeacon = S1gBeaconView::PeekView(packet);
+			if (s1gBeacon == 0) {
+				auto pCopy = packet->Copy();
+				pCopy->RemoveHeader(hdr);
+				s1gBeacon = S1gBeaconView::FromPacket(pCopy);
+			}
 
 			//       cout << "[" << this->id << "] " <<  "Received S1g beacon " << endl;
-			auto raw = s1gBeaconHeader.GetRPS().GetRawAssigmentObj();
+			const RPS::RawAssignment& raw = s1gBeacon->GetRawAssignment();
 
 			this->lastBeaconAIDStart = raw.GetRawGroupAIDStart();
 			this->lastBeaconAIDEnd = raw.GetRawGroupAIDEnd();
 
-			if (s1gBeaconHeader.GetTIM().GetTIMCount() == 0) {
-				// DTIM data
-				uint32_t vmap = s1gBeaconHeader.GetTIM().GetPartialVBitmap();
+			const TIM& tim = s1gBeacon->GetTIM();
+			uint8_t pageSlice = this->rawGroupNumber / TIM::GROUPS_PER_PAGE_SLICE;
+			if (tim.CarriesPageSlice() && tim.GetPageSliceNumber() == pageSlice) {
+				// DTIM data, or the data of a later page slice
+				uint32_t vmap = tim.GetPartialVBitmap();
+				uint8_t bit = this->rawGroupNumber % TIM::GROUPS_PER_PAGE_SLICE;
 
 				/*if(vmap != 0x0) {
 				 std::cout << Simulator::Now().GetMicroSeconds() << "[" << this->id << "]" << " DTIM beacon received, VMAP: ";
@@ -171,7 +173,7 @@ void NodeEntry::OnEndOfReceive(Ptr<const Packet> packet) {
 				 cout << endl;
 				 */
 
-				if (((vmap >> this->rawGroupNumber) & 0x01) == 0x01) {
+				if (((vmap >> bit) & 0x01) == 0x01) {
 					// there is pending data at the AP
 					rawTIMGroupFlaggedAsDataAvailableInDTIM = true;
 				} else {
@@ -195,52 +197,28 @@ void NodeEntry::OnEndOfReceive(Ptr<const Packet> packet) {
 	}
 }
 
-void NodeEntry::OnPhyRxDrop(std::string context, Ptr<const Packet> packet,
-		DropReason reason) {
-	unused(context);
+void NodeEntry::OnPhyRxDrop(Ptr<const Packet> packet, DropReason reason, const WifiMacHeader& hdr) {
 	this->OnEndOfReceive(packet);
 
-	// THIS REQUIRES PACKET METADATA ENABLE!
-	auto pCopy = packet->Copy();
-	auto it = pCopy->BeginItem();
-	while (it.HasNext()) {
-
-		auto item = it.Next();
-		Callback<ObjectBase *> constructor = item.tid.GetConstructor();
-
-		ObjectBase *instance = constructor();
-		Chunk *chunk = dynamic_cast<Chunk *>(instance);
-		chunk->Deserialize(item.current);
-
-		if (dynamic_cast<WifiMacHeader*>(chunk)) {
-			WifiMacHeader* hdr = (WifiMacHeader*) chunk;
+	if (hdr.GetAddr1() == node->GetDevice(0)->GetAddress()) {
+		stats->get(this->id).NumberOfReceiveDroppedByDestination++;
+		stats->get(this->id).NumberOfDropsByReason[reason]++;
 
-			if (hdr->GetAddr1() == node->GetDevice(0)->GetAddress()) {
-
-				stats->get(this->id).NumberOfReceiveDroppedByDestination++;
-				stats->get(this->id).NumberOfDropsByReason[reason]++;
-
-				//packet->Copy()->Print(cout);
-				//	cout  << Simulator::Now().GetMicroSeconds() << "[" << this->aId << "] "
-				//		<< " Drop Rx for STA " << packet->GetUid() << endl;
-			}
-			//hdr->Print(cout);
-			delete chunk;
-			break;
-		} else
-			delete chunk;
+		//	cout  << Simulator::Now().GetMicroSeconds() << "[" << this->aId << "] "
+		//		<< " Drop Rx for STA " << packet->GetUid() << endl;
 	}
 
 	stats->get(this->id).NumberOfReceivesDropped++;
 }
 
-void NodeEntry::OnPhyStateChange(std::string context, const Time start,	const Time duration, const WifiPhy::State state) {
-	unused(context);
+void NodeEntry::OnPhyStateChange(const Time start,	const Time duration, const WifiPhy::State state) {
 	unused(start);
 	switch (state) {
 
 	case WifiPhy::State::SLEEP:
 		stats->get(this->id).TotalDozeTime += duration;
+		// the sleep state is reported once it ends
+		stats->get(this->id).NumberOfWakeUps++;
 		break;
 
 	case WifiPhy::State::IDLE:
@@ -411,6 +389,7 @@ void NodeEntry::OnTcpPacketReceivedAtAP(Ptr<const Packet> packet) {
 	if(seqTs.GetSeq() > 0) {
 		auto timeDiff = (Simulator::Now() - seqTs.GetTs());
 		stats->get(this->id).TotalPacketSentReceiveTime += timeDiff;
+		stats->get(this->id).PacketLatency.add(timeDiff.GetMicroSeconds());
 		stats->get(this->id).NumberOfSuccessfulPacketsWithSeqHeader++;
 		stats->get(this->id).TotalPacketPayloadSize += packet->GetSize();
 	}
@@ -600,7 +579,7 @@ void NodeEntry::OnCoapPacketReceived(Ptr<const Packet> packet, Address from) {
 		Time newNow = Simulator::Now();
 		if (currentSequenceNumber == stats->get(this->id).m_prevPacketSeqClient + 1)
 		{
-			stats->get(this->id).m_interPacketDelayClient.push_back(newNow - stats->get(this->id).m_prevPacketTimeClient);
+			stats->get(this->id).m_interPacketDelayClient.add(newNow - stats->get(this->id).m_prevPacketTimeClient);
 			stats->get(this->id).interPacketDelayAtClient = newNow - stats->get(this->id).m_prevPacketTimeClient;
 		    //cout << "============================================================================ interPacketDelayAtClient " << this->id << " is" << newNow - stats->get(this->id).m_prevPacketTimeClient << endl;
 
@@ -612,7 +591,7 @@ void NodeEntry::OnCoapPacketReceived(Ptr<const Packet> packet, Address from) {
 				NS_LOG_INFO (std::to_string(i) << " ");
 			NS_LOG_INFO ("is(are) lost in path Server -> Client");
 
-			stats->get(this->id).m_interPacketDelayClient.push_back(newNow - stats->get(this->id).m_prevPacketTimeClient);
+			stats->get(this->id).m_interPacketDelayClient.add(newNow - stats->get(this->id).m_prevPacketTimeClient);
 			stats->get(this->id).interPacketDelayAtClient = newNow - stats->get(this->id).m_prevPacketTimeClient;
 
 		}
@@ -637,6 +616,7 @@ void NodeEntry::OnUdpPacketReceivedAtAP(Ptr<const Packet> packet) {
 
 		stats->get(this->id).NumberOfSuccessfulPackets++;
 		stats->get(this->id).TotalPacketSentReceiveTime += timeDiff;
+		stats->get(this->id).PacketLatency.add(timeDiff.GetMicroSeconds());
 		stats->get(this->id).TotalPacketPayloadSize += packet->GetSize();
 
 	} catch (std::runtime_error e) {
@@ -663,6 +643,7 @@ void NodeEntry::OnCoapPacketReceivedAtServer(Ptr<const Packet> packet) {
 		stats->get(this->id).NumberOfSuccessfulPacketsWithSeqHeader++;
 		stats->get(this->id).NumberOfSuccessfulPackets++;
 		stats->get(this->id).TotalPacketSentReceiveTime += timeDiff;
+		stats->get(this->id).PacketLatency.add(timeDiff.GetMicroSeconds());
 
 		uint32_t currentSequenceNumber = seqTs.GetSeq();
 		if (currentSequenceNumber == 0)
@@ -673,9 +654,8 @@ void NodeEntry::OnCoapPacketReceivedAtServer(Ptr<const Packet> packet) {
 		else if (currentSequenceNumber == stats->get(this->id).m_prevPacketSeqServer + 1)
 		{
 			Time newNow = Simulator::Now();
-			stats->get(this->id).m_interPacketDelayServer.push_back(newNow - stats->get(this->id).m_prevPacketTimeServer);
+			stats->get(this->id).m_interPacketDelayServer.add(newNow - stats->get(this->id).m_prevPacketTimeServer);
 			stats->get(this->id).interPacketDelayAtServer = newNow - stats->get(this->id).m_prevPacketTimeServer;
-			stats->get(this->id).m_time.push_back(newNow);
 			stats->get(this->id).m_prevPacketSeqServer = currentSequenceNumber;
 			stats->get(this->id).m_prevPacketTimeServer = newNow;
 		}
@@ -687,9 +667,8 @@ void NodeEntry::OnCoapPacketReceivedAtServer(Ptr<const Packet> packet) {
 			NS_LOG_INFO ("is(are) lost in path Client->Server");
 
 			Time newNow = Simulator::Now();
-			stats->get(this->id).m_interPacketDelayServer.push_back(newNow - stats->get(this->id).m_prevPacketTimeServer);
+			stats->get(this->id).m_interPacketDelayServer.add(newNow - stats->get(this->id).m_prevPacketTimeServer);
 			stats->get(this->id).interPacketDelayAtServer = newNow - stats->get(this->id).m_prevPacketTimeServer;
-			stats->get(this->id).m_time.push_back(newNow);
 			stats->get(this->id).m_prevPacketSeqServer = currentSequenceNumber;
 			stats->get(this->id).m_prevPacketTimeServer = newNow;
 
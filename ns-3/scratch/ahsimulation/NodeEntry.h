@@ -11,6 +11,7 @@
 #include "ns3/ipv4-global-routing-helper.h"
 #include "ns3/internet-module.h"
 #include "ns3/extension-headers.h"
+#include "ns3/s1g-beacon-view.h"
 #include <functional>
 #include "Statistics.h"
 #include "ns3/drop-reason.h"
@@ -51,16 +52,18 @@ public:
     void SetAssociation(std::string context, Mac48Address address);
     void UnsetAssociation(std::string context, Mac48Address address);
     void OnS1gBeaconMissed(std::string context,bool nextBeaconIsDTIM);
+    void OnWakeUpGuard(std::string context, Time guard, Time sinceSync);
     void OnNrOfTransmissionsDuringRAWSlotChanged(std::string context, uint16_t oldValue, uint16_t newValue);
 
 
-    void OnPhyTxBegin(std::string context, Ptr<const Packet> packet);
-    void OnPhyTxEnd(std::string context,Ptr<const Packet> packet);
-    void OnPhyTxDrop(std::string context,Ptr<const Packet> packet, DropReason reason);
+    // the PHY traces fire for every frame and are connected without context
+    void OnPhyTxBegin(Ptr<const Packet> packet);
+    void OnPhyTxEnd(Ptr<const Packet> packet);
+    void OnPhyTxDrop(Ptr<const Packet> packet, DropReason reason, const WifiMacHeader& hdr);
     
-    void OnPhyRxBegin(std::string context,Ptr<const Packet> packet);
-    void OnPhyRxEnd(std::string context,Ptr<const Packet> packet);
-    void OnPhyRxDrop(std::string context,Ptr<const Packet> packet, DropReason reason);
+    void OnPhyRxBegin(Ptr<const Packet> packet);
+    void OnPhyRxEnd(Ptr<const Packet> packet);
+    void OnPhyRxDrop(Ptr<const Packet> packet, DropReason reason, const WifiMacHeader& hdr);
 
 
     void OnMacPacketDropped(std::string context, Ptr<const Packet> packet, DropReason reason);
@@ -73,7 +76,7 @@ public:
     void OnCollision(std::string context, uint32_t nrOfBackoffSlots);
     void OnTransmissionWillCrossRAWBoundary(std::string context, Time txDuration, Time remainingTimeInRawSlot);
 
-    void OnPhyStateChange(std::string context, const Time start, const Time duration, const WifiPhy::State state);
+    void OnPhyStateChange(const Time start, const Time duration, const WifiPhy::State state);
 
     void OnTcpPacketSent(Ptr<const Packet> packet);
     void OnTcpPacketDropped(Ptr<Packet> packet, DropReason reason);
@@ -120,8 +123,6 @@ private:
 
     std::function<void()> associatedCallback;
     std::function<void()> deAssociatedCallback;
-    std::map<uint64_t, Time> txMap;
-    std::map<uint64_t, Time> rxMap;
 
     uint16_t lastBeaconAIDStart = 0;
     uint16_t lastBeaconAIDEnd = 0;
@@ -9,6 +9,13 @@ long double NodeStatistics::getAveragePacketSentReceiveTime() { //milliseconds
 		return -1;
 }
 
+long NodeStatistics::getPacketLatencyPercentile(double percentile) {
+	if (PacketLatency.getCount() > 0)
+		return PacketLatency.getPercentile(percentile);
+	else
+		return -1;
+}
+
 // This is jitter in milliseconds
 long NodeStatistics::GetAverageJitter(void)
 {
@@ -18,26 +25,13 @@ long NodeStatistics::GetAverageJitter(void)
 		return -1;
 }
 
-Time NodeStatistics::GetAverageInterPacketDelay(std::vector<Time>& delayVector){
-	if (delayVector.size() != 0)
-	{
-		//cout << "inter packet delay vector size " << delayVector.size() << endl;
-		return std::accumulate(delayVector.begin(), delayVector.end(), Seconds(0.0))/delayVector.size();
-	}
-	else return Time();
+Time NodeStatistics::GetAverageInterPacketDelay(const DelayStatistics& delays){
+	return delays.getAverage();
 }
 
-long double NodeStatistics::GetInterPacketDelayDeviation(std::vector<Time>& delayVector) // in microseconds
+long double NodeStatistics::GetInterPacketDelayDeviation(const DelayStatistics& delays) // in microseconds
 {
-	long double meanInterPacketDelay (this->GetAverageInterPacketDelay(delayVector).GetMicroSeconds());
-	long double dev (0);
-	for (Time& delay : delayVector)
-	{
-		dev += (static_cast<long double>(delay.GetMicroSeconds()) - meanInterPacketDelay)*(static_cast<long double>(delay.GetMicroSeconds() - meanInterPacketDelay));
-	}
-	if (delayVector.size() > 0)
-		return sqrt(dev/delayVector.size());
-	else return -1; //implement exception handling for dummy nodes TODO
+	return delays.getDeviation(); //implement exception handling for dummy nodes TODO
 }
 
 //reliability for one node or for all nodes in whole network? impossible with dummy nodes.
@@ -49,10 +43,10 @@ float NodeStatistics::GetReliability (void)
 	else return -1;
 }
 
-long double NodeStatistics::GetInterPacketDelayDeviationPercentage(std::vector<Time>& delayVector){
-	int64_t avg = GetAverageInterPacketDelay(delayVector).GetMicroSeconds();
+long double NodeStatistics::GetInterPacketDelayDeviationPercentage(const DelayStatistics& delays){
+	int64_t avg = GetAverageInterPacketDelay(delays).GetMicroSeconds();
 	if (avg != 0)
-		return (100*GetInterPacketDelayDeviation(delayVector)/avg);
+		return (100*GetInterPacketDelayDeviation(delays)/avg);
 	else
 		return -1;
 }
@@ -109,6 +103,13 @@ double NodeStatistics::getGoodputKbit() {
 }
 
 
+double NodeStatistics::getAveragePowerMilliWatt() {
+	if(EnergyMeasuredTime.GetSeconds() > 0)
+		return EnergyConsumedJ * 1000 / EnergyMeasuredTime.GetSeconds();
+	else
+		return -1;
+}
+
 Time NodeStatistics::getAverageRemainingWhenAPSendingPacketInSameSlot() {
 	if(NumberOfAPSentPacketForNodeImmediately == 0)
 		return Time();
@@ -3,6 +3,8 @@
 
 #include "ns3/core-module.h"
 #include "ns3/drop-reason.h"
+#include "DelayStatistics.h"
+#include "LogLinearHistogram.h"
 
 using namespace std;
 using namespace ns3;
@@ -14,15 +16,26 @@ public:
     Time TotalReceiveTime = Time();
     Time TotalDozeTime = Time();
     Time TotalActiveTime = Time();
+
+    // energy of the radio, only filled in when the energy model is enabled
+    double EnergyConsumedJ = 0;
+    double EnergyRemainingJ = 0;
+    // part of the consumed energy spent awake ahead of a beacon or RAW slot
+    double EarlyWakeEnergyJ = 0;
+    Time TotalEarlyWakeTime = Time();
+    Time MaxEarlyWakeTime = Time();
+    long NumberOfWakeUps = 0;
+    // simulation time at which the energy was last read from the battery
+    Time EnergyMeasuredTime = Time();
+    double getAveragePowerMilliWatt();
     
     Time interPacketDelayAtServer = Time(); ///ami
     Time interPacketDelayAtClient = Time(); ///ami
-    std::vector<Time> m_interPacketDelayServer;
-    std::vector<Time> m_interPacketDelayClient;
-    std::vector<Time> m_time;
-    long double GetInterPacketDelayDeviation(std::vector<Time>& delayVector);
-    long double GetInterPacketDelayDeviationPercentage(std::vector<Time>& delayVector);
-    Time GetAverageInterPacketDelay(std::vector<Time>& delayVector);
+    DelayStatistics m_interPacketDelayServer;
+    DelayStatistics m_interPacketDelayClient;
+    long double GetInterPacketDelayDeviation(const DelayStatistics& delays);
+    long double GetInterPacketDelayDeviationPercentage(const DelayStatistics& delays);
+    Time GetAverageInterPacketDelay(const DelayStatistics& delays);
     float GetReliability (void);
     long double GetInterPacketDelayAtServer (void);
     long double GetInterPacketDelayAtClient (void);
@@ -54,6 +67,10 @@ public:
     long getNumberOfDroppedPackets();
 
     Time TotalPacketSentReceiveTime = Time();
+    // the sent/receive times of the packets in microseconds, within 3%
+    LogLinearHistogram PacketLatency = LogLinearHistogram(5);
+    // in microseconds, -1 if no packet arrived yet
+    long getPacketLatencyPercentile(double percentile);
 
     // for jitter RMS - cumulative sum of abs differences
     uint64_t jitterAcc = 0;
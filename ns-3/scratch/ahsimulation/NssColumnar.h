@@ -0,0 +1,486 @@
+#ifndef NSSCOLUMNAR_H
+#define NSSCOLUMNAR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+ * Columnar binary format of the nss file, written next to or instead of the
+ * text nss file. Everything except the node statistics is kept as the text
+ * line it would have in the nss file. The node statistics of one sampling
+ * interval are a block with a typed column per statistic, the values of a
+ * node are stored relative to its values of the previous interval so the
+ * counters that barely change take a byte or two.
+ *
+ * File: "NSSC", version byte, then records of a kind byte, a varint payload
+ * length and the payload.
+ *   EVENT:  text line including the time and the trailing newline
+ *   SCHEMA: varint number of columns, per column the varint length of the
+ *           name, the name, the type byte and the varint width of the column
+ *   BLOCK:  the time in ns as a zigzag varint, the varint number of rows and
+ *           then every column:
+ *             INT:         zigzag varint of the difference with the previous
+ *                          interval for every value
+ *             DOUBLE:      varint of the bits xor those of the previous interval
+ *             LONG_DOUBLE: as two DOUBLE values, the nearest double and the
+ *                          remainder, which together are exact
+ *             INT_LIST:    width INT values per row
+ *
+ * This header has no dependencies on ns-3 so readers of the format only need
+ * to include it.
+ */
+namespace nsscolumnar {
+
+enum RecordKind : uint8_t {
+	EVENT = 1,
+	SCHEMA = 2,
+	BLOCK = 3
+};
+
+enum ColumnType : uint8_t {
+	INT = 1,
+	DOUBLE = 2,
+	LONG_DOUBLE = 3,
+	INT_LIST = 4
+};
+
+static const char magic[4] = { 'N', 'S', 'S', 'C' };
+static const uint8_t version = 1;
+
+inline void putVarint(std::string& out, uint64_t value) {
+	while (value >= 0x80) {
+		out += (char)(value | 0x80);
+		value >>= 7;
+	}
+	out += (char)value;
+}
+
+inline bool getVarint(const std::string& in, size_t& pos, uint64_t& value) {
+	value = 0;
+	for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+		uint8_t byte = in[pos++];
+		value |= (uint64_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+	return false;
+}
+
+inline uint64_t zigzag(int64_t value) {
+	return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+inline int64_t unzigzag(uint64_t value) {
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+inline uint64_t bitsOf(double value) {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+inline double doubleOf(uint64_t bits) {
+	double value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+/*
+ * One column of a block. Integers are kept in ints, width per row for an
+ * INT_LIST. Doubles in doubles, two per row for a LONG_DOUBLE.
+ */
+struct Column {
+	std::string name;
+	ColumnType type = INT;
+	uint32_t width = 1;
+
+	std::vector<int64_t> ints;
+	std::vector<double> doubles;
+
+	uint32_t valuesPerRow() const {
+		return type == INT_LIST ? width : (type == LONG_DOUBLE ? 2 : 1);
+	}
+
+	// whether the row has the same value as that row in the other column, doubles by their bits
+	bool hasSameValue(uint32_t row, const Column& other) const {
+		uint32_t n = valuesPerRow();
+		if (other.type != type || other.valuesPerRow() != n)
+			return false;
+		if (type == INT || type == INT_LIST) {
+			if ((row + 1) * n > other.ints.size())
+				return false;
+			return std::equal(ints.begin() + row * n, ints.begin() + (row + 1) * n, other.ints.begin() + row * n);
+		}
+		if ((row + 1) * n > other.doubles.size())
+			return false;
+		for (uint32_t i = row * n; i < (row + 1) * n; i++)
+			if (bitsOf(doubles[i]) != bitsOf(other.doubles[i]))
+				return false;
+		return true;
+	}
+
+	// appends the value of the row to out the way std::to_string would
+	void format(std::string& out, uint32_t row) const {
+		switch (type) {
+		case INT:
+			out += std::to_string(ints[row]);
+			break;
+		case DOUBLE:
+			out += std::to_string(doubles[row]);
+			break;
+		case LONG_DOUBLE:
+			out += std::to_string((long double)doubles[2 * row] + doubles[2 * row + 1]);
+			break;
+		case INT_LIST:
+			for (uint32_t i = 0; i < width; i++) {
+				if (i != 0)
+					out += ',';
+				out += std::to_string(ints[row * width + i]);
+			}
+			break;
+		}
+	}
+};
+
+/*
+ * The node statistics of one sampling interval. The columns are typed by
+ * the values added to the first row, so a value is formatted back exactly
+ * like std::to_string formatted it in the text nss file.
+ */
+class Table {
+
+private:
+	uint32_t nextColumn = 0;
+	bool typed = false;
+
+	Column& nextColumnOfType(ColumnType type, uint32_t width) {
+		if (!typed && nextColumn == columns.size())
+			columns.push_back(Column());
+		Column& column = columns.at(nextColumn++);
+		if (!typed) {
+			column.type = type;
+			column.width = width;
+		}
+		return column;
+	}
+
+	void addInt(int64_t value) {
+		nextColumnOfType(INT, 1).ints.push_back(value);
+	}
+
+	void addDouble(double value) {
+		nextColumnOfType(DOUBLE, 1).doubles.push_back(value);
+	}
+
+	void addLongDouble(long double value) {
+		Column& column = nextColumnOfType(LONG_DOUBLE, 1);
+		double nearest = (double)value;
+		column.doubles.push_back(nearest);
+		column.doubles.push_back((double)(value - nearest));
+	}
+
+public:
+	int64_t time = 0;
+	uint32_t rows = 0;
+	std::vector<Column> columns;
+
+	// empties the table but keeps the columns and their types
+	void clear() {
+		rows = 0;
+		nextColumn = 0;
+		for (auto& column : columns) {
+			column.ints.clear();
+			column.doubles.clear();
+		}
+	}
+
+	void beginRow() {
+		nextColumn = 0;
+	}
+
+	void endRow() {
+		rows++;
+		typed = true;
+	}
+
+	bool isTyped() const {
+		return typed;
+	}
+
+	// the schema read from a file
+	void setColumns(const std::vector<Column>& schema) {
+		columns = schema;
+		typed = true;
+		clear();
+	}
+
+	template <typename T>
+	typename std::enable_if<std::is_integral<T>::value>::type add(T value) {
+		addInt((int64_t)value);
+	}
+
+	template <typename T>
+	typename std::enable_if<std::is_floating_point<T>::value>::type add(T value) {
+		if (sizeof(T) > sizeof(double))
+			addLongDouble(value);
+		else
+			addDouble(value);
+	}
+
+	void add(const std::vector<int64_t>& values) {
+		Column& column = nextColumnOfType(INT_LIST, values.size());
+		column.ints.insert(column.ints.end(), values.begin(), values.end());
+	}
+
+	// the text nss line of a row without the time, e.g. "nodestats;0;12;..."
+	void formatRow(std::string& out, const std::string& kind, uint32_t row) const {
+		out += kind;
+		for (auto& column : columns) {
+			out += ';';
+			column.format(out, row);
+		}
+	}
+
+	/*
+	 * The nodestatsdelta line of a row without the time: the row, then for
+	 * every value that differs from that row of the previous table the index
+	 * of the value in the nodestats line and the value. The first column is
+	 * the row itself. Appends nothing and returns false if no value changed.
+	 */
+	bool formatDeltaRow(std::string& out, uint32_t row, const Table& previous) const {
+		size_t start = out.size();
+		out += "nodestatsdelta;";
+		out += std::to_string(row);
+		size_t unchanged = out.size();
+		for (uint32_t c = 1; c < columns.size(); c++) {
+			if (c < previous.columns.size() && columns[c].hasSameValue(row, previous.columns[c]))
+				continue;
+			out += ';';
+			// after the time and the kind
+			out += std::to_string(c + 2);
+			out += ';';
+			columns[c].format(out, row);
+		}
+		if (out.size() == unchanged) {
+			out.resize(start);
+			return false;
+		}
+		return true;
+	}
+};
+
+inline void encodeSchema(std::string& out, const Table& table) {
+	putVarint(out, table.columns.size());
+	for (auto& column : table.columns) {
+		putVarint(out, column.name.size());
+		out += column.name;
+		out += (char)column.type;
+		putVarint(out, column.width);
+	}
+}
+
+inline bool decodeSchema(const std::string& in, Table& table) {
+	size_t pos = 0;
+	uint64_t count;
+	if (!getVarint(in, pos, count))
+		return false;
+	std::vector<Column> columns(count);
+	for (auto& column : columns) {
+		uint64_t length, width;
+		if (!getVarint(in, pos, length) || pos + length + 1 > in.size())
+			return false;
+		column.name = in.substr(pos, length);
+		pos += length;
+		column.type = (ColumnType)in[pos++];
+		if (!getVarint(in, pos, width))
+			return false;
+		column.width = width;
+	}
+	table.setColumns(columns);
+	return true;
+}
+
+/*
+ * Encodes the table relative to the previous one of the same schema. The
+ * rows of a table are the nodes, a node without a previous row is encoded
+ * relative to 0.
+ */
+inline void encodeBlock(std::string& out, const Table& table, const Table& previous) {
+	putVarint(out, zigzag(table.time));
+	putVarint(out, table.rows);
+	for (size_t c = 0; c < table.columns.size(); c++) {
+		const Column& column = table.columns[c];
+		bool hasPrevious = c < previous.columns.size();
+		if (column.type == INT || column.type == INT_LIST) {
+			for (size_t i = 0; i < column.ints.size(); i++) {
+				int64_t base = (hasPrevious && i < previous.columns[c].ints.size()) ? previous.columns[c].ints[i] : 0;
+				putVarint(out, zigzag((int64_t)((uint64_t)column.ints[i] - (uint64_t)base)));
+			}
+		}
+		else {
+			for (size_t i = 0; i < column.doubles.size(); i++) {
+				uint64_t base = (hasPrevious && i < previous.columns[c].doubles.size()) ? bitsOf(previous.columns[c].doubles[i]) : 0;
+				putVarint(out, bitsOf(column.doubles[i]) ^ base);
+			}
+		}
+	}
+}
+
+inline bool decodeBlock(const std::string& in, Table& table, const Table& previous) {
+	size_t pos = 0;
+	uint64_t time, rows;
+	if (!getVarint(in, pos, time) || !getVarint(in, pos, rows))
+		return false;
+	table.clear();
+	table.time = unzigzag(time);
+	table.rows = rows;
+	for (size_t c = 0; c < table.columns.size(); c++) {
+		Column& column = table.columns[c];
+		bool hasPrevious = c < previous.columns.size();
+		uint64_t count = rows * column.valuesPerRow();
+		for (size_t i = 0; i < count; i++) {
+			uint64_t value;
+			if (!getVarint(in, pos, value))
+				return false;
+			if (column.type == INT || column.type == INT_LIST) {
+				int64_t base = (hasPrevious && i < previous.columns[c].ints.size()) ? previous.columns[c].ints[i] : 0;
+				column.ints.push_back((int64_t)((uint64_t)unzigzag(value) + (uint64_t)base));
+			}
+			else {
+				uint64_t base = (hasPrevious && i < previous.columns[c].doubles.size()) ? bitsOf(previous.columns[c].doubles[i]) : 0;
+				column.doubles.push_back(doubleOf(value ^ base));
+			}
+		}
+	}
+	return pos == in.size();
+}
+
+/*
+ * Reads the records of a columnar nss file one by one.
+ */
+class Reader {
+
+private:
+	std::istream& in;
+	bool valid = false;
+	RecordKind kind = EVENT;
+	std::string payload;
+	std::string event;
+	Table table;
+	Table previous;
+
+public:
+	Reader(std::istream& in) : in(in) {
+		char header[sizeof(magic) + 1];
+		valid = (bool)in.read(header, sizeof(header))
+				&& memcmp(header, magic, sizeof(magic)) == 0
+				&& (uint8_t)header[sizeof(magic)] == version;
+	}
+
+	// false if the stream is not a columnar nss file of a known version
+	bool isValid() const {
+		return valid;
+	}
+
+	// reads the next event or block, false at the end of the file or on an error
+	bool next() {
+		while (valid) {
+			int k = in.get();
+			if (k == EOF)
+				return false;
+			uint64_t length = 0;
+			for (int shift = 0; ; shift += 7) {
+				int byte = in.get();
+				if (byte == EOF || shift >= 64) {
+					valid = false;
+					return false;
+				}
+				length |= (uint64_t)(byte & 0x7f) << shift;
+				if (!(byte & 0x80))
+					break;
+			}
+			payload.resize(length);
+			if (length > 0 && !in.read(&payload[0], length)) {
+				valid = false;
+				return false;
+			}
+
+			kind = (RecordKind)k;
+			switch (kind) {
+			case EVENT:
+				event.swap(payload);
+				return true;
+			case SCHEMA:
+				valid = decodeSchema(payload, table);
+				previous = Table();
+				break;
+			case BLOCK:
+				std::swap(previous, table);
+				table.setColumns(previous.columns);
+				valid = decodeBlock(payload, table, previous);
+				if (valid)
+					return true;
+				break;
+			default:
+				valid = false;
+				break;
+			}
+		}
+		return false;
+	}
+
+	bool isEvent() const {
+		return kind == EVENT;
+	}
+
+	// text line of the current event, including the newline
+	const std::string& getEvent() const {
+		return event;
+	}
+
+	// node statistics of the current block
+	const Table& getTable() const {
+		return table;
+	}
+
+	// appends the current record as it would be in the text nss file
+	void formatText(std::string& out) const {
+		if (isEvent()) {
+			out += event;
+			return;
+		}
+		std::string time = std::to_string(table.time);
+		for (uint32_t row = 0; row < table.rows; row++) {
+			out += time;
+			out += ';';
+			table.formatRow(out, "nodestats", row);
+			out += '\n';
+		}
+	}
+};
+
+/*
+ * Writes the columnar nss file in the text nss format, returns false if the
+ * input isn't a valid columnar nss file or ends in the middle of a record.
+ */
+inline bool convertToText(std::istream& in, std::ostream& out) {
+	Reader reader(in);
+	std::string text;
+	while (reader.next()) {
+		text.clear();
+		reader.formatText(text);
+		out.write(text.data(), text.size());
+	}
+	return reader.isValid() && in.eof();
+}
+
+}
+
+#endif /* NSSCOLUMNAR_H */
@@ -0,0 +1,64 @@
+#include "NssColumnarWriter.h"
+
+NssColumnarWriter::NssColumnarWriter(const string& filename)
+	: filename(filename) {
+	// the file is written from the start, later opens append to it
+	std::remove(filename.c_str());
+}
+
+const string& NssColumnarWriter::getFilename() const {
+	return filename;
+}
+
+void NssColumnarWriter::setFilename(const string& filename) {
+	flush();
+	this->filename = filename;
+}
+
+void NssColumnarWriter::write(nsscolumnar::RecordKind kind, const string& payload) {
+	if (!file) {
+		bool isNew = false;
+		if (FILE* existing = fopen(filename.c_str(), "rb"))
+			fclose(existing);
+		else
+			isNew = true;
+
+		file.reset(new NssFileWriter(filename));
+		if (isNew) {
+			string header(nsscolumnar::magic, sizeof(nsscolumnar::magic));
+			header += (char)nsscolumnar::version;
+			file->write(header);
+		}
+	}
+
+	record.clear();
+	record += (char)kind;
+	nsscolumnar::putVarint(record, payload.size());
+	record += payload;
+	file->write(record);
+}
+
+void NssColumnarWriter::writeEvent(const string& line) {
+	write(nsscolumnar::EVENT, line);
+}
+
+void NssColumnarWriter::writeStatistics(const nsscolumnar::Table& table) {
+	string payload;
+	if (!hasSchema) {
+		nsscolumnar::encodeSchema(payload, table);
+		write(nsscolumnar::SCHEMA, payload);
+		hasSchema = true;
+		payload.clear();
+	}
+
+	nsscolumnar::encodeBlock(payload, table, previous);
+	write(nsscolumnar::BLOCK, payload);
+	previous = table;
+}
+
+void NssColumnarWriter::flush() {
+	if (file) {
+		file->close();
+		file.reset();
+	}
+}
@@ -0,0 +1,43 @@
+#ifndef NSSCOLUMNARWRITER_H
+#define NSSCOLUMNARWRITER_H
+
+#include "NssColumnar.h"
+#include "NssFileWriter.h"
+#include <memory>
+
+using namespace std;
+
+/*
+ * Writes the columnar nss file (see NssColumnar.h) through an NssFileWriter.
+ * The file is opened by the first record and can be closed in between with
+ * flush, the next record appends to it again.
+ */
+class NssColumnarWriter {
+
+private:
+	string filename;
+	unique_ptr<NssFileWriter> file;
+	string record;
+
+	bool hasSchema = false;
+	// the block the next one is encoded relative to
+	nsscolumnar::Table previous;
+
+	void write(nsscolumnar::RecordKind kind, const string& payload);
+
+public:
+	NssColumnarWriter(const string& filename);
+
+	const string& getFilename() const;
+	// continue in another file, which must already have the records written so far
+	void setFilename(const string& filename);
+
+	// a text line of the nss file, including the newline
+	void writeEvent(const string& line);
+	// the column names of the table must not change once it has been written
+	void writeStatistics(const nsscolumnar::Table& table);
+
+	void flush();
+};
+
+#endif /* NSSCOLUMNARWRITER_H */
@@ -0,0 +1,83 @@
+#include "NssFileWriter.h"
+#include <chrono>
+
+NssFileWriter::NssFileWriter(const string& filename)
+	: queue(queueCapacity), head(0), tail(0), stopping(false) {
+	file = fopen(filename.c_str(), "ab");
+	if (file == nullptr)
+		return;
+
+	buffer.reserve(bufferSize);
+	for (auto& slot : queue)
+		slot.reserve(bufferSize);
+	ioThread = thread(&NssFileWriter::run, this);
+}
+
+NssFileWriter::~NssFileWriter() {
+	close();
+}
+
+bool NssFileWriter::isOpen() const {
+	return file != nullptr;
+}
+
+void NssFileWriter::write(const string& data) {
+	if (file == nullptr)
+		return;
+
+	buffer.append(data);
+	if (buffer.size() >= bufferSize)
+		push();
+}
+
+void NssFileWriter::push() {
+	if (buffer.empty())
+		return;
+
+	size_t t = tail.load(memory_order_relaxed);
+	while (t - head.load(memory_order_acquire) >= queueCapacity)
+		this_thread::yield();
+
+	// the slot was emptied by the I/O thread, swapping keeps both allocations
+	queue[t % queueCapacity].swap(buffer);
+	tail.store(t + 1, memory_order_release);
+}
+
+void NssFileWriter::run() {
+	while (true) {
+		size_t h = head.load(memory_order_relaxed);
+		if (h == tail.load(memory_order_acquire)) {
+			// only stop once the buffers pushed before stopping was set are written
+			if (stopping.load() && h == tail.load(memory_order_acquire))
+				return;
+			this_thread::sleep_for(chrono::microseconds(200));
+			continue;
+		}
+
+		string& slot = queue[h % queueCapacity];
+		fwrite(slot.data(), 1, slot.size(), file);
+		slot.clear();
+		head.store(h + 1, memory_order_release);
+	}
+}
+
+void NssFileWriter::flush() {
+	if (file == nullptr)
+		return;
+
+	push();
+	while (head.load(memory_order_acquire) != tail.load(memory_order_relaxed))
+		this_thread::yield();
+	fflush(file);
+}
+
+void NssFileWriter::close() {
+	if (file == nullptr)
+		return;
+
+	push();
+	stopping.store(true);
+	ioThread.join();
+	fclose(file);
+	file = nullptr;
+}
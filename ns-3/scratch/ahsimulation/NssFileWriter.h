@@ -0,0 +1,57 @@
+#ifndef NSSFILEWRITER_H
+#define NSSFILEWRITER_H
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/*
+ * Appends the events of the simulation to the nss file without blocking the
+ * simulation on file I/O. The events are collected in a buffer, a full
+ * buffer is handed to a background thread through a bounded single producer,
+ * single consumer queue and written there. The file stays open until close.
+ *
+ * Only the simulation thread may call write, flush and close. Close before
+ * forking, a forked process doesn't have the background thread.
+ */
+class NssFileWriter {
+
+private:
+	static const size_t bufferSize = 64 * 1024;
+	static const size_t queueCapacity = 8;
+
+	FILE* file = nullptr;
+	string buffer;
+
+	// filled buffers, the simulation thread advances tail and the I/O thread head
+	vector<string> queue;
+	atomic<size_t> head;
+	atomic<size_t> tail;
+	atomic<bool> stopping;
+
+	thread ioThread;
+
+	// hands the buffer to the I/O thread, waits while the queue is full
+	void push();
+	void run();
+
+public:
+	NssFileWriter(const string& filename);
+	~NssFileWriter();
+
+	NssFileWriter(const NssFileWriter&) = delete;
+	NssFileWriter& operator=(const NssFileWriter&) = delete;
+
+	bool isOpen() const;
+
+	void write(const string& data);
+	// returns once everything written so far is in the file
+	void flush();
+	void close();
+};
+
+#endif /* NSSFILEWRITER_H */
@@ -0,0 +1,73 @@
+#include "PhyInFlight.h"
+
+PhyInFlight::Slots::Slots() {
+}
+
+PhyInFlight::Slots::Slots(int nrOfNodes, int slotsPerNode)
+	: slotsPerNode(slotsPerNode), uids(nrOfNodes * slotsPerNode),
+	  starts(nrOfNodes * slotsPerNode), counts(nrOfNodes, 0) {
+}
+
+int PhyInFlight::Slots::begin(int node, uint64_t uid, Time now) {
+	int first = node * slotsPerNode;
+	int count = counts[node];
+	for (int i = first; i < first + count; i++) {
+		if (uids[i] == uid)
+			return count;
+	}
+
+	if (count < slotsPerNode) {
+		uids[first + count] = uid;
+		starts[first + count] = now;
+		counts[node]++;
+		return count + 1;
+	}
+
+	int oldest = first;
+	for (int i = first + 1; i < first + count; i++) {
+		if (starts[i] < starts[oldest])
+			oldest = i;
+	}
+	uids[oldest] = uid;
+	starts[oldest] = now;
+	return count;
+}
+
+bool PhyInFlight::Slots::end(int node, uint64_t uid, Time now, Time& duration) {
+	int first = node * slotsPerNode;
+	int last = first + counts[node] - 1;
+	for (int i = first; i <= last; i++) {
+		if (uids[i] == uid) {
+			duration = now - starts[i];
+			// keep the slots in use at the front
+			uids[i] = uids[last];
+			starts[i] = starts[last];
+			counts[node]--;
+			return true;
+		}
+	}
+	return false;
+}
+
+PhyInFlight::PhyInFlight() {
+}
+
+PhyInFlight::PhyInFlight(int nrOfNodes)
+	: transmissions(nrOfNodes, TRANSMIT_SLOTS), receptions(nrOfNodes, RECEIVE_SLOTS) {
+}
+
+int PhyInFlight::beginTransmit(int node, uint64_t uid, Time now) {
+	return transmissions.begin(node, uid, now);
+}
+
+int PhyInFlight::beginReceive(int node, uint64_t uid, Time now) {
+	return receptions.begin(node, uid, now);
+}
+
+bool PhyInFlight::endTransmit(int node, uint64_t uid, Time now, Time& duration) {
+	return transmissions.end(node, uid, now, duration);
+}
+
+bool PhyInFlight::endReceive(int node, uint64_t uid, Time now, Time& duration) {
+	return receptions.end(node, uid, now, duration);
+}
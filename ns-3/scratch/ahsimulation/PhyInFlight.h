@@ -0,0 +1,62 @@
+#ifndef PHYINFLIGHT_H
+#define PHYINFLIGHT_H
+
+#include "ns3/core-module.h"
+#include <vector>
+
+using namespace std;
+using namespace ns3;
+
+/*
+ * The frames that are in flight on the PHY of every node, from the begin of a
+ * transmission or reception until its end or drop. A half-duplex PHY has at
+ * most one transmission and a few overlapping receive attempts, so every node
+ * gets a fixed number of slots in flat arrays shared by all nodes, which are
+ * sized once and never allocate while the simulation runs.
+ *
+ * When all slots of a node are taken the oldest frame is given up. That is a
+ * reception the PHY aborted without a drop, e.g. because it switched to TX.
+ */
+class PhyInFlight {
+
+public:
+	static const int TRANSMIT_SLOTS = 1;
+	static const int RECEIVE_SLOTS = 4;
+
+private:
+	class Slots {
+	private:
+		int slotsPerNode = 0;
+		// the slots of node n are [n * slotsPerNode, n * slotsPerNode + count[n])
+		vector<uint64_t> uids;
+		vector<Time> starts;
+		vector<uint8_t> counts;
+
+	public:
+		Slots();
+		Slots(int nrOfNodes, int slotsPerNode);
+
+		int begin(int node, uint64_t uid, Time now);
+		bool end(int node, uint64_t uid, Time now, Time& duration);
+	};
+
+	Slots transmissions;
+	Slots receptions;
+
+public:
+	PhyInFlight();
+	PhyInFlight(int nrOfNodes);
+
+	// both return the number of frames in flight including this one, a frame
+	// that is already in flight keeps its begin and one that doesn't fit
+	// replaces the oldest, so the number never exceeds the slots of a node
+	int beginTransmit(int node, uint64_t uid, Time now);
+	int beginReceive(int node, uint64_t uid, Time now);
+
+	// false if the frame was not in flight, otherwise duration is set to the
+	// time since its begin
+	bool endTransmit(int node, uint64_t uid, Time now, Time& duration);
+	bool endReceive(int node, uint64_t uid, Time now, Time& duration);
+};
+
+#endif /* PHYINFLIGHT_H */
@@ -12,13 +12,15 @@ SimulationEventManager::SimulationEventManager()
 	: hostname("localhost"), port(7707), filename("") {
 }
 
-SimulationEventManager::SimulationEventManager(string hostname, int port, string filename)
+SimulationEventManager::SimulationEventManager(string hostname, int port, string filename, string columnarFilename)
 	: hostname(hostname), port(port), filename(filename) {
 
 	if(filename != "") {
 		//delete old file
 		std::remove(filename.c_str());
 	}
+	if(columnarFilename != "")
+		columnarWriter = std::make_shared<NssColumnarWriter>(columnarFilename);
 }
 
 void SimulationEventManager::onStart(Configuration& config) {
@@ -86,14 +88,13 @@ void SimulationEventManager::onNodeDeassociated(NodeEntry& node) {
 	send({"stanodedeassoc", std::to_string(node.id)});
 }
 
-string SimulationEventManager::SerializeDropReason(map<DropReason, long>& map) {
-
+vector<int64_t> SimulationEventManager::getDropReasons(map<DropReason, long>& map) {
 	int lastItem = DropReason::TCPTxBufferExceeded;
-	std::stringstream s;
+	vector<int64_t> values(lastItem + 1);
 	for(int i = 0; i <= lastItem;i++) {
-		s << map[(DropReason)i] << ((i == lastItem) ? "": ",");
+		values[i] = map[(DropReason)i];
 	}
-	return s.str();
+	return values;
 }
 
 void SimulationEventManager::onUpdateSlotStatistics(vector<long>& transmissionsPerSlotFromAP, vector<long>& transmissionsPerSlotFromSTA) {
@@ -115,75 +116,157 @@ void SimulationEventManager::onUpdateSlotStatistics(vector<long>& transmissionsP
 	send(values);
 }
 
+void SimulationEventManager::onUpdateSlotAirtime(SlotAirtime& airtime) {
+	vector<string> values;
+	values.push_back("slotairtime");
+	for (uint32_t i = 0; i < airtime.getNumberOfSlots(); i++) {
+		const SlotAirtime::Slot& s = airtime.get(i);
+		values.push_back(std::to_string(s.active.GetMicroSeconds()) + "," + std::to_string(s.busy.GetMicroSeconds())
+			+ "," + std::to_string(s.successful.GetMicroSeconds()) + "," + std::to_string(s.collision.GetMicroSeconds())
+			+ "," + std::to_string(s.getIdle().GetMicroSeconds()) + "," + std::to_string(s.occurrences)
+			+ "," + std::to_string(s.contendingStations));
+	}
+	send(values);
+}
+
 void SimulationEventManager::onUpdateStatistics(Statistics& stats) {
+	statisticsTable.clear();
+	statisticsTable.time = Simulator::Now().GetNanoSeconds();
 	for(int i = 0; i < stats.getNumberOfNodes(); i++) {
-		send({"nodestats", std::to_string(i),
-			std::to_string(stats.get(i).TotalTransmitTime.GetMilliSeconds()),
-			std::to_string(stats.get(i).TotalReceiveTime.GetMilliSeconds()),
-			std::to_string(stats.get(i).TotalDozeTime.GetMilliSeconds()),
-			std::to_string((Simulator::Now() - stats.get(i).TotalDozeTime).GetMilliSeconds()),
-			std::to_string(stats.get(i).NumberOfTransmissions),
-			std::to_string(stats.get(i).NumberOfTransmissionsDropped),
-			std::to_string(stats.get(i).NumberOfReceives),
-			std::to_string(stats.get(i).NumberOfReceivesDropped),
-			std::to_string(stats.get(i).NumberOfSentPackets),
-			std::to_string(stats.get(i).NumberOfSuccessfulPackets),
-			std::to_string(stats.get(i).getNumberOfDroppedPackets()),
-			std::to_string(stats.get(i).getAveragePacketSentReceiveTime()),
-			std::to_string(stats.get(i).getGoodputKbit()),
-			std::to_string(stats.get(i).EDCAQueueLength),
-			std::to_string(stats.get(i).NumberOfSuccessfulRoundtripPackets),
-			std::to_string(stats.get(i).getAveragePacketRoundTripTime(m_config.trafficType)),
-			std::to_string(stats.get(i).TCPCongestionWindow),
-			std::to_string(stats.get(i).NumberOfTCPRetransmissions),
-			std::to_string(stats.get(i).NumberOfTCPRetransmissionsFromAP),
-			std::to_string(stats.get(i).NumberOfReceiveDroppedByDestination),
-			std::to_string(stats.get(i).NumberOfMACTxRTSFailed),
-			std::to_string(stats.get(i).NumberOfMACTxMissedACK),
-			this->SerializeDropReason(stats.get(i).NumberOfDropsByReason),
-			this->SerializeDropReason(stats.get(i).NumberOfDropsByReasonAtAP),
-			std::to_string(stats.get(i).TCPRTOValue.GetMicroSeconds() == 0 ? -1 : stats.get(i).TCPRTOValue.GetMicroSeconds()),
-			std::to_string(stats.get(i).NumberOfAPScheduledPacketForNodeInNextSlot),
-			std::to_string(stats.get(i).NumberOfAPSentPacketForNodeImmediately),
-			std::to_string(stats.get(i).getAverageRemainingWhenAPSendingPacketInSameSlot().GetMicroSeconds()),
-			std::to_string(stats.get(i).NumberOfCollisions),
-			std::to_string(stats.get(i).NumberOfMACTxMissedACKAndDroppedPacket),
-			(stats.get(i).TCPConnected ? "1" : "0"),
-			std::to_string(stats.get(i).TCPSlowStartThreshold),
-			std::to_string(stats.get(i).TCPEstimatedBandwidth),
-			std::to_string(stats.get(i).TCPRTTValue.GetMicroSeconds() == 0 ? -1 : stats.get(i).TCPRTTValue.GetMicroSeconds()),
-			std::to_string(stats.get(i).NumberOfBeaconsMissed),
-			std::to_string(stats.get(i).NumberOfTransmissionsDuringRAWSlot),
-			std::to_string(stats.get(i).getTotalDrops()),
-			std::to_string(stats.get(i).FirmwareTransferTime.GetMicroSeconds()),
-			std::to_string(stats.get(i).getIPCameraSendingRate()),
-			std::to_string(stats.get(i).getIPCameraAPReceivingRate()),
-			std::to_string(stats.get(i).NumberOfTransmissionsCancelledDueToCrossingRAWBoundary),
-			std::to_string(stats.get(i).GetAverageJitter()), // I have jitter in micros abs delay between subsequent packets
-			std::to_string(stats.get(i).GetReliability()),
-			std::to_string(stats.get(i).GetInterPacketDelayAtServer()),
-			std::to_string(stats.get(i).GetInterPacketDelayAtClient()),
-			std::to_string(stats.get(i).GetInterPacketDelayDeviationPercentage(stats.get(i).m_interPacketDelayServer)),
-			std::to_string(stats.get(i).GetInterPacketDelayDeviationPercentage(stats.get(i).m_interPacketDelayClient))
-		});
+		statisticsTable.beginRow();
+		statisticsTable.add(i);
+		statisticsTable.add(stats.get(i).TotalTransmitTime.GetMilliSeconds());
+		statisticsTable.add(stats.get(i).TotalReceiveTime.GetMilliSeconds());
+		statisticsTable.add(stats.get(i).TotalDozeTime.GetMilliSeconds());
+		statisticsTable.add((Simulator::Now() - stats.get(i).TotalDozeTime).GetMilliSeconds());
+		statisticsTable.add(stats.get(i).NumberOfTransmissions);
+		statisticsTable.add(stats.get(i).NumberOfTransmissionsDropped);
+		statisticsTable.add(stats.get(i).NumberOfReceives);
+		statisticsTable.add(stats.get(i).NumberOfReceivesDropped);
+		statisticsTable.add(stats.get(i).NumberOfSentPackets);
+		statisticsTable.add(stats.get(i).NumberOfSuccessfulPackets);
+		statisticsTable.add(stats.get(i).getNumberOfDroppedPackets());
+		statisticsTable.add(stats.get(i).getAveragePacketSentReceiveTime());
+		statisticsTable.add(stats.get(i).getGoodputKbit());
+		statisticsTable.add(stats.get(i).EDCAQueueLength);
+		statisticsTable.add(stats.get(i).NumberOfSuccessfulRoundtripPackets);
+		statisticsTable.add(stats.get(i).getAveragePacketRoundTripTime(m_config.trafficType));
+		statisticsTable.add(stats.get(i).TCPCongestionWindow);
+		statisticsTable.add(stats.get(i).NumberOfTCPRetransmissions);
+		statisticsTable.add(stats.get(i).NumberOfTCPRetransmissionsFromAP);
+		statisticsTable.add(stats.get(i).NumberOfReceiveDroppedByDestination);
+		statisticsTable.add(stats.get(i).NumberOfMACTxRTSFailed);
+		statisticsTable.add(stats.get(i).NumberOfMACTxMissedACK);
+		statisticsTable.add(getDropReasons(stats.get(i).NumberOfDropsByReason));
+		statisticsTable.add(getDropReasons(stats.get(i).NumberOfDropsByReasonAtAP));
+		statisticsTable.add(stats.get(i).TCPRTOValue.GetMicroSeconds() == 0 ? -1 : stats.get(i).TCPRTOValue.GetMicroSeconds());
+		statisticsTable.add(stats.get(i).NumberOfAPScheduledPacketForNodeInNextSlot);
+		statisticsTable.add(stats.get(i).NumberOfAPSentPacketForNodeImmediately);
+		statisticsTable.add(stats.get(i).getAverageRemainingWhenAPSendingPacketInSameSlot().GetMicroSeconds());
+		statisticsTable.add(stats.get(i).NumberOfCollisions);
+		statisticsTable.add(stats.get(i).NumberOfMACTxMissedACKAndDroppedPacket);
+		statisticsTable.add((stats.get(i).TCPConnected ? 1 : 0));
+		statisticsTable.add(stats.get(i).TCPSlowStartThreshold);
+		statisticsTable.add(stats.get(i).TCPEstimatedBandwidth);
+		statisticsTable.add(stats.get(i).TCPRTTValue.GetMicroSeconds() == 0 ? -1 : stats.get(i).TCPRTTValue.GetMicroSeconds());
+		statisticsTable.add(stats.get(i).NumberOfBeaconsMissed);
+		statisticsTable.add(stats.get(i).NumberOfTransmissionsDuringRAWSlot);
+		statisticsTable.add(stats.get(i).getTotalDrops());
+		statisticsTable.add(stats.get(i).FirmwareTransferTime.GetMicroSeconds());
+		statisticsTable.add(stats.get(i).getIPCameraSendingRate());
+		statisticsTable.add(stats.get(i).getIPCameraAPReceivingRate());
+		statisticsTable.add(stats.get(i).NumberOfTransmissionsCancelledDueToCrossingRAWBoundary);
+		statisticsTable.add(stats.get(i).GetAverageJitter()); // I have jitter in micros abs delay between subsequent packets
+		statisticsTable.add(stats.get(i).GetReliability());
+		statisticsTable.add(stats.get(i).GetInterPacketDelayAtServer());
+		statisticsTable.add(stats.get(i).GetInterPacketDelayAtClient());
+		statisticsTable.add(stats.get(i).GetInterPacketDelayDeviationPercentage(stats.get(i).m_interPacketDelayServer));
+		statisticsTable.add(stats.get(i).GetInterPacketDelayDeviationPercentage(stats.get(i).m_interPacketDelayClient));
+		statisticsTable.add(stats.get(i).EnergyConsumedJ);
+		statisticsTable.add(stats.get(i).EnergyRemainingJ);
+		statisticsTable.add(stats.get(i).EarlyWakeEnergyJ);
+		statisticsTable.add(stats.get(i).NumberOfWakeUps);
+		statisticsTable.add(stats.get(i).getPacketLatencyPercentile(50));
+		statisticsTable.add(stats.get(i).getPacketLatencyPercentile(95));
+		statisticsTable.add(stats.get(i).getPacketLatencyPercentile(99));
+		statisticsTable.add(stats.get(i).getPacketLatencyPercentile(99.9));
+		statisticsTable.endRow();
+	}
+	if (statisticsTable.columns.size() == statisticsColumns.size())
+		for (uint32_t c = 0; c < statisticsColumns.size(); c++)
+			statisticsTable.columns[c].name = statisticsColumns[c];
+
+	if (hasTextOutput()) {
+		bool isKeyframe = statisticsIntervalsSinceKeyframe == 0 || statisticsIntervalsSinceKeyframe >= m_config.nodeStatsKeyframeInterval
+				|| previousStatisticsTable.rows != statisticsTable.rows || previousStatisticsTable.columns.size() != statisticsTable.columns.size();
+		string time = std::to_string(statisticsTable.time);
+		for (uint32_t i = 0; i < statisticsTable.rows; i++) {
+			line.clear();
+			line += time;
+			line += ';';
+			if (isKeyframe)
+				statisticsTable.formatRow(line, "nodestats", i);
+			else if (!statisticsTable.formatDeltaRow(line, i, previousStatisticsTable))
+				continue;
+			line += '\n';
+			output(false);
+		}
+		statisticsIntervalsSinceKeyframe = isKeyframe ? 1 : statisticsIntervalsSinceKeyframe + 1;
 	}
+	if (columnarWriter)
+		columnarWriter->writeStatistics(statisticsTable);
+	// the columns keep their names and types, the values are replaced next interval
+	std::swap(previousStatisticsTable, statisticsTable);
+}
+
+void SimulationEventManager::onLifetimeProjection(int index, LifetimeProjection& projection, double remainingEnergy) {
+	// lifetimes in seconds, -1 when the battery is not depleted
+	auto seconds = [](Time t) { return (t == Time::Max()) ? string("-1") : std::to_string(t.GetSeconds()); };
+	send({"lifetimeprojection", std::to_string(index),
+		std::to_string(projection.getNumberOfSamples(index)),
+		std::to_string(projection.getAveragePower(index)),
+		std::to_string(projection.getAveragePowerHalfWidth(index)),
+		std::to_string(remainingEnergy),
+		seconds(projection.getLifetime(index, remainingEnergy)),
+		seconds(projection.getLifetimeLowerBound(index, remainingEnergy)),
+		seconds(projection.getLifetimeUpperBound(index, remainingEnergy)),
+		(projection.hasConverged(index) ? "1" : "0")
+	});
 }
 
-void SimulationEventManager::send(vector<string> str) {
+void SimulationEventManager::send(const vector<string>& str) {
 
-	std::stringstream s;
-	s << Simulator::Now().GetNanoSeconds() << ";";
+	line.clear();
+	line += std::to_string(Simulator::Now().GetNanoSeconds());
+	line += ';';
 	for(uint32_t i = 0; i < str.size(); i++) {
-		s << str[i] << ((i != str.size()-1) ? ";" : "");
+		line += str[i];
+		if (i != str.size()-1)
+			line += ';';
+	}
+	line += '\n';
+
+	output(true);
+}
+
+bool SimulationEventManager::hasTextOutput() const {
+	return (this->filename != "" && this->filename != "none") || (this->hostname != "" && this->hostname != "none");
+}
+
+void SimulationEventManager::output(bool isEvent) {
+	if (!flushScheduled && (columnarWriter || (this->filename != "" && this->filename != "none"))) {
+		Simulator::ScheduleDestroy(&SimulationEventManager::flush, this);
+		flushScheduled = true;
 	}
-	s << "\n";
+
+	if (isEvent && columnarWriter)
+		columnarWriter->writeEvent(line);
 
 	if(this->filename != "" && this->filename != "none") {
-		ofstream fileStream(filename,fstream::out|fstream::app);
-		if(fileStream.is_open())
-			fileStream << s.str();
+		if (!fileWriter)
+			fileWriter = std::make_shared<NssFileWriter>(filename);
 		// append to file
-		fileStream.close();
+		fileWriter->write(line);
 	}
 
 	if(this->hostname != "" && this->hostname != "none") {
@@ -196,7 +279,7 @@ void SimulationEventManager::send(vector<string> str) {
 				return;
 		}
 
-		bool success = stat_send(socketDescriptor, string(s.str()).c_str());
+		bool success = stat_send(socketDescriptor, line.c_str());
 
 		if(!success) {
 			std::cout << "Sending failed" << std::endl;
@@ -250,7 +333,7 @@ void SimulationEventManager::onStartHeader() {
 }
 
 void SimulationEventManager::onStatisticsHeader() {
-	send({"nodestatsheader", "STAIndex",
+	statisticsColumns = {"STAIndex",
 		"TotalTransmitTime",
 		"TotalReceiveTime",
 		"TotalDozeTime",
@@ -297,11 +380,69 @@ void SimulationEventManager::onStatisticsHeader() {
 		"InterPacketDelayAtServer",
 		"InterPacketDelayAtClient",
 		"InterPacketDelayDeviationPercentageAtServer",
-		"InterPacketDelayDeviationPercentageAtClient"
+		"InterPacketDelayDeviationPercentageAtClient",
+		"EnergyConsumed",
+		"EnergyRemaining",
+		"EarlyWakeEnergy",
+		"NumberOfWakeUps",
+		"LatencyP50",
+		"LatencyP95",
+		"LatencyP99",
+		"LatencyP999"
+	};
+
+	vector<string> values = {"nodestatsheader"};
+	values.insert(values.end(), statisticsColumns.begin(), statisticsColumns.end());
+	send(values);
+}
+
+
+void SimulationEventManager::onLifetimeProjectionHeader() {
+	send({"lifetimeprojectionheader", "STAIndex",
+		"NumberOfSamples",
+		"AveragePower",
+		"AveragePowerHalfWidth",
+		"EnergyRemaining",
+		"Lifetime",
+		"LifetimeLowerBound",
+		"LifetimeUpperBound",
+		"Converged"
 	});
+}
 
+void SimulationEventManager::flush() {
+	if (fileWriter) {
+		fileWriter->close();
+		fileWriter.reset();
+	}
+	if (columnarWriter)
+		columnarWriter->flush();
+	flushScheduled = false;
+}
+
+static void copyFile(const string& from, const string& to) {
+	ifstream source(from, fstream::binary);
+	ofstream destination(to, fstream::binary|fstream::trunc);
+	destination << source.rdbuf();
 }
 
+void SimulationEventManager::onForked(string filename, string columnarFilename) {
+	if(this->filename != "" && this->filename != "none" && filename != this->filename) {
+		copyFile(this->filename, filename);
+		this->filename = filename;
+	}
+	if(columnarWriter && columnarFilename != columnarWriter->getFilename()) {
+		copyFile(columnarWriter->getFilename(), columnarFilename);
+		columnarWriter->setFilename(columnarFilename);
+	}
+
+	if(socketDescriptor != -1) {
+		// only closes the descriptor of this process
+		stat_close(socketDescriptor);
+		socketDescriptor = -1;
+	}
+	this->hostname = "none";
+}
 
 SimulationEventManager::~SimulationEventManager() {
 
@@ -10,7 +10,11 @@
 
 #include "NodeEntry.h"
 #include "Statistics.h"
+#include "LifetimeProjection.h"
+#include "SlotAirtime.h"
 #include "Configuration.h"
+#include "NssFileWriter.h"
+#include "NssColumnarWriter.h"
 #include "ns3/drop-reason.h"
 #include <fstream>
 #include <memory>
@@ -26,11 +30,32 @@ private:
 	Configuration m_config; ///ami
 	int socketDescriptor = -1;
 
-	void send(vector<string> str);
+	// opened by the first event, shared by the copies of the manager
+	shared_ptr<NssFileWriter> fileWriter;
+	shared_ptr<NssColumnarWriter> columnarWriter;
+	bool flushScheduled = false;
+	// reused to format every event
+	string line;
+
+	// names of the node statistics and their values of the last interval
+	vector<string> statisticsColumns;
+	nsscolumnar::Table statisticsTable;
+	// the values the text output has of every node, to only send the changes
+	nsscolumnar::Table previousStatisticsTable;
+	int statisticsIntervalsSinceKeyframe = 0;
+
+	void send(const vector<string>& str);
+	// writes line, which only goes to the columnar file if it is an event
+	void output(bool isEvent);
+	bool hasTextOutput() const;
 
 public:
 	SimulationEventManager();
-	SimulationEventManager(string hostname, int port, string filename);
+	/*
+	 * An empty columnarFilename doesn't write the columnar nss file, see
+	 * NssColumnar.h for its format
+	 */
+	SimulationEventManager(string hostname, int port, string filename, string columnarFilename = "");
 
     void onStartHeader();
 	void onStart(Configuration& config);
@@ -42,14 +67,43 @@ public:
 	void onNodeAssociated(NodeEntry& node);
 	void onNodeDeassociated(NodeEntry& node);
 
-	string SerializeDropReason(map<DropReason, long>& map);
+	vector<int64_t> getDropReasons(map<DropReason, long>& map);
 
 	void onUpdateSlotStatistics(vector<long>& transmissionsPerSlotFromAP, vector<long>& transmissionsPerSlotFromSTA);
+	/*
+	 * Per TIM group and RAW slot since the start: the active, busy, successful,
+	 * collision and idle airtime in microseconds, the occurrences and the
+	 * contending stations summed over them, separated by commas
+	 */
+	void onUpdateSlotAirtime(SlotAirtime& airtime);
 
 	void onStatisticsHeader();
 
+	/*
+	 * Every NodeStatsKeyframeInterval a nodestats record of every node, in
+	 * between a nodestatsdelta record of the nodes of which statistics
+	 * changed: "time;nodestatsdelta;STAIndex" followed by pairs of the index
+	 * of the statistic in the nodestats record and its new value.
+	 */
 	void onUpdateStatistics(Statistics& stats);
 
+	void onLifetimeProjectionHeader();
+	void onLifetimeProjection(int index, LifetimeProjection& projection, double remainingEnergy);
+
+	/*
+	 * Write the buffered events to the nss file and close it, the next event
+	 * opens it again. Also done when the simulator is destroyed.
+	 */
+	void flush();
+
+	/*
+	 * Continue in a forked process: the events sent so far are copied to
+	 * the given files and the rest is written there. The connection to the
+	 * visualizer stays with the parent process. The parent has to flush
+	 * before forking.
+	 */
+	void onForked(string filename, string columnarFilename);
+
 	virtual ~SimulationEventManager();
 };
 
@@ -0,0 +1,92 @@
+#include "SlotAirtime.h"
+
+Time SlotAirtime::Slot::getIdle() const {
+	return (active > busy) ? active - busy : Time();
+}
+
+double SlotAirtime::Slot::getAverageContendingStations() const {
+	if (occurrences == 0)
+		return 0;
+	return (double)contendingStations / occurrences;
+}
+
+SlotAirtime::SlotAirtime() {
+}
+
+SlotAirtime::SlotAirtime(uint32_t nrOfGroups, uint32_t nrOfSlots, uint32_t nrOfStations)
+	: nrOfSlots(nrOfSlots), slots(nrOfGroups * nrOfSlots), lastOccurrenceOfStation(nrOfStations, -1) {
+}
+
+void SlotAirtime::onSlotStarted(uint16_t timGroup, uint16_t slot) {
+	if (currentSlot != -1)
+		onSlotEnded(currentSlot / nrOfSlots, currentSlot % nrOfSlots);
+
+	uint32_t index = timGroup * nrOfSlots + slot;
+	if (index >= slots.size())
+		return;
+
+	currentSlot = index;
+	currentSlotStart = Simulator::Now();
+	currentContendingStations = 0;
+	occurrence++;
+}
+
+void SlotAirtime::onSlotEnded(uint16_t timGroup, uint16_t slot) {
+	if (currentSlot != (int)(timGroup * nrOfSlots + slot))
+		return;
+
+	Slot& s = slots[currentSlot];
+	s.active += Simulator::Now() - currentSlotStart;
+	s.occurrences++;
+	s.contendingStations += currentContendingStations;
+	s.maxContendingStations = std::max(s.maxContendingStations, currentContendingStations);
+	currentSlot = -1;
+}
+
+void SlotAirtime::onTransmission(int station, Time duration) {
+	Time now = Simulator::Now();
+	if (periodTransmissions > 0 && now < periodEnd) {
+		periodTransmissions++;
+		periodEnd = std::max(periodEnd, now + duration);
+	}
+	else {
+		closePeriod();
+		periodSlot = currentSlot;
+		periodStart = now;
+		periodEnd = now + duration;
+		periodTransmissions = 1;
+	}
+
+	if (currentSlot != -1 && station >= 0 && (uint32_t)station < lastOccurrenceOfStation.size()
+			&& lastOccurrenceOfStation[station] != occurrence) {
+		lastOccurrenceOfStation[station] = occurrence;
+		currentContendingStations++;
+	}
+}
+
+void SlotAirtime::closePeriod() {
+	if (periodTransmissions > 0 && periodSlot != -1) {
+		Slot& s = slots[periodSlot];
+		Time length = periodEnd - periodStart;
+		s.busy += length;
+		if (periodTransmissions == 1)
+			s.successful += length;
+		else
+			s.collision += length;
+	}
+	periodTransmissions = 0;
+}
+
+uint32_t SlotAirtime::getNumberOfSlots() const {
+	return slots.size();
+}
+
+const SlotAirtime::Slot& SlotAirtime::get(uint16_t timGroup, uint16_t slot) {
+	return get(timGroup * nrOfSlots + slot);
+}
+
+const SlotAirtime::Slot& SlotAirtime::get(uint32_t index) {
+	if (periodTransmissions > 0 && periodEnd <= Simulator::Now())
+		closePeriod();
+	return slots.at(index);
+}
@@ -0,0 +1,71 @@
+#ifndef SLOTAIRTIME_H
+#define SLOTAIRTIME_H
+
+#include "ns3/core-module.h"
+#include <vector>
+
+using namespace std;
+using namespace ns3;
+
+/*
+ * Accounts the airtime of the channel per TIM group and RAW slot from the
+ * start and duration of every transmission. Overlapping transmissions form
+ * one busy period, which is attributed to the slot that was active when it
+ * began. A busy period of a single transmission is successful airtime, one
+ * of several transmissions collision airtime; whether a receiver decoded the
+ * frame anyway is left to the PHY statistics. Transmissions outside of a RAW
+ * slot are not accounted.
+ */
+class SlotAirtime {
+
+public:
+	struct Slot {
+		Time active = Time();
+		Time busy = Time();
+		Time successful = Time();
+		Time collision = Time();
+		// number of times the slot took place
+		long occurrences = 0;
+		// stations that transmitted, summed over the occurrences
+		long contendingStations = 0;
+		long maxContendingStations = 0;
+
+		Time getIdle() const;
+		double getAverageContendingStations() const;
+	};
+
+private:
+	uint32_t nrOfSlots = 0;
+	vector<Slot> slots;
+
+	int currentSlot = -1;
+	Time currentSlotStart = Time();
+	long currentContendingStations = 0;
+	// occurrence of a slot in which a station last transmitted, to count it once
+	vector<long> lastOccurrenceOfStation;
+	long occurrence = 0;
+
+	// the busy period that may still be extended by an overlapping transmission
+	int periodSlot = -1;
+	Time periodStart = Time();
+	Time periodEnd = Time();
+	uint32_t periodTransmissions = 0;
+
+	void closePeriod();
+
+public:
+	SlotAirtime();
+	SlotAirtime(uint32_t nrOfGroups, uint32_t nrOfSlots, uint32_t nrOfStations);
+
+	void onSlotStarted(uint16_t timGroup, uint16_t slot);
+	void onSlotEnded(uint16_t timGroup, uint16_t slot);
+	// station is the index of the transmitting station, -1 for the AP
+	void onTransmission(int station, Time duration);
+
+	uint32_t getNumberOfSlots() const;
+	// includes every busy period that has ended by now
+	const Slot& get(uint16_t timGroup, uint16_t slot);
+	const Slot& get(uint32_t index);
+};
+
+#endif /* SLOTAIRTIME_H */
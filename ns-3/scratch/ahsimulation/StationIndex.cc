@@ -0,0 +1,69 @@
+#include "StationIndex.h"
+
+StationIndex::StationIndex() {
+}
+
+StationIndex::StationIndex(uint32_t nrOfStations)
+	: associated(nrOfStations, false) {
+	byMac.reserve(nrOfStations);
+	byIpv4.reserve(nrOfStations);
+	byIpv6.reserve(nrOfStations);
+}
+
+uint64_t StationIndex::getKey(Mac48Address address) {
+	uint8_t buffer[6];
+	address.CopyTo(buffer);
+	uint64_t key = 0;
+	for (int i = 0; i < 6; i++)
+		key = (key << 8) | buffer[i];
+	return key;
+}
+
+void StationIndex::add(uint32_t index, Mac48Address address) {
+	byMac[getKey(address)] = index;
+}
+
+void StationIndex::add(uint32_t index, Ipv4Address address) {
+	byIpv4[address.Get()] = index;
+}
+
+void StationIndex::add(uint32_t index, Ipv6Address address) {
+	byIpv6[address] = index;
+}
+
+int StationIndex::find(Mac48Address address) const {
+	auto it = byMac.find(getKey(address));
+	return it != byMac.end() ? it->second : -1;
+}
+
+int StationIndex::find(Ipv4Address address) const {
+	auto it = byIpv4.find(address.Get());
+	return it != byIpv4.end() ? it->second : -1;
+}
+
+int StationIndex::find(Ipv6Address address) const {
+	auto it = byIpv6.find(address);
+	return it != byIpv6.end() ? it->second : -1;
+}
+
+void StationIndex::setAssociated(uint32_t index) {
+	if (!associated.at(index)) {
+		associated[index] = true;
+		nrOfAssociated++;
+	}
+}
+
+void StationIndex::setDeassociated(uint32_t index) {
+	if (associated.at(index)) {
+		associated[index] = false;
+		nrOfAssociated--;
+	}
+}
+
+uint32_t StationIndex::getNumberOfAssociated() const {
+	return nrOfAssociated;
+}
+
+bool StationIndex::isEveryStationAssociated() const {
+	return nrOfAssociated == associated.size();
+}
@@ -0,0 +1,52 @@
+#ifndef STATIONINDEX_H
+#define STATIONINDEX_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+using namespace ns3;
+
+/*
+ * Resolves the MAC, IPv4 and IPv6 addresses of the stations to their index
+ * in constant time and keeps count of the associated stations, so the trace
+ * handlers of the AP and the server don't have to scan every station on
+ * every event.
+ */
+class StationIndex {
+
+private:
+	unordered_map<uint64_t, uint32_t> byMac;
+	unordered_map<uint32_t, uint32_t> byIpv4;
+	unordered_map<Ipv6Address, uint32_t, Ipv6AddressHash> byIpv6;
+
+	vector<bool> associated;
+	uint32_t nrOfAssociated = 0;
+
+	static uint64_t getKey(Mac48Address address);
+
+public:
+	StationIndex();
+	StationIndex(uint32_t nrOfStations);
+
+	void add(uint32_t index, Mac48Address address);
+	void add(uint32_t index, Ipv4Address address);
+	void add(uint32_t index, Ipv6Address address);
+
+	// index of the station with the given address, -1 if it isn't a station
+	int find(Mac48Address address) const;
+	int find(Ipv4Address address) const;
+	int find(Ipv6Address address) const;
+
+	// both ignore a station that is already in that state
+	void setAssociated(uint32_t index);
+	void setDeassociated(uint32_t index);
+
+	uint32_t getNumberOfAssociated() const;
+	bool isEveryStationAssociated() const;
+};
+
+#endif /* STATIONINDEX_H */
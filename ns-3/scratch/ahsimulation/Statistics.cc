@@ -3,7 +3,7 @@
 Statistics::Statistics() {
 }
 
-Statistics::Statistics(int nrOfNodes) {
+Statistics::Statistics(int nrOfNodes) : phyInFlight(nrOfNodes) {
     for(int i = 0; i < nrOfNodes; i++)
         this->nodeStatistics.push_back(NodeStatistics());    
 }
@@ -11,6 +11,10 @@ NodeStatistics& Statistics::get(int index) {
     return this->nodeStatistics.at(index);
 }
 
+PhyInFlight& Statistics::getPhyInFlight() {
+    return this->phyInFlight;
+}
+
 int Statistics::getNumberOfNodes() const {
     return this->nodeStatistics.size();
 }
@@ -2,6 +2,7 @@
 #define STATISTICS_H
 
 #include "NodeStatistics.h"
+#include "PhyInFlight.h"
 
 using namespace std;
 using namespace ns3;
@@ -9,6 +10,7 @@ using namespace ns3;
 class Statistics {
 private:
     vector<NodeStatistics> nodeStatistics;
+    PhyInFlight phyInFlight;
     
 public:
     Time TotalSimulationTime;
@@ -17,6 +19,8 @@ public:
     Statistics();
     Statistics(int nrOfNodes);
     NodeStatistics& get(int index);
+    // the frames in flight on the PHY of every node
+    PhyInFlight& getPhyInFlight();
 
     int getNumberOfNodes() const;
 
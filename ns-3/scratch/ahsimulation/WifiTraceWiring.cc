@@ -0,0 +1,54 @@
+#include "WifiTraceWiring.h"
+
+WifiTraceWiring::WifiTraceWiring(Ptr<NetDevice> device, const string& path)
+	: device(DynamicCast<WifiNetDevice>(device)), path(path + "/$ns3::WifiNetDevice") {
+	NS_ASSERT_MSG(this->device != 0, "No wifi device at " << path);
+}
+
+WifiTraceWiring::WifiTraceWiring(Ptr<Node> node, uint32_t deviceIndex)
+	: WifiTraceWiring(node->GetDevice(deviceIndex),
+			"/NodeList/" + std::to_string(node->GetId()) + "/DeviceList/" + std::to_string(deviceIndex)) {
+}
+
+Ptr<WifiNetDevice> WifiTraceWiring::getDevice() const {
+	return device;
+}
+
+void WifiTraceWiring::connect(Ptr<Object> object, const string& objectPath, const string& name, const CallbackBase& sink) {
+	// unlike Config::Connect, a trace source that doesn't exist is not silently skipped
+	if (!object->TraceConnect(name, objectPath + "/" + name, sink))
+		NS_FATAL_ERROR("No trace source " << name << " at " << objectPath);
+}
+
+void WifiTraceWiring::connectWithoutContext(Ptr<Object> object, const string& objectPath, const string& name, const CallbackBase& sink) {
+	if (!object->TraceConnectWithoutContext(name, sink))
+		NS_FATAL_ERROR("No trace source " << name << " at " << objectPath);
+}
+
+void WifiTraceWiring::connectMac(const string& name, const CallbackBase& sink) {
+	connect(device->GetMac(), path + "/Mac", name, sink);
+}
+
+void WifiTraceWiring::connectPhy(const string& name, const CallbackBase& sink) {
+	connect(device->GetPhy(), path + "/Phy", name, sink);
+}
+
+void WifiTraceWiring::connectPhyState(const string& name, const CallbackBase& sink) {
+	PointerValue state;
+	device->GetPhy()->GetAttribute("State", state);
+	connect(state.Get<Object>(), path + "/Phy/State", name, sink);
+}
+
+void WifiTraceWiring::connectRemoteStationManager(const string& name, const CallbackBase& sink) {
+	connect(device->GetRemoteStationManager(), path + "/RemoteStationManager", name, sink);
+}
+
+void WifiTraceWiring::connectPhyWithoutContext(const string& name, const CallbackBase& sink) {
+	connectWithoutContext(device->GetPhy(), path + "/Phy", name, sink);
+}
+
+void WifiTraceWiring::connectPhyStateWithoutContext(const string& name, const CallbackBase& sink) {
+	PointerValue state;
+	device->GetPhy()->GetAttribute("State", state);
+	connectWithoutContext(state.Get<Object>(), path + "/Phy/State", name, sink);
+}
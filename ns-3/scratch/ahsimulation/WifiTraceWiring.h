@@ -0,0 +1,47 @@
+#ifndef WIFITRACEWIRING_H
+#define WIFITRACEWIRING_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include <string>
+
+using namespace std;
+using namespace ns3;
+
+/*
+ * Connects trace sinks straight on the MAC, PHY, PHY state and remote station
+ * manager of a wifi device. Config::Connect parses the path and resolves it
+ * from the root of the NodeList for every single trace source, which makes
+ * the setup of thousands of stations slow. The sinks still get the path of
+ * the trace source as context, like they would with Config::Connect.
+ */
+class WifiTraceWiring {
+
+private:
+	Ptr<WifiNetDevice> device;
+	string path;
+
+	static void connect(Ptr<Object> object, const string& objectPath, const string& name, const CallbackBase& sink);
+	static void connectWithoutContext(Ptr<Object> object, const string& objectPath, const string& name, const CallbackBase& sink);
+
+public:
+	// path is the Config path of the device, e.g. /NodeList/0/DeviceList/0
+	WifiTraceWiring(Ptr<NetDevice> device, const string& path);
+	WifiTraceWiring(Ptr<Node> node, uint32_t deviceIndex = 0);
+
+	Ptr<WifiNetDevice> getDevice() const;
+
+	// sink has the signature of the trace source with a string context in front
+	void connectMac(const string& name, const CallbackBase& sink);
+	void connectPhy(const string& name, const CallbackBase& sink);
+	void connectPhyState(const string& name, const CallbackBase& sink);
+	void connectRemoteStationManager(const string& name, const CallbackBase& sink);
+
+	// sink has the signature of the trace source, for the traces that fire for
+	// every frame, where copying the context into each call would allocate
+	void connectPhyWithoutContext(const string& name, const CallbackBase& sink);
+	void connectPhyStateWithoutContext(const string& name, const CallbackBase& sink);
+};
+
+#endif /* WIFITRACEWIRING_H */
@@ -22,7 +22,6 @@ NS_LOG_COMPONENT_DEFINE ("UdpOnHalow");
 
 int main(int argc, char** argv) {
 
-	PacketMetadata::Enable();
 	TypeId tid = TypeId::LookupByName ("ns3::Ipv6RawSocketFactory");
 	Config::SetDefault ("ns3::TcpL4Protocol::SocketType", StringValue ("ns3::TcpWestwood"));
 	//LogComponentEnable("DcfManager", LOG_LEVEL_DEBUG);
@@ -48,14 +47,21 @@ int main(int argc, char** argv) {
 
     config = Configuration(argc, argv);
 
+    // the sequence number and timestamp of a TCP segment can be anywhere in
+    // the byte stream and are only found by walking the packet metadata
+    if (config.trafficType.compare(0, 3, "tcp") == 0)
+        PacketMetadata::Enable();
+
     while (!calculateParameters(config));
 
     stats = Statistics(config.Nsta);
+    staIndex = StationIndex(config.Nsta);
 
     transmissionsPerTIMGroupAndSlotFromAPSinceLastInterval = vector<long>(config.NGroup * config.NRawSlotNum, 0);
     transmissionsPerTIMGroupAndSlotFromSTASinceLastInterval = vector<long>(config.NGroup * config.NRawSlotNum, 0);
+    slotAirtime = SlotAirtime(config.NGroup, config.NRawSlotNum, config.Nsta);
 
-    eventManager = SimulationEventManager(config.visualizerIP, config.visualizerPort, config.NSSFile);
+    eventManager = SimulationEventManager(config.visualizerIP, config.visualizerPort, config.NSSFile, config.NSSColumnarFile);
 
     RngSeedManager::SetSeed(config.seed);
 
@@ -115,6 +121,9 @@ int main(int argc, char** argv) {
     // configure tracing for associations & other metrics
     configureNodes();
 
+    if (config.warmStart)
+    	S1gWifiMacHelper::PreAssociate(apDevices.Get(0), staDevices);
+
     // configure position of AP
     Ptr<MobilityModel> mobility1 = apNodes.Get(0)->GetObject<MobilityModel>();
     Vector apposition = mobility1->GetPosition();
@@ -147,9 +156,19 @@ int main(int argc, char** argv) {
 
     Simulator::Stop(Seconds(config.simulationTime + config.CoolDownPeriod)); // allow up to a minute after the client & server apps are finished to process the queue
     Simulator::Run();
+    // the energy sources are disposed and the clock is reset by Destroy
+    Time stopTime = Simulator::Now();
+    updateEnergyStatistics();
+    if (lifetimeProjectionStarted && lifetimeProjection.getNumberOfSamples(0) > 0)
+    	reportLifetimeProjection();
     Simulator::Destroy();
 
+    if (isForkCheckpoint)
+    	return (EXIT_SUCCESS); // the forked runs report the statistics
+
     stats.TotalSimulationTime = Seconds(config.simulationTime);
+    if (stoppedByLifetimeProjection)
+    	stats.TotalSimulationTime = stopTime;
 
     printStatistics();
 
@@ -355,18 +374,19 @@ void configureChannel() {
     channel->TraceConnectWithoutContext("Transmission", MakeCallback(&onChannelTransmission));
 }
 
-void onChannelTransmission(Ptr<NetDevice> senderDevice, Ptr<Packet> packet) {
+void onChannelTransmission(Ptr<NetDevice> senderDevice, Ptr<const Packet> packet, Time duration) {
 	int timGroup = currentTIMGroup;
 	int slotIndex = currentRawSlot;
 
-	if(senderDevice->GetAddress() == apDevices.Get(0)->GetAddress()) {
+	if(senderDevice == apDevices.Get(0)) {
 		// from AP
 		transmissionsPerTIMGroupAndSlotFromAPSinceLastInterval[timGroup * config.NRawSlotNum + slotIndex]+= packet->GetSerializedSize();
+		slotAirtime.onTransmission(-1, duration);
 	}
 	else {
 		// from STA
 		transmissionsPerTIMGroupAndSlotFromSTASinceLastInterval[timGroup * config.NRawSlotNum + slotIndex]+= packet->GetSerializedSize();
-
+		slotAirtime.onTransmission(staIndex.find(Mac48Address::ConvertFrom(senderDevice->GetAddress())), duration);
 	}
 }
 
@@ -443,7 +463,14 @@ void configureSTANodes(Ssid& ssid) {
             "ActiveProbing", BooleanValue(false),
 			"MaxMissedBeacons", UintegerValue (10 *config.NGroup),
 			"MaxTimeInQueue", TimeValue(Seconds(config.MaxTimeOfPacketsInQueue)),
-			"RawDuration", TimeValue (MicroSeconds (config.BeaconInterval)));///ami TODO test
+			"RawDuration", TimeValue (MicroSeconds (config.BeaconInterval)),///ami TODO test
+			"RadioWakeUpTime", TimeValue(MicroSeconds(config.RadioWakeUpTime)),
+			"ClockDrift", DoubleValue(config.ClockDrift),
+			"SlotEndGuardTime", TimeValue(MicroSeconds(config.SlotEndGuardTime)));
+    if (config.SlimStaMac) {
+    	// the traffic of the stations isn't tagged with a priority, so it all maps to best effort
+    	mac.SetAccessCategories(std::set<AcIndex> { AC_BE });
+    }
 
     // create wifi
     WifiHelper wifi = WifiHelper::Default();
@@ -456,6 +483,24 @@ void configureSTANodes(Ssid& ssid) {
     staDevices = wifi.Install(phy, mac, staNodes);
     //staDevices4sixlp = wifi.Install(phy, mac, staNodes);
 
+    if (config.EnergyModel) {
+    	cout << "Installing STA Node energy models" << endl;
+    	LiIonEnergySourceHelper battery;
+    	staEnergySources = battery.Install(staNodes);
+
+    	WifiRadioEnergyModelHelper radioEnergy;
+    	radioEnergy.Set("IdleCurrentA", DoubleValue(config.EnergyIdleCurrentA));
+    	radioEnergy.Set("CcaBusyCurrentA", DoubleValue(config.EnergyRxCurrentA));
+    	radioEnergy.Set("RxCurrentA", DoubleValue(config.EnergyRxCurrentA));
+    	radioEnergy.Set("SwitchingCurrentA", DoubleValue(config.EnergyIdleCurrentA));
+    	radioEnergy.Set("SleepCurrentA", DoubleValue(config.EnergySleepCurrentA));
+    	radioEnergy.SetTxCurrentModel("ns3::LinearWifiTxCurrentModel",
+    			"Eta", DoubleValue(config.EnergyTxEfficiency),
+    			"Voltage", DoubleValue(staEnergySources.Get(0)->GetSupplyVoltage()),
+    			"IdleCurrent", DoubleValue(config.EnergyIdleCurrentA));
+    	radioEnergy.Install(staDevices, staEnergySources);
+    }
+
     cout << "Configuring STA Node mobility" << endl;
     // mobility
     MobilityHelper mobility;
@@ -469,82 +514,39 @@ void configureSTANodes(Ssid& ssid) {
     phy.EnablePcap("stafile", staNodes, 0);
 }
 
-void OnAPPhyRxDrop(std::string context, Ptr<const Packet> packet, DropReason reason) {
-	// THIS REQUIRES PACKET METADATA ENABLE!
-	unused (context);
-	auto pCopy = packet->Copy();
-	auto it = pCopy->BeginItem();
-	while(it.HasNext()) {
-
-		auto item = it.Next();
-		Callback<ObjectBase *> constructor = item.tid.GetConstructor ();
-
-		ObjectBase *instance = constructor ();
-		Chunk *chunk = dynamic_cast<Chunk *> (instance);
-		chunk->Deserialize (item.current);
-
-		if(dynamic_cast<WifiMacHeader*>(chunk)) {
-			WifiMacHeader* hdr = (WifiMacHeader*)chunk;
-
-			int staId = -1;
-			if (!config.useV6){
-				for (uint32_t i = 0; i < staNodeInterfaces.GetN(); i++) {
-					if(staNodes.Get(i)->GetDevice(0)->GetAddress() == hdr->GetAddr2()) {
-						staId = i;
-						break;
-					}
-				}
-			}
-			else
-			{
-				for (uint32_t i = 0; i < staNodeInterfaces6.GetN(); i++) {
-					if(staNodes.Get(i)->GetDevice(0)->GetAddress() == hdr->GetAddr2()) {
-						staId = i;
-						break;
-					}
-				}
-			}
-			if(staId != -1) {
-				stats.get(staId).NumberOfDropsByReasonAtAP[reason]++;
-			}
-			delete chunk;
-			break;
-		}
-		else
-			delete chunk;
+void OnAPPhyRxDrop(Ptr<const Packet> packet, DropReason reason, const WifiMacHeader& hdr) {
+	unused(packet);
+	int staId = staIndex.find(hdr.GetAddr2());
+	if(staId != -1) {
+		stats.get(staId).NumberOfDropsByReasonAtAP[reason]++;
 	}
-
-
 }
 
 void OnAPRAWSlotStarted(string context, uint16_t timGroup, uint16_t rawSlot) {
 	unused(context);
 	currentTIMGroup = timGroup;
 	currentRawSlot = rawSlot;
+	slotAirtime.onSlotStarted(timGroup, rawSlot);
+}
+
+void OnAPRAWSlotEnded(string context, uint16_t timGroup, uint16_t rawSlot) {
+	unused(context);
+	slotAirtime.onSlotEnded(timGroup, rawSlot);
+}
+
+void OnAPAssociationThroughput(string context, Time interval, uint32_t nrOfAssocRequests, uint32_t nrOfAssociations, uint32_t nrOfAssociatedStas, uint16_t threshold) {
+	unused(context);
+	if (nrOfAssociations == 0 || interval.IsZero())
+		return;
+	cout << Simulator::Now().GetMilliSeconds() << "ms: " << nrOfAssociations << " of " << nrOfAssocRequests << " association requests succeeded ("
+			<< (nrOfAssociations / interval.GetSeconds()) << " assoc/s), " << nrOfAssociatedStas << " stations associated, threshold " << threshold << endl;
 }
 
 void OnAPPacketToTransmitReceived(string context, Ptr<const Packet> packet, Mac48Address to, bool isScheduled, bool isDuringSlotOfSTA, Time timeLeftInSlot) {
 	unused(context);
 	unused(packet);
 	unused(isDuringSlotOfSTA);
-	int staId = -1;
-	if (!config.useV6){
-		for (uint32_t i = 0; i < staNodeInterfaces.GetN(); i++) {
-			if(staNodes.Get(i)->GetDevice(0)->GetAddress() == to) {
-				staId = i;
-				break;
-			}
-		}
-	}
-	else
-	{
-		for (uint32_t i = 0; i < staNodeInterfaces6.GetN(); i++) {
-			if(staNodes.Get(i)->GetDevice(0)->GetAddress() == to) {
-				staId = i;
-				break;
-			}
-		}
-	}
+	int staId = staIndex.find(to);
 	if(staId != -1) {
 		if(isScheduled)
 			stats.get(staId).NumberOfAPScheduledPacketForNodeInNextSlot++;
@@ -602,6 +604,9 @@ void configureAPNode (Ssid& ssid) {
     //wifi.EnableLogComponents();
 
     apDevices = wifi.Install(phy, mac, apNodes);
+    Ptr<WifiMac> apMac = DynamicCast<WifiNetDevice>(apDevices.Get(0))->GetMac();
+    apMac->SetAttribute("DistributedAuthentication", BooleanValue(config.DistributedAuthentication));
+    apMac->SetAttribute("PsPollDelivery", BooleanValue(config.PsPoll));
 
     MobilityHelper mobilityAp;
     Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
@@ -610,9 +615,12 @@ void configureAPNode (Ssid& ssid) {
     mobilityAp.SetMobilityModel("ns3::ConstantPositionMobilityModel");
     mobilityAp.Install(apNodes);
 
-	Config::Connect("/NodeList/" + std::to_string(config.Nsta) + "/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyRxDropWithReason", MakeCallback(&OnAPPhyRxDrop));
-	Config::Connect("/NodeList/" + std::to_string(config.Nsta) + "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::S1gApWifiMac/PacketToTransmitReceivedFromUpperLayer", MakeCallback(&OnAPPacketToTransmitReceived));
-	Config::Connect("/NodeList/" + std::to_string(config.Nsta) + "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::S1gApWifiMac/RAWSlotStarted", MakeCallback(&OnAPRAWSlotStarted));
+	WifiTraceWiring apTraces(apNodes.Get(0));
+	apTraces.connectPhyWithoutContext("PhyRxDropWithReason", MakeCallback(&OnAPPhyRxDrop));
+	apTraces.connectMac("PacketToTransmitReceivedFromUpperLayer", MakeCallback(&OnAPPacketToTransmitReceived));
+	apTraces.connectMac("RAWSlotStarted", MakeCallback(&OnAPRAWSlotStarted));
+	apTraces.connectMac("RAWSlotEnded", MakeCallback(&OnAPRAWSlotEnded));
+	apTraces.connectMac("AssociationThroughput", MakeCallback(&OnAPAssociationThroughput));
 
 	if(config.APPcapFile != "") {
 		//phy.EnablePcap(config.APPcapFile, apNodes, 0);
@@ -632,6 +640,8 @@ void configureIPStack() {
     	address.SetBase("192.168.0.0", "255.255.0.0");
     	staNodeInterfaces = address.Assign(staDevices);
     	apNodeInterfaces = address.Assign(apDevices);
+    	for (uint32_t i = 0; i < staNodeInterfaces.GetN(); i++)
+    		staIndex.add(i, staNodeInterfaces.GetAddress(i));
 #ifdef COAP_SIM
     	address.SetBase("169.200.0.0", "255.255.0.0");
         externalInterfaces = address.Assign (externalDevices);
@@ -651,6 +661,8 @@ void configureIPStack() {
 
         staNodeInterfaces6 = address6.Assign(sixStaDevices);
         apNodeInterfaces6 = address6.Assign(sixApDevices);
+        for (uint32_t i = 0; i < staNodeInterfaces6.GetN(); i++)
+        	staIndex.add(i, staNodeInterfaces6.GetAddress(i, 0));
         //TODO routing doesnt work with ipv6 here
 
     	/*std::cout << "    AP     --IPv6: " << apNodeInterfaces6.GetAddress(0, 0) << "  --MAC: " 	<< Mac48Address::ConvertFrom(sixApDevices.Get(0)->GetAddress())
@@ -673,72 +685,64 @@ void configureIPStack() {
 
 void configureNodes() {
 	cout << "Configuring STA Node trace sources" << endl;
+	auto setupStart = std::chrono::steady_clock::now();
 
     for (uint32_t i = 0; i < config.Nsta; i++) {
 
     	cout << "Hooking up trace sources for STA " << i << endl;
 
         NodeEntry* n = new NodeEntry(i, &stats, staNodes.Get(i), staDevices.Get(i));
+        staIndex.add(i, Mac48Address::ConvertFrom(staDevices.Get(i)->GetAddress()));
 
         n->SetAssociatedCallback([ = ]{onSTAAssociated(i);});
         n->SetDeassociatedCallback([ = ]{onSTADeassociated(i);});
 
         nodes.push_back(n);
+        WifiTraceWiring traces(staNodes.Get(i));
         // hook up Associated and Deassociated events
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/Assoc", MakeCallback(&NodeEntry::SetAssociation, n));
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/DeAssoc", MakeCallback(&NodeEntry::UnsetAssociation, n));
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/NrOfTransmissionsDuringRAWSlot", MakeCallback(&NodeEntry::OnNrOfTransmissionsDuringRAWSlotChanged, n));
+        traces.connectMac("Assoc", MakeCallback(&NodeEntry::SetAssociation, n));
+        traces.connectMac("DeAssoc", MakeCallback(&NodeEntry::UnsetAssociation, n));
+        traces.connectMac("NrOfTransmissionsDuringRAWSlot", MakeCallback(&NodeEntry::OnNrOfTransmissionsDuringRAWSlotChanged, n));
 
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/S1gBeaconMissed", MakeCallback(&NodeEntry::OnS1gBeaconMissed, n));
+        traces.connectMac("S1gBeaconMissed", MakeCallback(&NodeEntry::OnS1gBeaconMissed, n));
+        traces.connectMac("WakeUpGuard", MakeCallback(&NodeEntry::OnWakeUpGuard, n));
 
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/PacketDropped", MakeCallback(&NodeEntry::OnMacPacketDropped, n));
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/Collision", MakeCallback(&NodeEntry::OnCollision, n));
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/TransmissionWillCrossRAWBoundary", MakeCallback(&NodeEntry::OnTransmissionWillCrossRAWBoundary, n));
+        traces.connectMac("PacketDropped", MakeCallback(&NodeEntry::OnMacPacketDropped, n));
+        traces.connectMac("Collision", MakeCallback(&NodeEntry::OnCollision, n));
+        traces.connectMac("TransmissionWillCrossRAWBoundary", MakeCallback(&NodeEntry::OnTransmissionWillCrossRAWBoundary, n));
 
 
         // hook up TX
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyTxBegin", MakeCallback(&NodeEntry::OnPhyTxBegin, n));
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyTxEnd", MakeCallback(&NodeEntry::OnPhyTxEnd, n));
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyTxDropWithReason", MakeCallback(&NodeEntry::OnPhyTxDrop, n));
+        traces.connectPhyWithoutContext("PhyTxBegin", MakeCallback(&NodeEntry::OnPhyTxBegin, n));
+        traces.connectPhyWithoutContext("PhyTxEnd", MakeCallback(&NodeEntry::OnPhyTxEnd, n));
+        traces.connectPhyWithoutContext("PhyTxDropWithReason", MakeCallback(&NodeEntry::OnPhyTxDrop, n));
 
         // hook up RX
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyRxBegin", MakeCallback(&NodeEntry::OnPhyRxBegin, n));
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyRxEnd", MakeCallback(&NodeEntry::OnPhyRxEnd, n));
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyRxDropWithReason", MakeCallback(&NodeEntry::OnPhyRxDrop, n));
+        traces.connectPhyWithoutContext("PhyRxBegin", MakeCallback(&NodeEntry::OnPhyRxBegin, n));
+        traces.connectPhyWithoutContext("PhyRxEnd", MakeCallback(&NodeEntry::OnPhyRxEnd, n));
+        traces.connectPhyWithoutContext("PhyRxDropWithReason", MakeCallback(&NodeEntry::OnPhyRxDrop, n));
 
 
         // hook up MAC traces
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/RemoteStationManager/MacTxRtsFailed", MakeCallback(&NodeEntry::OnMacTxRtsFailed, n));
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/RemoteStationManager/MacTxDataFailed", MakeCallback(&NodeEntry::OnMacTxDataFailed, n));
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/RemoteStationManager/MacTxFinalRtsFailed", MakeCallback(&NodeEntry::OnMacTxFinalRtsFailed, n));
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/RemoteStationManager/MacTxFinalDataFailed", MakeCallback(&NodeEntry::OnMacTxFinalDataFailed, n));
+        traces.connectRemoteStationManager("MacTxRtsFailed", MakeCallback(&NodeEntry::OnMacTxRtsFailed, n));
+        traces.connectRemoteStationManager("MacTxDataFailed", MakeCallback(&NodeEntry::OnMacTxDataFailed, n));
+        traces.connectRemoteStationManager("MacTxFinalRtsFailed", MakeCallback(&NodeEntry::OnMacTxFinalRtsFailed, n));
+        traces.connectRemoteStationManager("MacTxFinalDataFailed", MakeCallback(&NodeEntry::OnMacTxFinalDataFailed, n));
 
         // hook up PHY State change
-        Config::Connect("/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/Phy/State/State", MakeCallback(&NodeEntry::OnPhyStateChange, n));
+        traces.connectPhyStateWithoutContext("State", MakeCallback(&NodeEntry::OnPhyStateChange, n));
 
     }
+    std::chrono::duration<double> setupTime = std::chrono::steady_clock::now() - setupStart;
+    cout << "Hooked up the trace sources of " << config.Nsta << " STA nodes in " << setupTime.count() << "s" << endl;
 }
 
 int getSTAIdFromAddress(Ipv4Address from) {
-    int staId = -1;
-    for (uint32_t i = 0; i < staNodeInterfaces.GetN(); i++) {
-        if (staNodeInterfaces.GetAddress(i) == from) {
-            staId = i;
-            break;
-        }
-    }
-    return staId;
+    return staIndex.find(from);
 }
 
 int getSTAIdFromAddress(Ipv6Address from) {
-    int staId = -1;
-    for (uint32_t i = 0; i < staNodeInterfaces6.GetN(); i++) {
-        if (staNodeInterfaces6.GetAddress(i,0) == from) {
-            staId = i;
-            break;
-        }
-    }
-    return staId;
+    return staIndex.find(from);
 }
 
 void udpPacketReceivedAtServer(Ptr<const Packet> packet, Address from) {
@@ -1239,22 +1243,26 @@ void configureCoapClientHelper(CoapClientHelper& clientHelper, uint32_t n)
 }
 
 void onSTAAssociated(int i) {
-    nodes[i]->rawGroupNumber = ((nodes[i]->aId - 1) / (config.NRawSta / config.NGroup));
+    nodes[i]->rawGroupNumber = S1gStrategy().GetTIMGroupFromAID(nodes[i]->aId, config.NRawSta / config.NGroup);
     nodes[i]->rawSlotIndex = nodes[i]->aId % config.NRawSlotNum;
 	cout << "Node " << std::to_string(i) << " is associated and has aId " << nodes[i]->aId << " and falls in RAW group " << std::to_string(nodes[i]->rawGroupNumber) << endl;
     eventManager.onNodeAssociated(*nodes[i]);
 
-    uint32_t nrOfSTAAssociated (0);
-    for (uint32_t i = 0; i < config.Nsta; i++) {
-        if (nodes[i]->isAssociated)
-            nrOfSTAAssociated++;
-    }
-
-    if (nrOfSTAAssociated == config.Nsta) {
+    staIndex.setAssociated(i);
+    if (staIndex.isEveryStationAssociated()) {
     	cout << "All stations associated, configuring clients & server" << endl;
         // association complete, start sending packets
     	stats.TimeWhenEverySTAIsAssociated = Simulator::Now();
 
+    	if (config.forkVariants != "" && forkTrafficVariants())
+    		return;
+
+    	if (config.LifetimeProjection && !lifetimeProjectionScheduled) {
+    		// the first window lets the traffic settle
+    		lifetimeProjectionScheduled = true;
+    		Simulator::Schedule(getLifetimeProjectionWindow(), &startLifetimeProjection);
+    	}
+
     	if(config.trafficType == "udp") {
     		configureUDPServer();
     		configureUDPClients();
@@ -1291,7 +1299,64 @@ void onSTAAssociated(int i) {
     }
 }
 
+/*
+ * Fork a process per variant of config.forkVariants, every child continues the
+ * simulation from here (event queue, node state, random streams and statistics
+ * are copied by fork) with its own traffic settings. Returns true in the parent,
+ * which only waits for the children and stops.
+ */
+bool forkTrafficVariants() {
+	vector<string> variants;
+	std::stringstream stream(config.forkVariants);
+	string variant;
+	while (std::getline(stream, variant, ';'))
+		variants.push_back(variant);
+
+	// the children copy the nss file and can't use the I/O thread of the parent
+	eventManager.flush();
+
+	uint32_t running = 0;
+	for (uint32_t i = 0; i < variants.size(); i++) {
+		if (running >= max(config.forkMaxParallel, 1u)) {
+			wait(NULL);
+			running--;
+		}
+
+		cout.flush();
+		pid_t pid = fork();
+		if (pid == -1)
+			NS_FATAL_ERROR("Could not fork the run of variant " << variants[i]);
+
+		if (pid == 0) {
+			config.forkVariants = "";
+			config.Apply(variants[i]);
+			cout << "Forked run " << i << ": " << variants[i] << endl;
+
+			auto forkFile = [i](string file, string extension) {
+				return file.substr(0, file.rfind(extension)) + "_fork" + std::to_string(i) + extension;
+			};
+			eventManager.onForked(forkFile(config.NSSFile, ".nss"), forkFile(config.NSSColumnarFile, ".nsc"));
+
+			// the AP settings that can be swept
+			Ptr<WifiMac> apMac = DynamicCast<WifiNetDevice>(apDevices.Get(0))->GetMac();
+			apMac->SetAttribute("ScheduleTransmissionForNextSlotIfLessThan", TimeValue(MicroSeconds(config.APScheduleTransmissionForNextSlotIfLessThan)));
+			apMac->SetAttribute("AlwaysScheduleForNextSlot", BooleanValue(config.APAlwaysSchedulesForNextSlot));
+			return false;
+		}
+		running++;
+	}
+	while (running > 0) {
+		wait(NULL);
+		running--;
+	}
+
+	isForkCheckpoint = true;
+	Simulator::Stop();
+	return true;
+}
+
 void onSTADeassociated(int i) {
+	staIndex.setDeassociated(i);
 	eventManager.onNodeDeassociated(*nodes[i]);
 }
 
@@ -1323,6 +1388,14 @@ void printStatistics() {
 			cout << "Total active time: " << std::to_string(stats.get(i).TotalActiveTime.GetMilliSeconds()) << "ms" << endl;
 			cout << "Total doze time: " << std::to_string(stats.get(i).TotalDozeTime.GetMilliSeconds()) << "ms" << endl;
 			cout << "" << endl;
+			if (config.EnergyModel) {
+				cout << "Energy consumed: " << stats.get(i).EnergyConsumedJ << "J" << endl;
+				cout << "Average power: " << stats.get(i).getAveragePowerMilliWatt() << "mW" << endl;
+				cout << "Energy spent waking up early: " << stats.get(i).EarlyWakeEnergyJ << "J over " << std::to_string(stats.get(i).NumberOfWakeUps) << " wake ups" << endl;
+				cout << "Largest early wake up: " << std::to_string(stats.get(i).MaxEarlyWakeTime.GetMicroSeconds()) << "µs" << endl;
+				cout << "Battery remaining: " << stats.get(i).EnergyRemainingJ << "J" << endl;
+				cout << "" << endl;
+			}
 			cout << "Number of transmissions: " << std::to_string(stats.get(i).NumberOfTransmissions) << endl;
 			cout << "Number of transmissions dropped: " << std::to_string(stats.get(i).NumberOfTransmissionsDropped) << endl;
 			cout << "Number of receives: " << std::to_string(stats.get(i).NumberOfReceives) << endl;
@@ -1338,6 +1411,7 @@ void printStatistics() {
 			cout << "IP Camera Data sending rate: " << stats.get(i).getIPCameraSendingRate() << "kbps" << std::endl;
 			cout << "IP Camera Data receiving rate: " << std::to_string(stats.get(i).getIPCameraAPReceivingRate()) << "kbps" << std::endl;
 			cout << endl;
+			cout << "    Latency " << formatLatencyPercentiles(stats.get(i).PacketLatency) << endl;
 			cout << "    global max Latency (C->S)= " << std::to_string(NodeEntry::maxLatency.GetMicroSeconds()) << "µs" << endl; // CORRECT
 			cout << "    global min Latency (C->S) = " << std::to_string(NodeEntry::minLatency.GetMicroSeconds()) << "µs" << endl; // CORRECT
 			cout << "    max diference in RTT between 2 subsequent packets = " << std::to_string(NodeEntry::maxJitter.GetMicroSeconds()) << "µs" << endl;
@@ -1347,6 +1421,8 @@ void printStatistics() {
 			cout << "    Inter-packet-delay at the server standard deviation is " << stats.get(i).GetInterPacketDelayDeviation(stats.get(i).m_interPacketDelayServer) << " which is " << stats.get(i).GetInterPacketDelayDeviationPercentage(stats.get(i).m_interPacketDelayServer) << "%" <<endl;
 			cout << "    Average inter packet delay at client is " << std::to_string(stats.get(i).GetAverageInterPacketDelay(stats.get(i).m_interPacketDelayClient).GetMicroSeconds()) << "µs" << endl;
 			cout << "    Inter-packet-delay at the client standard deviation is " << stats.get(i).GetInterPacketDelayDeviation(stats.get(i).m_interPacketDelayClient) << " which is " << stats.get(i).GetInterPacketDelayDeviationPercentage(stats.get(i).m_interPacketDelayClient) << "%" <<endl;
+			cout << "    Inter-packet-delay percentiles (p50/p99) at the server " << std::to_string(stats.get(i).m_interPacketDelayServer.getPercentile(50).GetMicroSeconds()) << "/" << std::to_string(stats.get(i).m_interPacketDelayServer.getPercentile(99).GetMicroSeconds())
+				<< "µs and at the client " << std::to_string(stats.get(i).m_interPacketDelayClient.getPercentile(50).GetMicroSeconds()) << "/" << std::to_string(stats.get(i).m_interPacketDelayClient.getPercentile(99).GetMicroSeconds()) << "µs" << endl;
 			//calculate the deviation between inter packet arrival times at the server
 			cout << "    Reliability " << std::to_string(stats.get(i).GetReliability()) << "%" << endl; //CORRECT
 
@@ -1368,11 +1444,159 @@ void printStatistics() {
 		}
 
 	}
+
+	printLatencySummary();
+	printSlotAirtime();
+}
+
+string formatLatencyPercentiles(const LogLinearHistogram& latency) {
+	if (latency.getCount() == 0)
+		return "-";
+	return "p50 " + std::to_string(latency.getPercentile(50)) + "µs"
+		+ ", p95 " + std::to_string(latency.getPercentile(95)) + "µs"
+		+ ", p99 " + std::to_string(latency.getPercentile(99)) + "µs"
+		+ ", p99.9 " + std::to_string(latency.getPercentile(99.9)) + "µs"
+		+ " of " + std::to_string(latency.getCount()) + " packets";
+}
+
+void printLatencySummary() {
+	// the histograms of the stations merged per TIM group and RAW slot they are in
+	map<pair<int, int>, LogLinearHistogram> latencyPerSlot;
+	LogLinearHistogram latency(5);
+	for (uint32_t i = 0; i < config.Nsta; i++) {
+		if (nodes[i]->m_nodeType != NodeEntry::CLIENT || stats.get(i).PacketLatency.getCount() == 0)
+			continue;
+		auto slot = make_pair((int)nodes[i]->rawGroupNumber, (int)nodes[i]->rawSlotIndex);
+		latencyPerSlot.emplace(slot, LogLinearHistogram(5)).first->second.merge(stats.get(i).PacketLatency);
+		latency.merge(stats.get(i).PacketLatency);
+	}
+
+	cout << "Latency summary" << endl;
+	cout << "---------------" << endl;
+	for (auto& pair : latencyPerSlot)
+		cout << "TIM group " << pair.first.first << ", RAW slot " << pair.first.second << ": " << formatLatencyPercentiles(pair.second) << endl;
+	cout << "Network: " << formatLatencyPercentiles(latency) << endl;
+}
+
+void printSlotAirtime() {
+	cout << "RAW slot airtime" << endl;
+	cout << "----------------" << endl;
+	for (uint32_t group = 0; group < config.NGroup; group++) {
+		for (uint32_t slot = 0; slot < config.NRawSlotNum; slot++) {
+			const SlotAirtime::Slot& s = slotAirtime.get(group, slot);
+			if (s.occurrences == 0)
+				continue;
+			double active = s.active.GetSeconds();
+			auto percentage = [active](Time t) { return std::to_string(active > 0 ? 100 * t.GetSeconds() / active : 0) + "%"; };
+			cout << "TIM group " << group << ", RAW slot " << slot << ": " << s.occurrences << " times for " << s.active.GetMilliSeconds() << "ms"
+					<< ", busy " << percentage(s.busy) << ", successful " << percentage(s.successful) << ", collision " << percentage(s.collision)
+					<< ", idle " << percentage(s.getIdle())
+					<< ", contending stations " << s.getAverageContendingStations() << " on average and " << s.maxContendingStations << " at most" << endl;
+		}
+	}
+}
+
+void updateEnergyStatistics() {
+	if (staEnergySources.GetN() == 0)
+		return;
+
+	for (uint32_t i = 0; i < config.Nsta; i++) {
+		Ptr<EnergySource> source = staEnergySources.Get(i);
+		NodeStatistics& s = stats.get(i);
+		// GetRemainingEnergy brings the source up to date with the current state of the radio
+		s.EnergyRemainingJ = source->GetRemainingEnergy();
+		s.EnergyConsumedJ = source->GetInitialEnergy() - s.EnergyRemainingJ;
+		s.EnergyMeasuredTime = Simulator::Now();
+		s.EarlyWakeEnergyJ = s.TotalEarlyWakeTime.GetSeconds() * config.EnergyIdleCurrentA * source->GetSupplyVoltage();
+	}
+}
+
+double getConsumedEnergy(uint32_t i) {
+	if (staEnergySources.GetN() > 0) {
+		Ptr<EnergySource> source = staEnergySources.Get(i);
+		return source->GetInitialEnergy() - source->GetRemainingEnergy();
+	}
+	// without the energy model the radio draws the idle current whenever it is not dozing
+	return (stats.get(i).TotalActiveTime.GetSeconds() * config.EnergyIdleCurrentA
+			+ stats.get(i).TotalDozeTime.GetSeconds() * config.EnergySleepCurrentA) * defaultBattery->GetSupplyVoltage();
+}
+
+double getRemainingEnergy(uint32_t i) {
+	if (staEnergySources.GetN() > 0)
+		return staEnergySources.Get(i)->GetRemainingEnergy();
+	return defaultBattery->GetInitialEnergy() - getConsumedEnergy(i);
+}
+
+Time getLifetimeProjectionWindow() {
+	// whole DTIM cycles spanning at least one traffic interval
+	uint64_t dtimCycle = (uint64_t)config.BeaconInterval * config.NGroup;
+	uint64_t trafficInterval = (uint64_t)config.trafficInterval * 1000;
+	uint64_t nrOfCycles = max((trafficInterval + dtimCycle - 1) / dtimCycle, (uint64_t)1);
+	return MicroSeconds(nrOfCycles * dtimCycle);
+}
+
+void startLifetimeProjection() {
+	if (staEnergySources.GetN() == 0)
+		defaultBattery = CreateObject<LiIonEnergySource>(); // a fresh battery with the default Li-ion parameters
+	lifetimeProjection = LifetimeProjection(config.Nsta, config.LifetimeProjectionPrecision, config.LifetimeProjectionMinSamples);
+	lifetimeProjectionStarted = true;
+	energyAtLastLifetimeSample.clear();
+	for (uint32_t i = 0; i < config.Nsta; i++)
+		energyAtLastLifetimeSample.push_back(getConsumedEnergy(i));
+
+	Time window = getLifetimeProjectionWindow();
+	cout << "Projecting battery lifetime from windows of " << window.GetMilliSeconds() << "ms" << endl;
+	Simulator::Schedule(window, &sampleLifetimeProjection, window);
+}
+
+void sampleLifetimeProjection(Time window) {
+	for (uint32_t i = 0; i < config.Nsta; i++) {
+		double energy = getConsumedEnergy(i);
+		lifetimeProjection.addSample(i, energy - energyAtLastLifetimeSample[i], window);
+		energyAtLastLifetimeSample[i] = energy;
+	}
+
+	if (lifetimeProjection.hasConverged()) {
+		cout << "Lifetime projection of every station converged after " << lifetimeProjection.getNumberOfSamples(0) << " windows, stopping the simulation" << endl;
+		stoppedByLifetimeProjection = true;
+		Simulator::Stop();
+	}
+	else
+		Simulator::Schedule(window, &sampleLifetimeProjection, window);
+}
+
+void reportLifetimeProjection() {
+	cout << "Battery lifetime projection" << endl;
+	cout << "---------------------------" << endl;
+
+	eventManager.onLifetimeProjectionHeader();
+	int firstDepleted = -1;
+	Time networkLifetime = Time::Max();
+	for (uint32_t i = 0; i < config.Nsta; i++) {
+		double remaining = getRemainingEnergy(i);
+		eventManager.onLifetimeProjection(i, lifetimeProjection, remaining);
+
+		Time lifetime = lifetimeProjection.getLifetime(i, remaining);
+		cout << "Node " << std::to_string(i) << ": " << lifetimeProjection.getAveragePower(i) * 1000 << "mW (+/- " << lifetimeProjection.getAveragePowerHalfWidth(i) * 1000 << "mW) over "
+				<< lifetimeProjection.getNumberOfSamples(i) << " windows, lifetime " << lifetime.GetSeconds() / 86400 << " days ["
+				<< lifetimeProjection.getLifetimeLowerBound(i, remaining).GetSeconds() / 86400 << ", "
+				<< lifetimeProjection.getLifetimeUpperBound(i, remaining).GetSeconds() / 86400 << "]"
+				<< (lifetimeProjection.hasConverged(i) ? "" : " (not converged)") << endl;
+		if (lifetime < networkLifetime) {
+			networkLifetime = lifetime;
+			firstDepleted = i;
+		}
+	}
+	if (firstDepleted != -1)
+		cout << "Network lifetime (first battery depleted): " << networkLifetime.GetSeconds() / 86400 << " days, node " << firstDepleted << endl;
+	cout << endl;
 }
 
 void sendStatistics(bool schedule) {
+	updateEnergyStatistics();
 	eventManager.onUpdateStatistics(stats);
 	eventManager.onUpdateSlotStatistics(transmissionsPerTIMGroupAndSlotFromAPSinceLastInterval, transmissionsPerTIMGroupAndSlotFromSTASinceLastInterval);
+	eventManager.onUpdateSlotAirtime(slotAirtime);
 	// reset
 	transmissionsPerTIMGroupAndSlotFromAPSinceLastInterval = vector<long>(config.NGroup * config.NRawSlotNum, 0);
 	transmissionsPerTIMGroupAndSlotFromSTASinceLastInterval = vector<long>(config.NGroup * config.NRawSlotNum, 0);
@@ -13,8 +13,10 @@
 
 #include "ns3/internet-module.h"
 #include "ns3/extension-headers.h"
+#include "ns3/s1g-strategy.h"
 //#include "ns3/csma-module.h"
 #include "ns3/point-to-point-module.h"
+#include "ns3/energy-module.h"
 
 #include "ns3/nstime.h"
 #include <iostream>
@@ -25,7 +27,10 @@
 #include <cstring>
 #include <fstream>
 #include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <vector>
+#include <chrono>
 
 
 #include "Helper.h"
@@ -33,6 +38,10 @@
 #include "NodeEntry.h"
 #include "SimpleTCPClient.h"
 #include "Statistics.h"
+#include "LifetimeProjection.h"
+#include "StationIndex.h"
+#include "SlotAirtime.h"
+#include "WifiTraceWiring.h"
 #include "SimulationEventManager.h"
 
 #include "TCPPingPongClient.h"
@@ -76,14 +85,34 @@ Ipv6InterfaceContainer externalInterfaces6;
 
 ApplicationContainer serverApp;
 
+// battery of every station, empty when config.EnergyModel is off
+EnergySourceContainer staEnergySources;
+// the battery the lifetime projection assumes for every station when config.EnergyModel is off
+Ptr<LiIonEnergySource> defaultBattery;
+
+LifetimeProjection lifetimeProjection;
+vector<double> energyAtLastLifetimeSample;
+bool lifetimeProjectionScheduled = false;
+bool lifetimeProjectionStarted = false;
+bool stoppedByLifetimeProjection = false;
+
 vector<NodeEntry*> nodes;
 
+// resolves the addresses of the stations and counts the associated ones
+StationIndex staIndex;
+
 vector<long> transmissionsPerTIMGroupAndSlotFromAPSinceLastInterval;
 vector<long> transmissionsPerTIMGroupAndSlotFromSTASinceLastInterval;
 
 uint16_t currentTIMGroup = 0;
 uint16_t currentRawSlot = 0;
 
+// busy, successful, collision and idle airtime per TIM group and RAW slot
+SlotAirtime slotAirtime;
+
+// true in the process that forked the runs of config.forkVariants
+bool isForkCheckpoint = false;
+
 void autoSetNRawSlotCount (Configuration& config);
 bool calculateParameters (Configuration& config);
 
@@ -131,10 +160,22 @@ void wireTCPClient(ApplicationContainer clientApp, int i);
 void onSTAAssociated(int i);
 void onSTADeassociated(int i);
 
-void onChannelTransmission(Ptr<NetDevice> senderDevice, Ptr<Packet> packet);
+bool forkTrafficVariants();
+
+void onChannelTransmission(Ptr<NetDevice> senderDevice, Ptr<const Packet> packet, Time duration);
 
 void updateNodesQueueLength();
 
+void updateEnergyStatistics();
+
+double getConsumedEnergy(uint32_t i);
+double getRemainingEnergy(uint32_t i);
+
+Time getLifetimeProjectionWindow();
+void startLifetimeProjection();
+void sampleLifetimeProjection(Time window);
+void reportLifetimeProjection();
+
 
 int getSTAIdFromAddress(Ipv4Address from);
 int getSTAIdFromAddress(Ipv6Address from);
@@ -142,6 +183,9 @@ int getSTAIdFromAddress(Ipv6Address from);
 int main(int argc, char** argv);
 
 void printStatistics();
+string formatLatencyPercentiles(const LogLinearHistogram& latency);
+void printLatencySummary();
+void printSlotAirtime();
 
 void sendStatistics(bool schedule);
 
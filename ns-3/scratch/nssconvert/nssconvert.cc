@@ -0,0 +1,35 @@
+/*
+ * Converts a columnar nss file (.nsc) written by ahsimulation with the
+ * NSSColumnarFile option to the text nss format, so the visualizer and the
+ * analysis scripts can read it:
+ *
+ *   ./waf --run "nssconvert test.nsc test.nss"
+ */
+
+#include "../ahsimulation/NssColumnar.h"
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char** argv) {
+	if (argc != 3) {
+		std::cerr << "Usage: nssconvert input.nsc output.nss" << std::endl;
+		return 1;
+	}
+
+	std::ifstream in(argv[1], std::ios::binary);
+	if (!in.is_open()) {
+		std::cerr << "Unable to open " << argv[1] << std::endl;
+		return 1;
+	}
+	std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+	if (!out.is_open()) {
+		std::cerr << "Unable to create " << argv[2] << std::endl;
+		return 1;
+	}
+
+	if (!nsscolumnar::convertToText(in, out)) {
+		std::cerr << argv[1] << " is not a valid columnar nss file or is truncated" << std::endl;
+		return 1;
+	}
+	return 0;
+}
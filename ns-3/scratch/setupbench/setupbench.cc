@@ -0,0 +1,143 @@
+/*
+ * Measures the setup cost of a simulation with many stations: the time it
+ * takes to install the S1G station devices and the memory they take, with
+ * every EDCA queue in the MAC of the stations or only the best effort one
+ * (the SlimStaMac option of ahsimulation):
+ *
+ *   ./waf --run "setupbench --Nsta=4000 --SlimStaMac=true"
+ *
+ * The memory is the growth of the resident set while installing, so it
+ * includes the PHY, the remote station manager and the device of a station.
+ *
+ * With TraceConnect it also times connecting the per station trace sinks of
+ * configureNodes, either with Config::Connect or with WifiTraceWiring:
+ *
+ *   ./waf --run "setupbench --Nsta=1000 --TraceConnect=Config"
+ *   ./waf --run "setupbench --Nsta=8000 --TraceConnect=WifiTraceWiring"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include "../ahsimulation/WifiTraceWiring.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+using namespace ns3;
+
+// resident set size in bytes
+static long getResidentSize() {
+	std::ifstream statm("/proc/self/statm");
+	long size = 0;
+	long resident = 0;
+	statm >> size >> resident;
+	return resident * sysconf(_SC_PAGESIZE);
+}
+
+static double getSecondsSince(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void onAddress(string context, Mac48Address address) {
+}
+
+static void onPacket(string context, Ptr<const Packet> packet) {
+}
+
+static void onState(string context, Time start, Time duration, WifiPhy::State state) {
+}
+
+static void onRawSlotTransmissions(string context, uint16_t successful, uint16_t failed) {
+}
+
+static const char* phyTraces[] = { "PhyTxBegin", "PhyTxEnd", "PhyRxBegin", "PhyRxEnd" };
+static const char* remoteStationManagerTraces[] = { "MacTxRtsFailed", "MacTxDataFailed", "MacTxFinalRtsFailed", "MacTxFinalDataFailed" };
+
+// the 14 trace sources configureNodes connects per station, resolving every path from the root
+static void connectWithConfig(uint32_t i) {
+	string device = "/NodeList/" + std::to_string(i) + "/DeviceList/0/$ns3::WifiNetDevice/";
+	string mac = device + "Mac/$ns3::RegularWifiMac/$ns3::StaWifiMac/";
+	Config::Connect(mac + "Assoc", MakeCallback(&onAddress));
+	Config::Connect(mac + "DeAssoc", MakeCallback(&onAddress));
+	Config::Connect(mac + "NrOfTransmissionsDuringRAWSlot", MakeCallback(&onRawSlotTransmissions));
+	for (const char* name : phyTraces)
+		Config::Connect(device + "Phy/" + name, MakeCallback(&onPacket));
+	for (const char* name : remoteStationManagerTraces)
+		Config::Connect(device + "RemoteStationManager/" + name, MakeCallback(&onAddress));
+	Config::Connect(device + "Phy/State/State", MakeCallback(&onState));
+}
+
+// the same trace sources connected straight on the objects of the device
+static void connectWithWiring(Ptr<Node> node) {
+	WifiTraceWiring wiring(node);
+	wiring.connectMac("Assoc", MakeCallback(&onAddress));
+	wiring.connectMac("DeAssoc", MakeCallback(&onAddress));
+	wiring.connectMac("NrOfTransmissionsDuringRAWSlot", MakeCallback(&onRawSlotTransmissions));
+	for (const char* name : phyTraces)
+		wiring.connectPhy(name, MakeCallback(&onPacket));
+	for (const char* name : remoteStationManagerTraces)
+		wiring.connectRemoteStationManager(name, MakeCallback(&onAddress));
+	wiring.connectPhyState("State", MakeCallback(&onState));
+}
+
+int main(int argc, char** argv) {
+	uint32_t Nsta = 2000;
+	bool SlimStaMac = false;
+	string TraceConnect = "";
+
+	CommandLine cmd;
+	cmd.AddValue("Nsta", "Number of stations", Nsta);
+	cmd.AddValue("SlimStaMac", "Only create the best effort EDCA queue in the MAC of the stations (true/false)", SlimStaMac);
+	cmd.AddValue("TraceConnect", "Also connect the trace sinks of every station with Config or WifiTraceWiring", TraceConnect);
+	cmd.Parse(argc, argv);
+	if (TraceConnect != "" && TraceConnect != "Config" && TraceConnect != "WifiTraceWiring") {
+		std::cerr << "TraceConnect is either Config or WifiTraceWiring" << std::endl;
+		return 1;
+	}
+
+	NodeContainer staNodes;
+	staNodes.Create(Nsta);
+
+	YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
+	YansWifiPhyHelper phy = YansWifiPhyHelper::Default();
+	phy.SetChannel(channel.Create());
+
+	WifiHelper wifi = WifiHelper::Default();
+	wifi.SetStandard(WIFI_PHY_STANDARD_80211ah);
+	wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+			"DataMode", StringValue("OfdmRate650KbpsBW2MHz"),
+			"ControlMode", StringValue("OfdmRate650KbpsBW2MHz"));
+
+	S1gWifiMacHelper mac = S1gWifiMacHelper::Default();
+	mac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(Ssid("setupbench")));
+	if (SlimStaMac)
+		mac.SetAccessCategories(std::set<AcIndex> { AC_BE });
+
+	long residentBefore = getResidentSize();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	NetDeviceContainer staDevices = wifi.Install(phy, mac, staNodes);
+	double installTime = getSecondsSince(start);
+	long residentAfter = getResidentSize();
+
+	std::cout << Nsta << " stations: install " << installTime << " s, "
+			<< (residentAfter - residentBefore) / 1024.0 / Nsta << " KB per station" << std::endl;
+
+	if (TraceConnect != "") {
+		start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < Nsta; i++) {
+			if (TraceConnect == "Config")
+				connectWithConfig(i);
+			else
+				connectWithWiring(staNodes.Get(i));
+		}
+		std::cout << Nsta << " stations: connecting the trace sinks with " << TraceConnect << " " << getSecondsSince(start) << " s" << std::endl;
+	}
+
+	// initializes the devices, which creates the lazily built parts of the MAC
+	Simulator::Stop(MilliSeconds(10));
+	Simulator::Run();
+	Simulator::Destroy();
+	return 0;
+}
@@ -140,6 +140,11 @@ QosWifiMacHelper::Setup (Ptr<WifiMac> mac, enum AcIndex ac, std::string dcaAttrN
   PointerValue ptr;
   mac->GetAttribute (dcaAttrName, ptr);
   Ptr<EdcaTxopN> edca = ptr.Get<EdcaTxopN> ();
+  if (edca == 0)
+    {
+      //the MAC was configured without this access category
+      return;
+    }
 
   if (m_mpduAggregator.GetTypeId ().GetUid () != 0)
     {
@@ -24,6 +24,10 @@
 #include "ns3/pointer.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/s1g-ap-wifi-mac.h"
+#include "ns3/sta-wifi-mac.h"
 
 namespace ns3 {
 
@@ -51,4 +55,37 @@ S1gWifiMacHelper::Default (void)
   return helper;
 }
 
+void
+S1gWifiMacHelper::SetAccessCategories (std::set<enum AcIndex> acs)
+{
+  NS_ASSERT (!acs.empty ());
+  uint8_t mask = 0;
+  for (std::set<enum AcIndex>::const_iterator i = acs.begin (); i != acs.end (); ++i)
+    {
+      mask |= 1 << *i;
+    }
+  m_mac.Set ("AccessCategories", UintegerValue (mask));
+}
+
+void
+S1gWifiMacHelper::PreAssociate (Ptr<NetDevice> apDevice, NetDeviceContainer staDevices)
+{
+  // the MACs are only initialized when the simulation starts
+  Simulator::ScheduleNow (&S1gWifiMacHelper::DoPreAssociate, apDevice, staDevices);
+}
+
+void
+S1gWifiMacHelper::DoPreAssociate (Ptr<NetDevice> apDevice, NetDeviceContainer staDevices)
+{
+  Ptr<S1gApWifiMac> apMac = DynamicCast<WifiNetDevice> (apDevice)->GetMac ()->GetObject<S1gApWifiMac> ();
+  NS_ASSERT (apMac != 0);
+  for (NetDeviceContainer::Iterator i = staDevices.Begin (); i != staDevices.End (); ++i)
+    {
+      Ptr<StaWifiMac> staMac = DynamicCast<WifiNetDevice> (*i)->GetMac ()->GetObject<StaWifiMac> ();
+      NS_ASSERT (staMac != 0);
+      MgtAssocResponseHeader assocResp = apMac->PreAssociate (staMac->GetAddress (), staMac->CreateAssocRequest ());
+      staMac->PreAssociate (apMac->GetAddress (), assocResp);
+    }
+}
+
 } //namespace ns3
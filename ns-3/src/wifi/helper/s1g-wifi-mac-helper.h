@@ -24,7 +24,9 @@
 #include "wifi-helper.h"
 #include "ns3/qos-utils.h"
 #include "qos-wifi-mac-helper.h"
+#include "ns3/net-device-container.h"
 #include <map>
+#include <set>
 
 namespace ns3 {
 
@@ -53,6 +55,30 @@ public:
    */
   static S1gWifiMacHelper Default (void);
 
+  /**
+   * \param acs the access categories the MACs will have an EDCA queue for
+   *
+   * Traffic of an access category without a queue is sent through the
+   * queue of the nearest access category that is present. Leaving out
+   * the access categories a station never uses saves their queues and
+   * the state of their channel access functions. Must be called after
+   * SetType.
+   */
+  void SetAccessCategories (std::set<enum AcIndex> acs);
+
+  /**
+   * Associate the STAs with the AP at the start of the simulation, without
+   * probing and association frames on the channel. The STAs get the AIDs
+   * a real association would give them and are associated before the first
+   * beacon is sent.
+   *
+   * \param apDevice the device of the ns3::S1gApWifiMac
+   * \param staDevices the devices of the ns3::StaWifiMac STAs
+   */
+  static void PreAssociate (Ptr<NetDevice> apDevice, NetDeviceContainer staDevices);
+
+private:
+  static void DoPreAssociate (Ptr<NetDevice> apDevice, NetDeviceContainer staDevices);
 };
 
 } //namespace ns3
@@ -208,19 +208,31 @@ WifiHelper::AssignStreams (NetDeviceContainer c, int64_t stream)
 
               rmac->GetAttribute ("VO_EdcaTxopN", ptr);
               Ptr<EdcaTxopN> vo_edcaTxopN = ptr.Get<EdcaTxopN> ();
-              currentStream += vo_edcaTxopN->AssignStreams (currentStream);
+              if (vo_edcaTxopN != 0)
+                {
+                  currentStream += vo_edcaTxopN->AssignStreams (currentStream);
+                }
 
               rmac->GetAttribute ("VI_EdcaTxopN", ptr);
               Ptr<EdcaTxopN> vi_edcaTxopN = ptr.Get<EdcaTxopN> ();
-              currentStream += vi_edcaTxopN->AssignStreams (currentStream);
+              if (vi_edcaTxopN != 0)
+                {
+                  currentStream += vi_edcaTxopN->AssignStreams (currentStream);
+                }
 
               rmac->GetAttribute ("BE_EdcaTxopN", ptr);
               Ptr<EdcaTxopN> be_edcaTxopN = ptr.Get<EdcaTxopN> ();
-              currentStream += be_edcaTxopN->AssignStreams (currentStream);
+              if (be_edcaTxopN != 0)
+                {
+                  currentStream += be_edcaTxopN->AssignStreams (currentStream);
+                }
 
               rmac->GetAttribute ("BK_EdcaTxopN", ptr);
               Ptr<EdcaTxopN> bk_edcaTxopN = ptr.Get<EdcaTxopN> ();
-              currentStream += bk_edcaTxopN->AssignStreams (currentStream);
+              if (bk_edcaTxopN != 0)
+                {
+                  currentStream += bk_edcaTxopN->AssignStreams (currentStream);
+                }
 
               //if an AP, handle any beacon jitter
               Ptr<ApWifiMac> apmac = DynamicCast<ApWifiMac> (rmac);
@@ -138,7 +138,7 @@ AdhocWifiMac::Enqueue (Ptr<const Packet> packet, Mac48Address to)
     {
       //Sanity check that the TID is valid
       NS_ASSERT (tid < 8);
-      m_edca[QosUtilsMapTidToAc (tid)]->Queue (packet, hdr);
+      GetEdcaForAc (QosUtilsMapTidToAc (tid))->Queue (packet, hdr);
     }
   else
     {
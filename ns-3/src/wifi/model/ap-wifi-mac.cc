@@ -341,7 +341,7 @@ void ApWifiMac::SetTotalStaNum(uint32_t num) {
         if (m_qosSupported) {
             //Sanity check that the TID is valid
             NS_ASSERT(tid < 8);
-            m_edca[QosUtilsMapTidToAc(tid)]->Queue(packet, hdr);
+            GetEdcaForAc(QosUtilsMapTidToAc(tid))->Queue(packet, hdr);
         } else {
             m_dca->Queue(packet, hdr);
         }
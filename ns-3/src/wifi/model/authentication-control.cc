@@ -32,7 +32,11 @@ AuthenticationCtrl::AuthenticationCtrl ()
 {
   m_length = 0;
   m_AuthenSupported = 1;
+    ctrltype = false;
     ctrlThreshold = 250;
+    slotDuration = 0;
+    maxInterval = 0;
+    minInterval = 0;
 }
 
 AuthenticationCtrl::~AuthenticationCtrl ()
@@ -142,7 +146,7 @@ AuthenticationCtrl::GetInformationFieldSize () const
     NS_ASSERT (m_AuthenSupported > 0);
     if (ctrltype)
      {
-        return 2;
+        return 3;
      }
     else
     {
@@ -174,20 +178,19 @@ AuthenticationCtrl::SerializeInformationField (Buffer::Iterator start) const
 uint8_t
 AuthenticationCtrl::DeserializeInformationField (Buffer::Iterator start, uint8_t length)
 {
-
-    ctrlThreshold = start.ReadU16 ();
-
-    if ((ctrlThreshold & 0x8000) == 0x0000)
+    // the distributed form is the only one of three octets, in the order
+    // SerializeInformationField writes them
+    if (length == 3)
       {
-        ctrltype = false;
-        ctrlThreshold = ctrlThreshold & 0x03ff;
+        ctrltype = true;
+        slotDuration = start.ReadU8 () & 0x7f;
+        maxInterval = start.ReadU8 ();
+        minInterval = start.ReadU8 ();
       }
     else
      {
-       ctrltype = true;
-       slotDuration = (ctrlThreshold >> 8) & 0x007f;
-       maxInterval = ctrlThreshold & 0x00ff;
-       minInterval = start.ReadU8 ();
+       ctrltype = false;
+       ctrlThreshold = start.ReadU16 () & 0x03ff;
      }
 
     m_length = length;
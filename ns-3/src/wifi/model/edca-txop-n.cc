@@ -274,6 +274,7 @@ EdcaTxopN::EdcaTxopN ()
     m_currentPacket (0),
     m_aggregator (0),
     m_typeOfStation (STA),
+    m_baManager (0),
     m_blockAckType (COMPRESSED_BLOCK_ACK),
     m_ampduExist (false)
 {
@@ -287,14 +288,6 @@ EdcaTxopN::EdcaTxopN ()
   m_queue = CreateObject<WifiMacQueue> ();
   m_rng = new RealRandomStream ();
   m_qosBlockedDestinations = new QosBlockedDestinations ();
-  m_baManager = new BlockAckManager ();
-  m_baManager->SetQueue (m_queue);
-  m_baManager->SetBlockAckType (m_blockAckType);
-  m_baManager->SetBlockDestinationCallback (MakeCallback (&QosBlockedDestinations::Block, m_qosBlockedDestinations));
-  m_baManager->SetUnblockDestinationCallback (MakeCallback (&QosBlockedDestinations::Unblock, m_qosBlockedDestinations));
-  m_baManager->SetMaxPacketDelay (m_queue->GetMaxDelay ());
-  m_baManager->SetTxOkCallback (MakeCallback (&EdcaTxopN::BaTxOk, this));
-  m_baManager->SetTxFailedCallback (MakeCallback (&EdcaTxopN::BaTxFailed, this));
 }
 
 EdcaTxopN::~EdcaTxopN ()
@@ -325,28 +318,57 @@ EdcaTxopN::DoDispose (void)
   m_aggregator = 0;
 }
 
+BlockAckManager *
+EdcaTxopN::GetBlockAckManager (void)
+{
+  //Most stations never set up a block ack agreement, so the manager is
+  //only created once the first one is.
+  if (m_baManager == 0)
+    {
+      m_baManager = new BlockAckManager ();
+      m_baManager->SetQueue (m_queue);
+      m_baManager->SetBlockAckType (m_blockAckType);
+      m_baManager->SetBlockDestinationCallback (MakeCallback (&QosBlockedDestinations::Block, m_qosBlockedDestinations));
+      m_baManager->SetUnblockDestinationCallback (MakeCallback (&QosBlockedDestinations::Unblock, m_qosBlockedDestinations));
+      m_baManager->SetMaxPacketDelay (m_queue->GetMaxDelay ());
+      m_baManager->SetTxOkCallback (MakeCallback (&EdcaTxopN::BaTxOk, this));
+      m_baManager->SetTxFailedCallback (MakeCallback (&EdcaTxopN::BaTxFailed, this));
+      m_baManager->SetWifiRemoteStationManager (m_stationManager);
+      m_baManager->SetTxMiddle (m_txMiddle);
+      m_baManager->SetBlockAckInactivityCallback (MakeCallback (&EdcaTxopN::SendDelbaFrame, this));
+      m_baManager->SetBlockAckThreshold (m_blockAckThreshold);
+    }
+  return m_baManager;
+}
+
+bool
+EdcaTxopN::HasBlockAckPackets (void) const
+{
+  return m_baManager != 0 && m_baManager->HasPackets ();
+}
+
 bool
 EdcaTxopN::GetBaAgreementExists (Mac48Address address, uint8_t tid)
 {
-  return m_baManager->ExistsAgreement (address, tid);
+  return m_baManager != 0 && m_baManager->ExistsAgreement (address, tid);
 }
 
 uint32_t
 EdcaTxopN::GetNOutstandingPacketsInBa (Mac48Address address, uint8_t tid)
 {
-  return m_baManager->GetNBufferedPackets (address, tid);
+  return m_baManager != 0 ? m_baManager->GetNBufferedPackets (address, tid) : 0;
 }
 
 uint32_t
 EdcaTxopN::GetNRetryNeededPackets (Mac48Address recipient, uint8_t tid) const
 {
-  return m_baManager->GetNRetryNeededPackets (recipient, tid);
+  return m_baManager != 0 ? m_baManager->GetNRetryNeededPackets (recipient, tid) : 0;
 }
 
 void
 EdcaTxopN::CompleteAmpduTransfer (Mac48Address recipient, uint8_t tid)
 {
-  m_baManager->CompleteAmpduExchange (recipient, tid);
+  GetBlockAckManager ()->CompleteAmpduExchange (recipient, tid);
 }
 
 void
@@ -376,7 +398,10 @@ EdcaTxopN::SetWifiRemoteStationManager (Ptr<WifiRemoteStationManager> remoteMana
 {
   NS_LOG_FUNCTION (this << remoteManager);
   m_stationManager = remoteManager;
-  m_baManager->SetWifiRemoteStationManager (m_stationManager);
+  if (m_baManager != 0)
+    {
+      m_baManager->SetWifiRemoteStationManager (m_stationManager);
+    }
 }
 
 void
@@ -467,7 +492,7 @@ bool
 EdcaTxopN::NeedsAccess (void) const
 {
   NS_LOG_FUNCTION (this);
-  return !m_queue->IsEmpty () || m_currentPacket != 0 || m_baManager->HasPackets ();
+  return !m_queue->IsEmpty () || m_currentPacket != 0 || HasBlockAckPackets ();
 }
 
 uint16_t EdcaTxopN::GetNextSequenceNumberfor (WifiMacHeader *hdr)
@@ -483,13 +508,17 @@ uint16_t EdcaTxopN::PeekNextSequenceNumberfor (WifiMacHeader *hdr)
 Ptr<const Packet>
 EdcaTxopN::PeekNextRetransmitPacket (WifiMacHeader &header,Mac48Address recipient, uint8_t tid, Time *timestamp)
 {
+  if (m_baManager == 0)
+    {
+      return 0;
+    }
   return m_baManager->PeekNextPacket (header,recipient,tid, timestamp);
 }
 
 void
 EdcaTxopN::RemoveRetransmitPacket (uint8_t tid, Mac48Address recipient, uint16_t seqnumber)
 {
-  m_baManager->RemovePacket (tid, recipient, seqnumber);
+  GetBlockAckManager ()->RemovePacket (tid, recipient, seqnumber);
 }
 
 void
@@ -510,19 +539,22 @@ EdcaTxopN::NotifyAccessGranted (void)
     m_AccessQuest_record (Simulator::Now ().GetMicroSeconds (), newdata);
   if (m_currentPacket == 0)
     {
-      if (m_queue->IsEmpty () && !m_baManager->HasPackets ())
+      if (m_queue->IsEmpty () && !HasBlockAckPackets ())
         {
     	  //std::cout << "Access was granted but the queue is empty and there was not packet to be sent" << std::endl;
           NS_LOG_DEBUG ("queue is empty");
           return;
         }
-      if (m_baManager->HasBar (m_currentBar))
+      if (m_baManager != 0 && m_baManager->HasBar (m_currentBar))
         {
           SendBlockAckRequest (m_currentBar);
           return;
         }
       /* check if packets need retransmission are stored in BlockAckManager */
-      m_currentPacket = m_baManager->GetNextPacket (m_currentHdr);
+      if (m_baManager != 0)
+        {
+          m_currentPacket = m_baManager->GetNextPacket (m_currentHdr);
+        }
       if (m_currentPacket == 0)
         {
           if (m_queue->PeekFirstAvailable (&m_currentHdr, m_currentPacketTimestamp, m_qosBlockedDestinations) == 0)
@@ -532,7 +564,7 @@ EdcaTxopN::NotifyAccessGranted (void)
             }
           if (m_currentHdr.IsQosData () && !m_currentHdr.GetAddr1 ().IsBroadcast ()
               && m_blockAckThreshold > 0
-              && !m_baManager->ExistsAgreement (m_currentHdr.GetAddr1 (), m_currentHdr.GetQosTid ())
+              && !GetBaAgreementExists (m_currentHdr.GetAddr1 (), m_currentHdr.GetQosTid ())
               && SetupBlockAckIfNeeded ())
             {
               return;
@@ -864,7 +896,7 @@ EdcaTxopN::GotAck (double snr, WifiMode txMode)
               p->PeekHeader (delBa);
               if (delBa.IsByOriginator ())
                 {
-                  m_baManager->TearDownBlockAck (m_currentHdr.GetAddr1 (), delBa.GetTid ());
+                  GetBlockAckManager ()->TearDownBlockAck (m_currentHdr.GetAddr1 (), delBa.GetTid ());
                 }
               else
                 {
@@ -1028,7 +1060,7 @@ EdcaTxopN::RestartAccessIfNeeded (void)
 {
   NS_LOG_FUNCTION (this);
 
-  bool hasData = (m_currentPacket != 0 || !m_queue->IsEmpty () || m_baManager->HasPackets ());
+  bool hasData = (m_currentPacket != 0 || !m_queue->IsEmpty () || HasBlockAckPackets ());
 
   if (hasData
       && !m_dcf->IsAccessRequested ()
@@ -1050,7 +1082,7 @@ EdcaTxopN::StartAccessIfNeeded (void)
 {
   NS_LOG_FUNCTION (this);
   if (m_currentPacket == 0
-      && (!m_queue->IsEmpty () || m_baManager->HasPackets ())
+      && (!m_queue->IsEmpty () || HasBlockAckPackets ())
       && !m_dcf->IsAccessRequested ()
       && AccessIfRaw)
     {
@@ -1064,7 +1096,7 @@ void
 EdcaTxopN::StartAccessIfNeededRaw (void)
 {
     NS_LOG_FUNCTION (this);
-    if ((!m_queue->IsEmpty () || m_baManager->HasPackets () || m_currentPacket != 0)
+    if ((!m_queue->IsEmpty () || HasBlockAckPackets () || m_currentPacket != 0)
         && !m_dcf->IsAccessRequested ()
         && AccessIfRaw)
     {
@@ -1160,7 +1192,7 @@ EdcaTxopN::NeedBarRetransmission (void)
       tid = baRespHdr.GetTidInfo ();
       seqNumber = m_currentHdr.GetSequenceNumber ();
     }
-  return m_baManager->NeedBarRetransmission (tid, seqNumber, m_currentHdr.GetAddr1 ());
+  return GetBlockAckManager ()->NeedBarRetransmission (tid, seqNumber, m_currentHdr.GetAddr1 ());
 }
 
 void
@@ -1345,7 +1377,8 @@ EdcaTxopN::GotAddBaResponse (const MgtAddBaResponseHeader *respHdr, Mac48Address
   NS_LOG_FUNCTION (this << respHdr << recipient);
   NS_LOG_DEBUG ("received ADDBA response from " << recipient);
   uint8_t tid = respHdr->GetTid ();
-  if (m_baManager->ExistsAgreementInState (recipient, tid, OriginatorBlockAckAgreement::PENDING))
+  if (m_baManager != 0
+      && m_baManager->ExistsAgreementInState (recipient, tid, OriginatorBlockAckAgreement::PENDING))
     {
       if (respHdr->GetStatusCode ().IsSuccess ())
         {
@@ -1366,7 +1399,7 @@ EdcaTxopN::GotDelBaFrame (const MgtDelBaHeader *delBaHdr, Mac48Address recipient
 {
   NS_LOG_FUNCTION (this << delBaHdr << recipient);
   NS_LOG_DEBUG ("received DELBA frame from=" << recipient);
-  m_baManager->TearDownBlockAck (recipient, delBaHdr->GetTid ());
+  GetBlockAckManager ()->TearDownBlockAck (recipient, delBaHdr->GetTid ());
 }
 
 void
@@ -1374,7 +1407,7 @@ EdcaTxopN::GotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac48Address rec
 {
   NS_LOG_FUNCTION (this << blockAck << recipient);
   NS_LOG_DEBUG ("got block ack from=" << recipient);
-  m_baManager->NotifyGotBlockAck (blockAck, recipient, txMode);
+  GetBlockAckManager ()->NotifyGotBlockAck (blockAck, recipient, txMode);
   if (!m_txOkCallback.IsNull ())
     {
       m_txOkCallback (m_currentHdr);
@@ -1392,6 +1425,10 @@ EdcaTxopN::VerifyBlockAck (void)
   uint8_t tid = m_currentHdr.GetQosTid ();
   Mac48Address recipient = m_currentHdr.GetAddr1 ();
   uint16_t sequence = m_currentHdr.GetSequenceNumber ();
+  if (m_baManager == 0)
+    {
+      return;
+    }
   if (m_baManager->ExistsAgreementInState (recipient, tid, OriginatorBlockAckAgreement::INACTIVE))
     {
       m_baManager->SwitchToBlockAckIfNeeded (recipient, tid, sequence);
@@ -1420,9 +1457,9 @@ EdcaTxopN::CompleteTx (void)
     {
       if (!m_currentHdr.IsRetry ())
         {
-          m_baManager->StorePacket (m_currentPacket, m_currentHdr, m_currentPacketTimestamp);
+          GetBlockAckManager ()->StorePacket (m_currentPacket, m_currentHdr, m_currentPacketTimestamp);
         }
-      m_baManager->NotifyMpduTransmission (m_currentHdr.GetAddr1 (), m_currentHdr.GetQosTid (),
+      GetBlockAckManager ()->NotifyMpduTransmission (m_currentHdr.GetAddr1 (), m_currentHdr.GetQosTid (),
                                            m_txMiddle->GetNextSeqNumberByTidAndAddress (m_currentHdr.GetQosTid (),
                                                                                         m_currentHdr.GetAddr1 ()), WifiMacHeader::BLOCK_ACK);
     }
@@ -1431,8 +1468,8 @@ EdcaTxopN::CompleteTx (void)
 void
 EdcaTxopN::CompleteMpduTx (Ptr<const Packet> packet, WifiMacHeader hdr, Time tstamp)
 {
-  m_baManager->StorePacket (packet, hdr, tstamp);
-  m_baManager->NotifyMpduTransmission (hdr.GetAddr1 (), hdr.GetQosTid (),
+  GetBlockAckManager ()->StorePacket (packet, hdr, tstamp);
+  GetBlockAckManager ()->NotifyMpduTransmission (hdr.GetAddr1 (), hdr.GetQosTid (),
                                        m_txMiddle->GetNextSeqNumberByTidAndAddress (hdr.GetQosTid (),
                                                                                     hdr.GetAddr1 ()), WifiMacHeader::NORMAL_ACK);
 }
@@ -1514,9 +1551,18 @@ void
 EdcaTxopN::CompleteConfig (void)
 {
   NS_LOG_FUNCTION (this);
-  m_baManager->SetTxMiddle (m_txMiddle);
+  if (m_baManager != 0)
+    {
+      m_baManager->SetTxMiddle (m_txMiddle);
+    }
   m_low->RegisterBlockAckListenerForAc (m_ac, m_blockAckListener);
-  m_baManager->SetBlockAckInactivityCallback (MakeCallback (&EdcaTxopN::SendDelbaFrame, this));
+}
+
+void
+EdcaTxopN::RegisterBlockAckListenerForAc (enum AcIndex ac)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (ac));
+  m_low->RegisterBlockAckListenerForAc (ac, m_blockAckListener);
 }
 
 void
@@ -1524,7 +1570,10 @@ EdcaTxopN::SetBlockAckThreshold (uint8_t threshold)
 {
   NS_LOG_FUNCTION (this << static_cast<uint32_t> (threshold));
   m_blockAckThreshold = threshold;
-  m_baManager->SetBlockAckThreshold (threshold);
+  if (m_baManager != 0)
+    {
+      m_baManager->SetBlockAckThreshold (threshold);
+    }
 }
 
 void
@@ -1580,7 +1629,7 @@ EdcaTxopN::SendAddBaRequest (Mac48Address dest, uint8_t tid, uint16_t startSeq,
   reqHdr.SetTimeout (timeout);
   reqHdr.SetStartingSequence (startSeq);
 
-  m_baManager->CreateAgreement (&reqHdr, dest);
+  GetBlockAckManager ()->CreateAgreement (&reqHdr, dest);
 
   packet->AddHeader (reqHdr);
   packet->AddHeader (actionHdr);
@@ -406,6 +406,14 @@ public:
    * Complete block ACK configuration.
    */
   void CompleteConfig (void);
+  /**
+   * Also receive the block ACK events MacLow has for the given Access
+   * Category, when the frames of that Access Category are sent through
+   * this EDCAF.
+   *
+   * \param ac the Access Category without an EDCAF of its own
+   */
+  void RegisterBlockAckListenerForAc (enum AcIndex ac);
 
   /**
    * Set threshold for block ACK mechanism. If number of packets in the
@@ -536,6 +544,18 @@ private:
    * if an established block ack agreement exists with the receiver.
    */
   void VerifyBlockAck (void);
+  /**
+   * Return the block ack manager of this queue, creating and configuring
+   * it the first time a block ack agreement needs it.
+   *
+   * \return the block ack manager
+   */
+  BlockAckManager * GetBlockAckManager (void);
+  /**
+   * \return true if the block ack manager has packets to (re)transmit,
+   *         false if it has none or has not been created
+   */
+  bool HasBlockAckPackets (void) const;
 
   AcIndex m_ac;
   class Dcf;
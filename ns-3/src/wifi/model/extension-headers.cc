@@ -36,6 +36,11 @@ namespace ns3 {
 NS_OBJECT_ENSURE_REGISTERED (S1gBeaconHeader);
 
 S1gBeaconHeader::S1gBeaconHeader ()
+  : m_timestamp (0),
+    m_sequence (0),
+    m_tbtt (0),
+    m_compressedssid (0),
+    m_accessnetwork (0)
 {
 }
     
@@ -261,4 +266,183 @@ S1gBeaconHeader::Deserialize (Buffer::Iterator start)
 }
 
 
+/***********************************************************
+ *          S1G Beacon Template
+ ***********************************************************/
+
+NS_OBJECT_ENSURE_REGISTERED (S1gBeaconTemplate);
+
+S1gBeaconTemplate::S1gBeaconTemplate ()
+  : m_built (false),
+    m_tsfOffset (0),
+    m_timOffset (0),
+    m_rpsOffset (0),
+    m_authOffset (0),
+    m_stationBitmapSize (0),
+    m_authThresholdPresent (false),
+    m_authSlotDurationPresent (false)
+{
+}
+
+S1gBeaconTemplate::~S1gBeaconTemplate ()
+{
+}
+
+void
+S1gBeaconTemplate::Build (const S1gBeaconHeader &beacon)
+{
+  m_bytes = Buffer ();
+  m_bytes.AddAtStart (beacon.GetSerializedSize ());
+  beacon.Serialize (m_bytes.Begin ());
+
+  // Timestamp, Change Sequence, Next TBTT, Compressed SSID, Access Network
+  uint32_t offset = 4 + 1 + 3 + 4 + 1;
+  offset += beacon.GetBeaconCompatibility ().GetSerializedSize ();
+  m_tsfOffset = offset - 4; // TSF completion is the last field of the compatibility element
+  // information fields start after the element id and length octets
+  m_timOffset = offset + 2;
+  m_stationBitmapSize = beacon.GetTIM ().GetStationBitmap ().size ();
+  offset += beacon.GetTIM ().GetSerializedSize ();
+  m_rpsOffset = offset + 2;
+  offset += beacon.GetRPS ().GetSerializedSize ();
+  m_authOffset = offset + 2;
+  AuthenticationCtrl auth = beacon.GetAuthCtrl ();
+  m_authThresholdPresent = auth.GetSerializedSize () > 0 && !auth.GetControlType ();
+  m_authSlotDurationPresent = auth.GetSerializedSize () > 0 && auth.GetControlType ();
+  m_built = true;
+}
+
+bool
+S1gBeaconTemplate::IsBuilt (void) const
+{
+  return m_built;
+}
+
+Buffer::Iterator
+S1gBeaconTemplate::GetIterator (uint32_t offset)
+{
+  NS_ASSERT (m_built);
+  Buffer::Iterator i = m_bytes.Begin ();
+  i.Next (offset);
+  return i;
+}
+
+void
+S1gBeaconTemplate::SetDTIMCount (uint8_t count)
+{
+  GetIterator (m_timOffset).WriteU8 (count);
+}
+
+void
+S1gBeaconTemplate::SetPartialVBitmap (uint32_t vmap)
+{
+  // DTIM count, DTIM period and bitmap control precede the bitmap
+  GetIterator (m_timOffset + 3).WriteU32 (vmap);
+}
+
+void
+S1gBeaconTemplate::SetStationBitmap (const TIM &tim)
+{
+  const std::vector<uint8_t> &bitmap = tim.GetStationBitmap ();
+  NS_ASSERT (bitmap.size () == m_stationBitmapSize);
+  // the station bitmap follows the partial virtual bitmap
+  Buffer::Iterator i = GetIterator (m_timOffset + 7);
+  for (uint8_t octet : bitmap)
+    {
+      i.WriteU8 (octet);
+    }
+}
+
+void
+S1gBeaconTemplate::SetRawGroup (uint32_t rawgroup)
+{
+  // RAW control and RAW slot definition precede the RAW group
+  Buffer::Iterator i = GetIterator (m_rpsOffset + 4);
+  i.WriteU8 ((uint8_t) rawgroup);         //(7-0)
+  i.WriteU8 ((uint8_t) (rawgroup >> 8));  //(15-8)
+  i.WriteU8 ((uint8_t) (rawgroup >> 16)); //(23-16)
+}
+
+void
+S1gBeaconTemplate::SetPRAW (uint32_t praw)
+{
+  // followed by the RAW group and the channel indication
+  Buffer::Iterator i = GetIterator (m_rpsOffset + 9);
+  i.WriteU8 ((uint8_t) praw);
+  i.WriteU8 ((uint8_t) (praw >> 8));
+  i.WriteU8 ((uint8_t) (praw >> 16));
+}
+
+void
+S1gBeaconTemplate::SetAuthThreshold (uint16_t threshold)
+{
+  NS_ASSERT (m_authThresholdPresent);
+  GetIterator (m_authOffset).WriteU16 (threshold);
+}
+
+void
+S1gBeaconTemplate::SetAuthSlotDuration (uint8_t duration)
+{
+  NS_ASSERT (m_authSlotDurationPresent);
+  // the top bit marks the distributed control type
+  GetIterator (m_authOffset).WriteU8 ((duration & 0x7f) | 0x80);
+}
+
+TypeId
+S1gBeaconTemplate::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::S1gBeaconTemplate")
+    .SetParent<Header> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<S1gBeaconTemplate> ()
+  ;
+  return tid;
+}
+
+TypeId
+S1gBeaconTemplate::GetInstanceTypeId (void) const
+{
+  // on the air this is a regular S1G beacon
+  return S1gBeaconHeader::GetTypeId ();
+}
+
+void
+S1gBeaconTemplate::Print (std::ostream &os) const
+{
+  S1gBeaconHeader beacon;
+  beacon.Deserialize (m_bytes.Begin ());
+  beacon.Print (os);
+}
+
+uint32_t
+S1gBeaconTemplate::GetSerializedSize (void) const
+{
+  return m_bytes.GetSize ();
+}
+
+void
+S1gBeaconTemplate::Serialize (Buffer::Iterator start) const
+{
+  NS_ASSERT (m_built);
+  Buffer::Iterator i = start;
+  i.Write (m_bytes.Begin (), m_bytes.End ());
+
+  uint64_t now = Simulator::Now ().GetMicroSeconds ();
+  i = start;
+  i.WriteHtolsbU32 ((uint32_t)now);
+  i = start;
+  i.Next (m_tsfOffset);
+  i.WriteHtolsbU32 ((now >> 32) & 0xffffffff);
+}
+
+uint32_t
+S1gBeaconTemplate::Deserialize (Buffer::Iterator start)
+{
+  S1gBeaconHeader beacon;
+  uint32_t size = beacon.Deserialize (start);
+  Build (beacon);
+  return size;
+}
+
+
 } //namespace ns3
@@ -85,6 +85,62 @@ private:
     AuthenticationCtrl  m_auth;
 };
 
+/**
+ * \ingroup wifi
+ * An S1G beacon that is serialized once and afterwards only patched in place.
+ *
+ * The AP keeps one template per TIM group: between two beacons of the same
+ * group only the TIM bitmap, the RAW AID range and the authentication
+ * threshold change, so there is no need to rebuild and re-serialize every
+ * information element. The timestamp and the TSF completion field are
+ * written at serialization time, exactly like S1gBeaconHeader does.
+ *
+ * The instance type id is the one of S1gBeaconHeader, so receivers (and the
+ * packet metadata) see an ordinary S1G beacon and simply RemoveHeader it.
+ */
+class S1gBeaconTemplate : public Header
+{
+public:
+  S1gBeaconTemplate ();
+  ~S1gBeaconTemplate ();
+
+  /**
+   * Serialize the given beacon into the template and remember where the
+   * patchable fields are located.
+   *
+   * \param beacon the fully populated beacon
+   */
+  void Build (const S1gBeaconHeader &beacon);
+  bool IsBuilt (void) const;
+
+  void SetDTIMCount (uint8_t count);
+  void SetPartialVBitmap (uint32_t vmap);
+  void SetStationBitmap (const TIM &tim); //must have the station bitmap size of the built beacon
+  void SetRawGroup (uint32_t rawgroup); //only (23-0) bits are used
+  void SetPRAW (uint32_t praw); //only (23-0) bits are used
+  void SetAuthThreshold (uint16_t threshold);
+  void SetAuthSlotDuration (uint8_t duration); //only (6-0) bits are used
+
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+private:
+  Buffer::Iterator GetIterator (uint32_t offset);
+
+  Buffer m_bytes;
+  bool m_built;
+  uint32_t m_tsfOffset;       //!< upper 32 bits of the TSF in the compatibility element
+  uint32_t m_timOffset;       //!< start of the TIM information field
+  uint32_t m_rpsOffset;       //!< start of the RPS information field
+  uint32_t m_authOffset;      //!< start of the authentication control information field
+  uint32_t m_stationBitmapSize; //!< octets of the TIM station bitmap
+  bool m_authThresholdPresent;
+  bool m_authSlotDurationPresent;
+};
+
 
 
 
@@ -1101,6 +1101,13 @@ MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiTxVector txVector, Wifi
           NS_FATAL_ERROR ("Multi-tid block ack is not supported.");
         }
     }
+  else if (hdr.IsPsPoll () && hdr.GetAddr1 () == m_self)
+    {
+      // the AP answers a PS-Poll from its power save buffer
+      NS_LOG_DEBUG ("rx PS-Poll from=" << hdr.GetAddr2 ());
+      m_receivedAtLeastOneMpdu = false;
+      goto rxPacket;
+    }
   else if (hdr.IsCtl ())
     {
       NS_LOG_DEBUG ("rx drop " << hdr.GetTypeString ());
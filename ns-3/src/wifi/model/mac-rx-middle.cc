@@ -302,6 +302,12 @@ void
 MacRxMiddle::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
 {
   NS_LOG_FUNCTION (packet << hdr);
+  if (hdr->IsPsPoll ())
+    {
+      // no sequence control, nothing to filter or reassemble
+      m_callback (packet, hdr);
+      return;
+    }
   NS_ASSERT (hdr->IsData () || hdr->IsMgt () || hdr->IsS1gBeacon ());
   OriginatorRxStatus *originator = Lookup (hdr);
   /**
@@ -65,13 +65,34 @@ RegularWifiMac::RegularWifiMac ()
 
   m_dca->TraceConnect("TransmissionWillCrossRAWBoundary", "", MakeCallback(&RegularWifiMac::OnTransmissionWillCrossRAWBoundary, this));
 
-  //Construct the EDCAFs. The ordering is important - highest
-  //priority (Table 9-1 UP-to-AC mapping; IEEE 802.11-2012) must be created
-  //first.
-  SetupEdcaQueue (AC_VO);
-  SetupEdcaQueue (AC_VI);
-  SetupEdcaQueue (AC_BE);
-  SetupEdcaQueue (AC_BK);
+  m_typeOfStation = STA;
+}
+
+void
+RegularWifiMac::NotifyConstructionCompleted (void)
+{
+  NS_LOG_FUNCTION (this);
+  //The EDCAFs are only constructed once the AccessCategories attribute
+  //is known. The ordering is important - highest priority (Table 9-1
+  //UP-to-AC mapping; IEEE 802.11-2012) must be created first.
+  static const AcIndex acs[] = { AC_VO, AC_VI, AC_BE, AC_BK };
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      if (m_accessCategories & (1 << acs[i]))
+        {
+          SetupEdcaQueue (acs[i]);
+        }
+    }
+  //MacLow finds the EDCAF of a frame by its TID, so the block ack events
+  //of an access category without one go to the EDCAF that sends its frames
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      if (m_edca.find (acs[i]) == m_edca.end ())
+        {
+          GetEdcaForAc (acs[i])->RegisterBlockAckListenerForAc (acs[i]);
+        }
+    }
+  WifiMac::NotifyConstructionCompleted ();
 }
 
 void
@@ -174,6 +195,7 @@ RegularWifiMac::SetupEdcaQueue (enum AcIndex ac)
   edca->SetTxOkCallback (MakeCallback (&RegularWifiMac::TxOk, this));
   edca->SetTxFailedCallback (MakeCallback (&RegularWifiMac::TxFailed, this));
   edca->SetAccessCategory (ac);
+  edca->SetTypeOfStation (m_typeOfStation);
   edca->CompleteConfig ();
   m_edca.insert (std::make_pair (ac, edca));
 
@@ -186,6 +208,7 @@ void
 RegularWifiMac::SetTypeOfStation (TypeOfStation type)
 {
   NS_LOG_FUNCTION (this << type);
+  m_typeOfStation = type;
   for (EdcaQueues::iterator i = m_edca.begin (); i != m_edca.end (); ++i)
     {
       i->second->SetTypeOfStation (type);
@@ -198,28 +221,63 @@ RegularWifiMac::GetDcaTxop () const
   return m_dca;
 }
 
+Ptr<EdcaTxopN>
+RegularWifiMac::GetEdcaForAc (AcIndex ac) const
+{
+  //a frame of an access category without an EDCAF is sent with the next
+  //lower priority that has one, or the nearest higher one otherwise
+  static const AcIndex byPriority[] = { AC_BK, AC_BE, AC_VI, AC_VO };
+  int32_t priority = 0;
+  while (byPriority[priority] != ac)
+    {
+      priority++;
+    }
+  for (int32_t i = priority; i >= 0; i--)
+    {
+      EdcaQueues::const_iterator it = m_edca.find (byPriority[i]);
+      if (it != m_edca.end ())
+        {
+          return it->second;
+        }
+    }
+  for (int32_t i = priority + 1; i < 4; i++)
+    {
+      EdcaQueues::const_iterator it = m_edca.find (byPriority[i]);
+      if (it != m_edca.end ())
+        {
+          return it->second;
+        }
+    }
+  NS_FATAL_ERROR ("No EDCA function for access category " << ac);
+  return 0;
+}
+
 Ptr<EdcaTxopN>
 RegularWifiMac::GetVOQueue () const
 {
-  return m_edca.find (AC_VO)->second;
+  EdcaQueues::const_iterator it = m_edca.find (AC_VO);
+  return it != m_edca.end () ? it->second : 0;
 }
 
 Ptr<EdcaTxopN>
 RegularWifiMac::GetVIQueue () const
 {
-  return m_edca.find (AC_VI)->second;
+  EdcaQueues::const_iterator it = m_edca.find (AC_VI);
+  return it != m_edca.end () ? it->second : 0;
 }
 
 Ptr<EdcaTxopN>
 RegularWifiMac::GetBEQueue () const
 {
-  return m_edca.find (AC_BE)->second;
+  EdcaQueues::const_iterator it = m_edca.find (AC_BE);
+  return it != m_edca.end () ? it->second : 0;
 }
 
 Ptr<EdcaTxopN>
 RegularWifiMac::GetBKQueue () const
 {
-  return m_edca.find (AC_BK)->second;
+  EdcaQueues::const_iterator it = m_edca.find (AC_BK);
+  return it != m_edca.end () ? it->second : 0;
 }
 
 void
@@ -567,7 +625,7 @@ RegularWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
                 //and act by locally establishing the agreement on
                 //the appropriate queue.
                 AcIndex ac = QosUtilsMapTidToAc (respHdr.GetTid ());
-                m_edca[ac]->GotAddBaResponse (&respHdr, from);
+                GetEdcaForAc (ac)->GotAddBaResponse (&respHdr, from);
                 //This frame is now completely dealt with, so we're done.
                 return;
               }
@@ -590,7 +648,7 @@ RegularWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
                     //tell the correct queue that the agreement has
                     //been torn down
                     AcIndex ac = QosUtilsMapTidToAc (delBaHdr.GetTid ());
-                    m_edca[ac]->GotDelBaFrame (&delBaHdr, from);
+                    GetEdcaForAc (ac)->GotDelBaFrame (&delBaHdr, from);
                   }
                 //This frame is now completely dealt with, so we're done.
                 return;
@@ -677,7 +735,7 @@ RegularWifiMac::SendAddBaResponse (const MgtAddBaRequestHeader *reqHdr,
   //It is unclear which queue this frame should go into. For now we
   //bung it into the queue corresponding to the TID for which we are
   //establishing an agreement, and push it to the head.
-  m_edca[QosUtilsMapTidToAc (reqHdr->GetTid ())]->PushFront (packet, hdr);
+  GetEdcaForAc (QosUtilsMapTidToAc (reqHdr->GetTid ()))->PushFront (packet, hdr);
 }
 
 TypeId
@@ -692,6 +750,14 @@ RegularWifiMac::GetTypeId (void)
                    MakeBooleanAccessor (&RegularWifiMac::SetQosSupported,
                                         &RegularWifiMac::GetQosSupported),
                    MakeBooleanChecker ())
+    .AddAttribute ("AccessCategories",
+                   "Bit mask of the access categories that get their own EDCA function, bit n "
+                   "stands for AcIndex n (AC_BE = 0, AC_BK = 1, AC_VI = 2, AC_VO = 3). The frames "
+                   "of an access category without one are sent through the next lower access "
+                   "category that has one. Only taken into account when the MAC is created.",
+                   UintegerValue (0x0f),
+                   MakeUintegerAccessor (&RegularWifiMac::m_accessCategories),
+                   MakeUintegerChecker<uint8_t> (1, 0x0f))
     .AddAttribute ("HtSupported",
                    "This Boolean attribute is set to enable 802.11n support at this STA",
                    BooleanValue (false),
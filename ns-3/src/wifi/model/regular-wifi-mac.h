@@ -249,6 +249,7 @@ public:
 protected:
   virtual void DoInitialize ();
   virtual void DoDispose ();
+  virtual void NotifyConstructionCompleted (void);
 
   MacRxMiddle *m_rxMiddle;  //!< RX middle (de-fragmentation etc.)
   MacTxMiddle *m_txMiddle;  //!< TX middle (aggregation etc.)
@@ -290,6 +291,17 @@ protected:
    */
   Ptr<DcaTxop> GetDcaTxop (void) const;
 
+  /**
+   * Accessor for the channel access function that sends the frames of the
+   * given Access Category. This is the EDCAF of another Access Category if
+   * the MAC was created without one for it (see the AccessCategories
+   * attribute).
+   *
+   * \param ac the Access Category index
+   * \return a smart pointer to EdcaTxopN
+   */
+  Ptr<EdcaTxopN> GetEdcaForAc (AcIndex ac) const;
+
   /**
    * Accessor for the AC_VO channel access function
    *
@@ -486,6 +498,9 @@ private:
    */
   void SetupEdcaQueue (enum AcIndex ac);
 
+  uint8_t m_accessCategories;     //!< bit mask of the Access Categories that get an EDCAF
+  TypeOfStation m_typeOfStation;  //!< passed on to every EDCAF
+
   TracedCallback<const WifiMacHeader &> m_txOkCallback;
   TracedCallback<const WifiMacHeader &> m_txErrCallback;
 };
@@ -99,6 +99,15 @@ namespace ns3 {
         m_prawparam = praw;
     }
 
+    // (b0-b7, PRAW periodicity) (b8-b15, PRAW validity) (b16-b23, PRAW start offset)
+    // the periodic RAW indication is bit 7 of the RAW control
+
+    void
+    RPS::RawAssignment::SetPeriodicRaw(uint8_t periodicity, uint8_t validity, uint8_t startOffset) {
+        m_rawcontrol |= 0x80;
+        m_prawparam = (uint32_t(startOffset) << 16) | (uint32_t(validity) << 8) | periodicity;
+    }
+
     uint8_t
     RPS::RawAssignment::GetRawControl(void) const {
         return m_rawcontrol;
@@ -178,6 +187,26 @@ namespace ns3 {
         return m_prawparam;
     }
 
+    bool
+    RPS::RawAssignment::IsPeriodic(void) const {
+        return (m_rawcontrol & 0x80) == 0x80;
+    }
+
+    uint8_t
+    RPS::RawAssignment::GetPRAWPeriodicity(void) const {
+        return m_prawparam & 0xFF;
+    }
+
+    uint8_t
+    RPS::RawAssignment::GetPRAWValidity(void) const {
+        return (m_prawparam >> 8) & 0xFF;
+    }
+
+    uint8_t
+    RPS::RawAssignment::GetPRAWStartOffset(void) const {
+        return (m_prawparam >> 16) & 0xFF;
+    }
+
     uint8_t
     RPS::RawAssignment::GetSize(void) const {
         //return raw_length;
@@ -198,7 +227,7 @@ namespace ns3 {
         os << "RAW Slot: " << std::to_string(m_raw[2] << 8 + m_raw[1]) << std::endl;
         os << "RAW Start: " << std::to_string(m_raw[3]) << std::endl;
         os << "RAW Group: " << std::to_string(((int) m_raw[6] << 16) + ((int) m_raw[5] << 8) + m_raw[4]) << std::endl;
-        os << "Channel index: " << std::to_string(((int) m_raw[8] << 16) + m_raw[7]) << std::endl;
+        os << "Channel index: " << std::to_string(((int) m_raw[8] << 8) + m_raw[7]) << std::endl;
         os << "PRAW: " << std::to_string(((int) m_raw[11] << 16) + ((int) m_raw[10] << 8) + m_raw[9]) << std::endl;
     }
 
@@ -210,33 +239,31 @@ namespace ns3 {
     RPS::SetRawAssignment(RPS::RawAssignment raw) {
         m_length = 0;
         assignment = raw;
-        static uint8_t m_rpsarry[12]; //! Support up to 10 RAW Assignment subfield
         //uint8_t len = assignment.GetSize ();
-        m_rpsarry[m_length] = assignment.GetRawControl();
+        m_rps[m_length] = assignment.GetRawControl();
         m_length++;
-        m_rpsarry[m_length] = (uint8_t) assignment.GetRawSlot();
+        m_rps[m_length] = (uint8_t) assignment.GetRawSlot();
         m_length++;
-        m_rpsarry[m_length] = (uint8_t) (assignment.GetRawSlot() >> 8);
+        m_rps[m_length] = (uint8_t) (assignment.GetRawSlot() >> 8);
         m_length++;
-        m_rpsarry[m_length] = assignment.GetRawStart();
+        m_rps[m_length] = assignment.GetRawStart();
         m_length++;
-        m_rpsarry[m_length] = (uint8_t) (assignment.GetRawGroup()); //(7-0)
+        m_rps[m_length] = (uint8_t) (assignment.GetRawGroup()); //(7-0)
         m_length++;
-        m_rpsarry[m_length] = (uint8_t) (assignment.GetRawGroup() >> 8); //(15-8)
+        m_rps[m_length] = (uint8_t) (assignment.GetRawGroup() >> 8); //(15-8)
         m_length++;
-        m_rpsarry[m_length] = (uint8_t) (assignment.GetRawGroup() >> 16); //(23-16)
+        m_rps[m_length] = (uint8_t) (assignment.GetRawGroup() >> 16); //(23-16)
         m_length++;
-        m_rpsarry[m_length] = (uint8_t) assignment.GetChannelInd();
+        m_rps[m_length] = (uint8_t) assignment.GetChannelInd();
         m_length++;
-        m_rpsarry[m_length] = (uint8_t) (assignment.GetChannelInd() >> 16);
+        m_rps[m_length] = (uint8_t) (assignment.GetChannelInd() >> 8);
         m_length++;
-        m_rpsarry[m_length] = (uint8_t) assignment.GetPRAW();
+        m_rps[m_length] = (uint8_t) assignment.GetPRAW();
         m_length++;
-        m_rpsarry[m_length] = (uint8_t) (assignment.GetPRAW() >> 8);
+        m_rps[m_length] = (uint8_t) (assignment.GetPRAW() >> 8);
         m_length++;
-        m_rpsarry[m_length] = (uint8_t) (assignment.GetPRAW() >> 16);
+        m_rps[m_length] = (uint8_t) (assignment.GetPRAW() >> 16);
         m_length++;
-        m_rps = m_rpsarry;
 /*
         std::cout << "GetRawControl-----" << (unsigned int)assignment.GetRawControl() << std::endl;
         std::cout << "SetSlotCrossBoundary--" << (unsigned int)assignment.GetSlotCrossBoundary() << std::endl;
@@ -251,7 +278,7 @@ namespace ns3 {
         std::cout << "+++++++++++++++++++++++++++++++++++++++++++++++++" << std::endl << std::endl;*/
     }
 
-    uint8_t *
+    const uint8_t *
     RPS::GetRawAssignment(void) const {
         return m_rps;
     }
@@ -268,7 +295,7 @@ namespace ns3 {
 
         ass.SetRawStart(m_raw[3]);
         ass.SetRawGroup((uint32_t(m_raw[6]) << 16) + (uint32_t(m_raw[5]) << 8) + uint32_t(m_raw[4]));
-        ass.SetChannelInd((uint16_t(m_raw[8]) << 16) + uint16_t(m_raw[7]));
+        ass.SetChannelInd((uint16_t(m_raw[8]) << 8) + uint16_t(m_raw[7]));
         ass.SetPRAW((uint32_t(m_raw[11]) << 16) + (uint32_t(m_raw[10]) << 8) + uint32_t(m_raw[9]));
         
         return ass;
@@ -291,9 +318,8 @@ namespace ns3 {
 
     uint8_t
     RPS::DeserializeInformationField(Buffer::Iterator start, uint8_t length) {
-        static uint8_t m_rpsarry[12];
-        start.Read(m_rpsarry, length);
-        m_rps = m_rpsarry;
+        NS_ASSERT(length <= sizeof(m_rps));
+        start.Read(m_rps, length);
         m_length = length;
         return length;
     }
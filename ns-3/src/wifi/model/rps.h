@@ -59,6 +59,12 @@ public:
           void SetRawGroup (uint32_t group);
           void SetChannelInd (uint16_t channel);
           void SetPRAW (uint32_t praw);
+          /**
+           * Announce this RAW as a periodic RAW (PRAW): it recurs every
+           * periodicity beacon intervals, validity times, the first
+           * occurrence being startOffset beacon intervals after this beacon.
+           */
+          void SetPeriodicRaw (uint8_t periodicity, uint8_t validity, uint8_t startOffset);
           
           uint8_t GetRawControl (void) const;
           uint16_t GetRawSlot (void) ;
@@ -79,6 +85,10 @@ public:
 
           uint16_t GetChannelInd (void) const;
           uint32_t GetPRAW (void) const;
+          bool IsPeriodic (void) const;
+          uint8_t GetPRAWPeriodicity (void) const;
+          uint8_t GetPRAWValidity (void) const;
+          uint8_t GetPRAWStartOffset (void) const;
           
           uint8_t GetSize (void) const;
           //void Serialize (Buffer::Iterator start) const;
@@ -104,7 +114,7 @@ public:
   ~RPS ();
  
   void SetRawAssignment (RPS::RawAssignment raw);
-  uint8_t * GetRawAssignment (void) const;  //to do, use std::vector
+  const uint8_t * GetRawAssignment (void) const;  //to do, use std::vector
   
   RPS::RawAssignment
     GetRawAssigmentObj() const;
@@ -119,7 +129,7 @@ public:
 
 private:
   RPS::RawAssignment assignment; //!< RawAssignment subfield
-  uint8_t * m_rps; //! Support up to 10 RAW Assignment subfield
+  uint8_t m_rps[12]; //! Single RAW Assignment subfield, owned by this element
   
   uint8_t m_length; //!< Total length of all RAW Assignments
 };
@@ -4,11 +4,13 @@
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
-#include "wifi-mac-queue.h"
-#include "qos-blocked-destinations.h"
+#include "ns3/enum.h"
+#include "ns3/log.h"
 
 namespace ns3 {
 
+NS_LOG_COMPONENT_DEFINE ("S1gAPQueue");
+
 NS_OBJECT_ENSURE_REGISTERED (S1gAPQueue);
 
 S1gAPQueue::Item::Item (Ptr<const Packet> packet,
@@ -20,6 +22,11 @@ S1gAPQueue::Item::Item (Ptr<const Packet> packet,
 {
 }
 
+S1gAPQueue::StationBuffer::StationBuffer ()
+  : timGroup (0)
+{
+}
+
 TypeId
 S1gAPQueue::GetTypeId (void)
 {
@@ -27,14 +34,29 @@ S1gAPQueue::GetTypeId (void)
     .SetParent<Object> ()
     .SetGroupName ("Wifi")
     .AddConstructor<S1gAPQueue> ()
-    .AddAttribute ("MaxPacketNumber", "If a packet arrives when there are already this number of packets, it is dropped.",
-                   UintegerValue (400),
+    .AddAttribute ("MaxPacketNumber", "If a packet arrives when there are already this number of packets buffered for all stations, the drop policy is applied. "
+                   "0 leaves the buffer unbounded.",
+                   UintegerValue (0),
                    MakeUintegerAccessor (&S1gAPQueue::m_maxSize),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MaxPacketsPerStation", "If a packet arrives when there are already this number of packets buffered for its station, the drop policy is applied. "
+                   "0 leaves the buffer of a station unbounded.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&S1gAPQueue::m_maxSizePerStation),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("DropPolicy", "Which packet is dropped when the buffer is full.",
+                   EnumValue (DROP_NEWEST),
+                   MakeEnumAccessor (&S1gAPQueue::m_dropPolicy),
+                   MakeEnumChecker (DROP_NEWEST, "DropNewest",
+                                    DROP_OLDEST, "DropOldest"))
     .AddAttribute ("MaxDelay", "If a packet stays longer than this delay in the queue, it is dropped.",
                    TimeValue (MilliSeconds (500.0)),
                    MakeTimeAccessor (&S1gAPQueue::m_maxDelay),
                    MakeTimeChecker ())
+    .AddTraceSource ("PacketDropped",
+                     "Trace source indicating a packet has been dropped from the buffer",
+                     MakeTraceSourceAccessor (&S1gAPQueue::m_packetdropped),
+                     "ns3::S1gAPQueue::PacketDroppedCallback")
   ;
   return tid;
 }
@@ -45,8 +67,16 @@ S1gAPQueue::S1gAPQueue ()
 }
 
 S1gAPQueue::~S1gAPQueue ()
+{
+}
+
+void
+S1gAPQueue::DoDispose (void)
 {
   Flush ();
+  m_stations.clear ();
+  m_timGroupSize.clear ();
+  Object::DoDispose ();
 }
 
 void
@@ -73,253 +103,160 @@ S1gAPQueue::GetMaxDelay (void) const
   return m_maxDelay;
 }
 
-void
-S1gAPQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
+S1gAPQueue::StationBuffer &
+S1gAPQueue::GetStationBuffer (uint16_t aid)
 {
-  Cleanup ();
-  if (m_size == m_maxSize)
+  if (aid >= m_stations.size ())
     {
-      return;
+      m_stations.resize (aid + 1);
     }
-  Time now = Simulator::Now ();
-  m_queue.push_back (Item (packet, hdr, now));
-  m_size++;
+  return m_stations[aid];
 }
 
 void
-S1gAPQueue::Cleanup (void)
+S1gAPQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr, uint16_t aid, uint16_t timGroup)
 {
-  if (m_queue.empty ())
+  NS_LOG_FUNCTION (this << packet << aid << timGroup);
+  StationBuffer &buffer = GetStationBuffer (aid);
+  if (timGroup >= m_timGroupSize.size ())
     {
-      return;
+      m_timGroupSize.resize (timGroup + 1, 0);
+    }
+  if (buffer.timGroup != timGroup)
+    {
+      // the station moved to another TIM group, move its frames along
+      m_timGroupSize[buffer.timGroup] -= buffer.queue.size ();
+      m_timGroupSize[timGroup] += buffer.queue.size ();
+      buffer.timGroup = timGroup;
     }
 
-  Time now = Simulator::Now ();
-  uint32_t n = 0;
-  for (PacketQueueI i = m_queue.begin (); i != m_queue.end (); )
+  if ((m_maxSize > 0 && m_size >= m_maxSize)
+      || (m_maxSizePerStation > 0 && buffer.queue.size () >= m_maxSizePerStation))
     {
-      if (i->tstamp + m_maxDelay > now)
+      if (m_dropPolicy == DROP_OLDEST && buffer.queue.size () > 0)
         {
-          i++;
+          Drop (buffer, DropReason::MacQueueSizeExceeded);
         }
       else
         {
-          i = m_queue.erase (i);
-          n++;
+          NS_LOG_DEBUG ("Buffer for AID " << aid << " full, dropping " << packet);
+          m_packetdropped (packet, DropReason::MacQueueSizeExceeded);
+          return;
         }
     }
-  m_size -= n;
-}
-
-Ptr<const Packet>
-S1gAPQueue::Dequeue (WifiMacHeader *hdr)
-{
-  Cleanup ();
-  if (!m_queue.empty ())
-    {
-      Item i = m_queue.front ();
-      m_queue.pop_front ();
-      m_size--;
-      *hdr = i.hdr;
-      return i.packet;
-    }
-  return 0;
-}
 
-Ptr<const Packet>
-S1gAPQueue::Peek (WifiMacHeader *hdr)
-{
-  Cleanup ();
-  if (!m_queue.empty ())
+  buffer.queue.push_back (Item (packet, hdr, Simulator::Now ()));
+  m_timGroupSize[timGroup]++;
+  m_size++;
+  if (buffer.queue.size () == 1)
     {
-      Item i = m_queue.front ();
-      *hdr = i.hdr;
-      return i.packet;
+      ScheduleAgeOut (aid);
     }
-  return 0;
 }
 
 Ptr<const Packet>
-S1gAPQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
-                                      WifiMacHeader::AddressType type, Mac48Address dest)
+S1gAPQueue::Dequeue (uint16_t aid, WifiMacHeader *hdr)
 {
-  Cleanup ();
-  Ptr<const Packet> packet = 0;
-  if (!m_queue.empty ())
+  NS_LOG_FUNCTION (this << aid);
+  if (!HasData (aid))
     {
-      PacketQueueI it;
-      for (it = m_queue.begin (); it != m_queue.end (); ++it)
-        {
-          if (it->hdr.IsQosData ())
-            {
-              if (GetAddressForPacket (type, it) == dest
-                  && it->hdr.GetQosTid () == tid)
-                {
-                  packet = it->packet;
-                  *hdr = it->hdr;
-                  m_queue.erase (it);
-                  m_size--;
-                  break;
-                }
-            }
-        }
+      return 0;
     }
-  return packet;
+  StationBuffer &buffer = m_stations[aid];
+  Item i = buffer.queue.front ();
+  RemoveFront (buffer);
+  *hdr = i.hdr;
+  ScheduleAgeOut (aid);
+  return i.packet;
 }
 
-Ptr<const Packet>
-S1gAPQueue::PeekByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
-                                   WifiMacHeader::AddressType type, Mac48Address dest, Time *timestamp)
+bool
+S1gAPQueue::HasData (uint16_t aid) const
 {
-  Cleanup ();
-  if (!m_queue.empty ())
-    {
-      PacketQueueI it;
-      for (it = m_queue.begin (); it != m_queue.end (); ++it)
-        {
-          if (it->hdr.IsQosData ())
-            {
-              if (GetAddressForPacket (type, it) == dest
-                  && it->hdr.GetQosTid () == tid)
-                {
-                  *hdr = it->hdr;
-                  *timestamp = it->tstamp;
-                  return it->packet;
-                }
-            }
-        }
-    }
-  return 0;
+  return aid < m_stations.size () && !m_stations[aid].queue.empty ();
 }
 
 bool
-S1gAPQueue::IsEmpty (void)
+S1gAPQueue::HasDataForTimGroup (uint16_t timGroup) const
 {
-  Cleanup ();
-  return m_queue.empty ();
+  return timGroup < m_timGroupSize.size () && m_timGroupSize[timGroup] > 0;
 }
 
 uint32_t
-S1gAPQueue::GetSize (void)
+S1gAPQueue::GetNPackets (uint16_t aid) const
 {
-  return m_size;
+  if (aid >= m_stations.size ())
+    {
+      return 0;
+    }
+  return m_stations[aid].queue.size ();
 }
 
 void
-S1gAPQueue::Flush (void)
+S1gAPQueue::RemoveFront (StationBuffer &buffer)
 {
-  m_queue.erase (m_queue.begin (), m_queue.end ());
-  m_size = 0;
+  buffer.queue.pop_front ();
+  m_timGroupSize[buffer.timGroup]--;
+  m_size--;
 }
 
-Mac48Address
-S1gAPQueue::GetAddressForPacket (enum WifiMacHeader::AddressType type, PacketQueueI it)
+void
+S1gAPQueue::Drop (StationBuffer &buffer, DropReason reason)
 {
-  if (type == WifiMacHeader::ADDR1)
-    {
-      return it->hdr.GetAddr1 ();
-    }
-  if (type == WifiMacHeader::ADDR2)
-    {
-      return it->hdr.GetAddr2 ();
-    }
-  if (type == WifiMacHeader::ADDR3)
-    {
-      return it->hdr.GetAddr3 ();
-    }
-  return 0;
+  Ptr<const Packet> packet = buffer.queue.front ().packet;
+  RemoveFront (buffer);
+  m_packetdropped (packet, reason);
 }
 
-bool
-S1gAPQueue::Remove (Ptr<const Packet> packet)
+void
+S1gAPQueue::ScheduleAgeOut (uint16_t aid)
 {
-  PacketQueueI it = m_queue.begin ();
-  for (; it != m_queue.end (); it++)
+  StationBuffer &buffer = m_stations[aid];
+  buffer.ageOutEvent.Cancel ();
+  if (buffer.queue.empty ())
     {
-      if (it->packet == packet)
-        {
-          m_queue.erase (it);
-          m_size--;
-          return true;
-        }
+      return;
     }
-  return false;
+  Time expiry = buffer.queue.front ().tstamp + m_maxDelay;
+  Time delay = expiry > Simulator::Now () ? expiry - Simulator::Now () : Seconds (0);
+  buffer.ageOutEvent = Simulator::Schedule (delay, &S1gAPQueue::AgeOut, this, aid);
 }
 
 void
-S1gAPQueue::PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr)
+S1gAPQueue::AgeOut (uint16_t aid)
 {
-  Cleanup ();
-  if (m_size == m_maxSize)
+  NS_LOG_FUNCTION (this << aid);
+  StationBuffer &buffer = m_stations[aid];
+  Time now = Simulator::Now ();
+  while (!buffer.queue.empty () && buffer.queue.front ().tstamp + m_maxDelay <= now)
     {
-      return;
+      Drop (buffer, DropReason::MacQueueDelayExceeded);
     }
-  Time now = Simulator::Now ();
-  m_queue.push_front (Item (packet, hdr, now));
-  m_size++;
+  ScheduleAgeOut (aid);
 }
 
-uint32_t
-S1gAPQueue::GetNPacketsByTidAndAddress (uint8_t tid, WifiMacHeader::AddressType type,
-                                          Mac48Address addr)
+void
+S1gAPQueue::Flush (void)
 {
-  Cleanup ();
-  uint32_t nPackets = 0;
-  if (!m_queue.empty ())
+  for (std::vector<StationBuffer>::iterator it = m_stations.begin (); it != m_stations.end (); it++)
     {
-      PacketQueueI it;
-      for (it = m_queue.begin (); it != m_queue.end (); it++)
-        {
-          if (GetAddressForPacket (type, it) == addr)
-            {
-              if (it->hdr.IsQosData () && it->hdr.GetQosTid () == tid)
-                {
-                  nPackets++;
-                }
-            }
-        }
+      it->ageOutEvent.Cancel ();
+      it->queue.clear ();
     }
-  return nPackets;
+  m_timGroupSize.assign (m_timGroupSize.size (), 0);
+  m_size = 0;
 }
 
-Ptr<const Packet>
-S1gAPQueue::DequeueFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
-                                     const QosBlockedDestinations *blockedPackets)
+bool
+S1gAPQueue::IsEmpty (void) const
 {
-  Cleanup ();
-  Ptr<const Packet> packet = 0;
-  for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); it++)
-    {
-      if (!it->hdr.IsQosData ()
-          || !blockedPackets->IsBlocked (it->hdr.GetAddr1 (), it->hdr.GetQosTid ()))
-        {
-          *hdr = it->hdr;
-          timestamp = it->tstamp;
-          packet = it->packet;
-          m_queue.erase (it);
-          m_size--;
-          return packet;
-        }
-    }
-  return packet;
+  return m_size == 0;
 }
 
-Ptr<const Packet>
-S1gAPQueue::PeekFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
-                                  const QosBlockedDestinations *blockedPackets)
+uint32_t
+S1gAPQueue::GetSize (void) const
 {
-  Cleanup ();
-  for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); it++)
-    {
-      if (!it->hdr.IsQosData ()
-          || !blockedPackets->IsBlocked (it->hdr.GetAddr1 (), it->hdr.GetQosTid ()))
-        {
-          *hdr = it->hdr;
-          timestamp = it->tstamp;
-          return it->packet;
-        }
-    }
-  return 0;
+  return m_size;
 }
 
-} //namespace ns3
+} // namespace ns3
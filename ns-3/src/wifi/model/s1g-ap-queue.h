@@ -3,27 +3,53 @@
 #define S1G_AP_QUEUE_H
 
 #include <list>
-#include <utility>
+#include <vector>
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
 #include "ns3/object.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
 #include "wifi-mac-header.h"
+#include "drop-reason.h"
 
 namespace ns3 {
-class QosBlockedDestinations;
-
 
+/**
+ * \ingroup wifi
+ *
+ * Power save buffer of an S1G AP. Downlink frames for dozing stations are
+ * kept per AID until the station is awake (its RAW slot starts or it sends
+ * a PS-Poll).
+ *
+ * Whether there is data for an AID or for a TIM group is answered in
+ * constant time. The number of buffered frames can be bounded, in total
+ * and per station, and every station ages out its own frames after
+ * MaxDelay, so expired frames are never reported in the TIM.
+ */
 class S1gAPQueue : public Object
 {
 public:
+  typedef void (* PacketDroppedCallback)
+                  (Ptr<const Packet> packet, DropReason reason);
+
+  /**
+   * What to drop when a frame arrives and the buffer (or the buffer of
+   * the station) is full.
+   */
+  enum DropPolicy
+  {
+    DROP_NEWEST, //!< drop the arriving frame
+    DROP_OLDEST  //!< drop the oldest frame buffered for the same station
+  };
+
   static TypeId GetTypeId (void);
   S1gAPQueue ();
   ~S1gAPQueue ();
 
   /**
-   * Set the maximum queue size.
+   * Set the maximum number of frames buffered for all stations.
    *
-   * \param maxSize the maximum queue size
+   * \param maxSize the maximum queue size, 0 for no limit
    */
   void SetMaxSize (uint32_t maxSize);
   /**
@@ -46,162 +72,60 @@ public:
   Time GetMaxDelay (void) const;
 
   /**
-   * Enqueue the given packet and its corresponding WifiMacHeader at the <i>end</i> of the queue.
-   *
-   * \param packet the packet to be euqueued at the end
-   * \param hdr the header of the given packet
-   */
-  void Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr);
-  /**
-   * Enqueue the given packet and its corresponding WifiMacHeader at the <i>front</i> of the queue.
-   *
-   * \param packet the packet to be euqueued at the end
-   * \param hdr the header of the given packet
-   */
-  void PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr);
-  /**
-   * Dequeue the packet in the front of the queue.
-   *
-   * \param hdr the WifiMacHeader of the packet
+   * Buffer the given frame for a station.
    *
-   * \return the packet
+   * \param packet the packet to buffer
+   * \param hdr the header the packet will be sent with
+   * \param aid the AID of the destination station
+   * \param timGroup the TIM group the station belongs to
    */
-  Ptr<const Packet> Dequeue (WifiMacHeader *hdr);
+  void Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr, uint16_t aid, uint16_t timGroup);
   /**
-   * Peek the packet in the front of the queue. The packet is not removed.
+   * Remove the oldest frame buffered for a station.
    *
-   * \param hdr the WifiMacHeader of the packet
+   * \param aid the AID of the station
+   * \param hdr the header of the frame
    *
-   * \return the packet
+   * \return the packet, or 0 if nothing is buffered for the station
    */
-  Ptr<const Packet> Peek (WifiMacHeader *hdr);
-  /**
-   * Searchs and returns, if is present in this queue, first packet having
-   * address indicated by <i>type</i> equals to <i>addr</i>, and tid
-   * equals to <i>tid</i>. This method removes the packet from this queue.
-   * Is typically used by ns3::EdcaTxopN in order to perform correct MSDU
-   * aggregation (A-MSDU).
-   *
-   * \param hdr the header of the dequeued packet
-   * \param tid the given TID
-   * \param type the given address type
-   * \param addr the given destination
-   *
-   * \return packet
-   */
-  Ptr<const Packet> DequeueByTidAndAddress (WifiMacHeader *hdr,
-                                            uint8_t tid,
-                                            WifiMacHeader::AddressType type,
-                                            Mac48Address addr);
-  /**
-   * Searchs and returns, if is present in this queue, first packet having
-   * address indicated by <i>type</i> equals to <i>addr</i>, and tid
-   * equals to <i>tid</i>. This method doesn't remove the packet from this queue.
-   * Is typically used by ns3::EdcaTxopN in order to perform correct MSDU
-   * aggregation (A-MSDU).
-   *
-   * \param hdr the header of the dequeued packet
-   * \param tid the given TID
-   * \param type the given address type
-   * \param addr the given destination
-   * \param timestamp
-   *
-   * \return packet
-   */
-  Ptr<const Packet> PeekByTidAndAddress (WifiMacHeader *hdr,
-                                         uint8_t tid,
-                                         WifiMacHeader::AddressType type,
-                                         Mac48Address addr,
-                                         Time *timestamp);
-  /**
-   * If exists, removes <i>packet</i> from queue and returns true. Otherwise it
-   * takes no effects and return false. Deletion of the packet is
-   * performed in linear time (O(n)).
-   *
-   * \param packet the packet to be removed
-   *
-   * \return true if the packet was removed, false otherwise
-   */
-  bool Remove (Ptr<const Packet> packet);
-  /**
-   * Returns number of QoS packets having tid equals to <i>tid</i> and address
-   * specified by <i>type</i> equals to <i>addr</i>.
-   *
-   * \param tid the given TID
-   * \param type the given address type
-   * \param addr the given destination
-   *
-   * \return the number of QoS packets
-   */
-  uint32_t GetNPacketsByTidAndAddress (uint8_t tid,
-                                       WifiMacHeader::AddressType type,
-                                       Mac48Address addr);
+  Ptr<const Packet> Dequeue (uint16_t aid, WifiMacHeader *hdr);
+
   /**
-   * Returns first available packet for transmission. A packet could be no available
-   * if it's a QoS packet with a tid and an address1 fields equal to <i>tid</i> and <i>addr</i>
-   * respectively that index a pending agreement in the BlockAckManager object.
-   * So that packet must not be transmitted until reception of an ADDBA response frame from station
-   * addressed by <i>addr</i>. This method removes the packet from queue.
-   *
-   * \param hdr the header of the dequeued packet
-   * \param tStamp
-   * \param blockedPackets
-   *
-   * \return packet
+   * \param aid the AID of the station
+   * \return true if frames are buffered for the station
    */
-  Ptr<const Packet> DequeueFirstAvailable (WifiMacHeader *hdr,
-                                           Time &tStamp,
-                                           const QosBlockedDestinations *blockedPackets);
+  bool HasData (uint16_t aid) const;
   /**
-   * Returns first available packet for transmission. The packet isn't removed from queue.
-   *
-   * \param hdr the header of the dequeued packet
-   * \param tStamp
-   * \param blockedPackets
-   *
-   * \return packet
+   * \param timGroup the TIM group
+   * \return true if frames are buffered for any station of the TIM group
    */
-  Ptr<const Packet> PeekFirstAvailable (WifiMacHeader *hdr,
-                                        Time &tStamp,
-                                        const QosBlockedDestinations *blockedPackets);
+  bool HasDataForTimGroup (uint16_t timGroup) const;
   /**
-   * Flush the queue.
+   * \param aid the AID of the station
+   * \return the number of frames buffered for the station
    */
-  void Flush (void);
+  uint32_t GetNPackets (uint16_t aid) const;
 
   /**
-   * Return if the queue is empty.
-   *
-   * \return true if the queue is empty, false otherwise
+   * Drop everything that is buffered.
    */
-  bool IsEmpty (void);
+  void Flush (void);
+  bool IsEmpty (void) const;
   /**
-   * Return the current queue size.
-   *
-   * \return the current queue size
+   * \return the number of frames buffered for all stations
    */
-  uint32_t GetSize (void);
-
+  uint32_t GetSize (void) const;
 
 protected:
-  /**
-   * Clean up the queue by removing packets that exceeded the maximum delay.
-   */
-  virtual void Cleanup (void);
+  virtual void DoDispose (void);
 
+private:
   /**
    * A struct that holds information about a packet for putting
    * in a packet queue.
    */
   struct Item
   {
-    /**
-     * Create a struct with the given parameters.
-     *
-     * \param packet
-     * \param hdr
-     * \param tstamp
-     */
     Item (Ptr<const Packet> packet,
           const WifiMacHeader &hdr,
           Time tstamp);
@@ -210,32 +134,37 @@ protected:
     Time tstamp;              //!< timestamp when the packet arrived at the queue
   };
 
-  /**
-   * typedef for packet (struct Item) queue.
-   */
   typedef std::list<struct Item> PacketQueue;
+
   /**
-   * typedef for packet (struct Item) queue reverse iterator.
-   */
-  typedef std::list<struct Item>::reverse_iterator PacketQueueRI;
-  /**
-   * typedef for packet (struct Item) queue iterator.
+   * Frames buffered for a single station, in arrival order.
    */
-  typedef std::list<struct Item>::iterator PacketQueueI;
+  struct StationBuffer
+  {
+    StationBuffer ();
+    PacketQueue queue;
+    uint16_t timGroup;
+    EventId ageOutEvent; //!< fires when the oldest frame expires
+  };
+
+  StationBuffer & GetStationBuffer (uint16_t aid);
+  void Drop (StationBuffer &buffer, DropReason reason);
+  void RemoveFront (StationBuffer &buffer);
   /**
-   * Return the appropriate address for the given packet (given by PacketQueue iterator).
-   *
-   * \param type
-   * \param it
-   *
-   * \return the address
+   * Drop the expired frames of a station and wait for the next one to expire.
    */
-  Mac48Address GetAddressForPacket (enum WifiMacHeader::AddressType type, PacketQueueI it);
+  void AgeOut (uint16_t aid);
+  void ScheduleAgeOut (uint16_t aid);
+
+  std::vector<StationBuffer> m_stations; //!< indexed by AID
+  std::vector<uint32_t> m_timGroupSize;  //!< number of buffered frames per TIM group
+  uint32_t m_size;                       //!< Current queue size
+  uint32_t m_maxSize;                    //!< Queue capacity
+  uint32_t m_maxSizePerStation;          //!< Queue capacity per station
+  enum DropPolicy m_dropPolicy;
+  Time m_maxDelay;                       //!< Time to live for packets in the queue
 
-  PacketQueue m_queue; //!< Packet (struct Item) queue
-  uint32_t m_size;     //!< Current queue size
-  uint32_t m_maxSize;  //!< Queue capacity
-  Time m_maxDelay;     //!< Time to live for packets in the queue
+  TracedCallback<Ptr<const Packet>, DropReason> m_packetdropped;
 };
 
 } //namespace ns3
@@ -12,11 +12,13 @@
 #include "mac-tx-middle.h"
 #include "mgt-headers.h"
 #include "extension-headers.h"
+#include "s1g-beacon-view.h"
 #include "mac-low.h"
 #include "amsdu-subframe-header.h"
 #include "msdu-aggregator.h"
 #include "ns3/uinteger.h"
 #include "wifi-mac-queue.h"
+#include <cmath>
 
 namespace ns3 {
 
@@ -112,6 +114,11 @@ TypeId S1gApWifiMac::GetTypeId(void) {
 					MakeTraceSourceAccessor(&S1gApWifiMac::m_rawSlotStarted),
 					"ns3::S1gApWifiMac::RawSlotStartedCallback")
 
+			.AddTraceSource("RAWSlotEnded",
+					"Fired when a RAW slot has ended",
+					MakeTraceSourceAccessor(&S1gApWifiMac::m_rawSlotEnded),
+					"ns3::S1gApWifiMac::RawSlotEndedCallback")
+
 			.AddTraceSource("PacketToTransmitReceivedFromUpperLayer",
 					"Fired when packet is received from the upper layer",
 					MakeTraceSourceAccessor(
@@ -119,11 +126,73 @@ TypeId S1gApWifiMac::GetTypeId(void) {
 					"ns3::S1gApWifiMac::PacketToTransmitReceivedFromUpperLayerCallback")
 
 			.AddAttribute("MaxTimeInQueue",
-					"The max. time a packet stays in the DCA queue before it's dropped",
+					"The max. time a packet stays in the DCA queue or the power save buffer before it's dropped",
 					TimeValue(MilliSeconds(10000)),
 					MakeTimeAccessor(&S1gApWifiMac::m_maxTimeInQueue),
 					MakeTimeChecker())
 
+			.AddAttribute("PRAWPeriod",
+					"Number of DTIM periods between two occurrences of the periodic RAW of a TIM group",
+					UintegerValue(1),
+					MakeUintegerAccessor(&S1gApWifiMac::m_prawPeriod),
+					MakeUintegerChecker<uint32_t>(1, 255))
+
+			.AddAttribute("PRAWValidity",
+					"Number of periodic RAW occurrences a STA may follow without listening to beacons, 0 disables periodic RAW",
+					UintegerValue(0),
+					MakeUintegerAccessor(&S1gApWifiMac::m_prawValidity),
+					MakeUintegerChecker<uint32_t>(0, 255))
+
+			.AddAttribute("PsPollDelivery",
+					"Announce the buffered frames per station in the TIM of the TIM group beacon and deliver them once the "
+							"station polls with a PS-Poll, instead of assuming stations of an announced TIM group listen in their slot.",
+					BooleanValue(false),
+					MakeBooleanAccessor(&S1gApWifiMac::m_psPollDelivery),
+					MakeBooleanChecker())
+
+			.AddAttribute("DistributedAuthentication",
+					"Announce distributed instead of centralized authentication control. "
+							"STAs then pick a random slot of a transmission interval that doubles for every attempt.",
+					BooleanValue(false),
+					MakeBooleanAccessor(&S1gApWifiMac::m_distributedAuthentication),
+					MakeBooleanChecker())
+
+			.AddAttribute("AuthSlotDuration",
+					"Slot duration of the distributed authentication control in TUs, "
+							"0 scales it with the number of STAs that are not associated yet",
+					UintegerValue(0),
+					MakeUintegerAccessor(&S1gApWifiMac::m_authSlotDuration),
+					MakeUintegerChecker<uint32_t>(0, 127))
+
+			.AddAttribute("AuthMinInterval",
+					"Initial transmission interval of the distributed authentication control, in slots",
+					UintegerValue(8),
+					MakeUintegerAccessor(&S1gApWifiMac::m_authMinInterval),
+					MakeUintegerChecker<uint32_t>(1, 255))
+
+			.AddAttribute("AuthMaxInterval",
+					"Maximum transmission interval of the distributed authentication control, in slots",
+					UintegerValue(255),
+					MakeUintegerAccessor(&S1gApWifiMac::m_authMaxInterval),
+					MakeUintegerChecker<uint32_t>(1, 255))
+
+			.AddAttribute("AuthMaxMgtQueueSize",
+					"Number of queued management frames above which the centralized authentication control admits fewer STAs",
+					UintegerValue(10),
+					MakeUintegerAccessor(&S1gApWifiMac::m_authMaxMgtQueueSize),
+					MakeUintegerChecker<uint32_t>())
+
+			.AddTraceSource("AssociationThroughput",
+					"Fired with every beacon, reports the association requests and completed associations since the previous beacon",
+					MakeTraceSourceAccessor(&S1gApWifiMac::m_associationThroughput),
+					"ns3::S1gApWifiMac::AssociationThroughputCallback")
+
+			.AddAttribute("PowerSaveBuffer",
+					"The buffer holding downlink frames until the station is awake in its RAW slot.",
+					PointerValue(),
+					MakePointerAccessor(&S1gApWifiMac::GetPowerSaveBuffer),
+					MakePointerChecker<S1gAPQueue>())
+
 					;
 
 	return tid;
@@ -139,11 +208,14 @@ S1gApWifiMac::S1gApWifiMac() {
 	m_beaconDca->SetManager(m_dcfManager);
 	m_beaconDca->SetTxMiddle(m_txMiddle);
 
+	m_psBuffer = CreateObject<S1gAPQueue>();
+
 	//Let the lower layers know that we are acting as an AP.
 	SetTypeOfStation(AP);
 
 	m_enableBeaconGeneration = false;
 	AuthenThreshold = 0;
+	m_assocSuccessRate = 1;
 	//m_SlotFormat = 0;
 }
 
@@ -154,6 +226,8 @@ S1gApWifiMac::~S1gApWifiMac() {
 void S1gApWifiMac::DoDispose() {
 	NS_LOG_FUNCTION(this);
 	m_beaconDca = 0;
+	m_psBuffer->Dispose();
+	m_psBuffer = 0;
 	m_enableBeaconGeneration = false;
 
 	if (strategy != nullptr)
@@ -243,6 +317,8 @@ void S1gApWifiMac::SetWifiRemoteStationManager(
 	}
 
 	RegularWifiMac::SetWifiRemoteStationManager(stationManager);
+	// the beacon airtime depends on the rate used for broadcast frames
+	m_beaconTemplates.clear();
 }
 
 void S1gApWifiMac::SetLinkUpCallback(Callback<void> linkUp) {
@@ -262,6 +338,7 @@ void S1gApWifiMac::SetBeaconInterval(Time interval) {
 				"beacon interval should be multiple of 1024us (802.11 time unit), see IEEE Std. 802.11-2012");
 	}
 	m_beaconInterval = interval;
+	m_beaconTemplates.clear();
 }
 
 void S1gApWifiMac::SetRawGroupInterval(uint32_t interval) {
@@ -277,22 +354,26 @@ void S1gApWifiMac::SetTotalStaNum(uint32_t num) {
 void S1gApWifiMac::SetSlotFormat(uint32_t format) {
 	NS_ASSERT(format <= 1);
 	m_SlotFormat = format;
+	m_beaconTemplates.clear();
 }
 
 void S1gApWifiMac::SetSlotCrossBoundary(uint32_t cross) {
 	NS_ASSERT(cross <= 1);
 	m_slotCrossBoundary = cross;
+	m_beaconTemplates.clear();
 }
 
 void S1gApWifiMac::SetSlotDurationCount(uint32_t count) {
 	NS_ASSERT(
 			(!m_SlotFormat & (count < 256)) || (m_SlotFormat & (count < 2048)));
 	m_slotDurationCount = count;
+	m_beaconTemplates.clear();
 }
 
 void S1gApWifiMac::SetSlotNum(uint32_t count) {
 	NS_ASSERT((!m_SlotFormat & (count < 64)) || (m_SlotFormat & (count < 8)));
 	m_slotNum = count;
+	m_beaconTemplates.clear();
 }
 
 void S1gApWifiMac::StartBeaconing(void) {
@@ -308,16 +389,15 @@ int64_t S1gApWifiMac::AssignStreams(int64_t stream) {
 
 void S1gApWifiMac::ForwardDown(Ptr<const Packet> packet, Mac48Address from, Mac48Address to) {
 	NS_LOG_FUNCTION(this << packet << from << to);
+	ForwardDown(packet, from, to, GetTidForPacket(packet));
+}
+
+uint8_t S1gApWifiMac::GetTidForPacket(Ptr<const Packet> packet) const {
 	//If we are not a QoS AP then we definitely want to use AC_BE to
 	//transmit the packet. A TID of zero will map to AC_BE (through \c
 	//QosUtilsMapTidToAc()), so we use that as our default here.
 	uint8_t tid = 0;
 
-	uint16_t aId = macToAIDMap[to];
-	pendingDataSizeForStations[aId - 1]--;
-	LOG_TRAFFIC(
-			Simulator::Now().GetMicroSeconds() << " Data for [" << aId << "] --" << std::endl);
-
 	//If we are a QoS AP then we attempt to get a TID for this packet
 	if (m_qosSupported) {
 		tid = QosUtilsGetTidForPacket(packet);
@@ -328,13 +408,10 @@ void S1gApWifiMac::ForwardDown(Ptr<const Packet> packet, Mac48Address from, Mac4
 			tid = 0;
 		}
 	}
-
-	ForwardDown(packet, from, to, tid);
+	return tid;
 }
 
-void S1gApWifiMac::ForwardDown(Ptr<const Packet> packet, Mac48Address from,	Mac48Address to, uint8_t tid) {
-	NS_LOG_FUNCTION(
-			this << packet << from << to << static_cast<uint32_t> (tid));
+WifiMacHeader S1gApWifiMac::CreateDataHeader(Mac48Address from, Mac48Address to, uint8_t tid) const {
 	WifiMacHeader hdr;
 
 	//For now, an AP that supports QoS does not support non-QoS
@@ -364,9 +441,17 @@ void S1gApWifiMac::ForwardDown(Ptr<const Packet> packet, Mac48Address from,	Mac4
 	hdr.SetAddr3(from);
 	hdr.SetDsFrom();
 	hdr.SetDsNotTo();
+	return hdr;
+}
+
+void S1gApWifiMac::ForwardDown(Ptr<const Packet> packet, Mac48Address from,	Mac48Address to, uint8_t tid) {
+	NS_LOG_FUNCTION(
+			this << packet << from << to << static_cast<uint32_t> (tid));
+	WifiMacHeader hdr = CreateDataHeader(from, to, tid);
 
-	if (macToAIDMap.find(to) != macToAIDMap.end()) {
-		auto aId = macToAIDMap[to];
+	auto it = macToAIDMap.find(to);
+	if (it != macToAIDMap.end()) {
+		auto aId = it->second;
 
 		auto targetTIMGroup = strategy->GetTIMGroupFromAID(aId,
 				m_rawGroupInterval);
@@ -379,20 +464,44 @@ void S1gApWifiMac::ForwardDown(Ptr<const Packet> packet, Mac48Address from,	Mac4
 		if (m_qosSupported) {
 			//Sanity check that the TID is valid
 			NS_ASSERT(tid < 8);
-			m_edca[QosUtilsMapTidToAc(tid)]->Queue(packet, hdr);
+			GetEdcaForAc(QosUtilsMapTidToAc(tid))->Queue(packet, hdr);
 		} else {
 			m_dca->Queue(packet, hdr);
 		}
 	}
 }
 
+void S1gApWifiMac::BufferDown(Ptr<const Packet> packet, Mac48Address from, Mac48Address to, uint16_t aId) {
+	NS_LOG_FUNCTION(this << packet << from << to << aId);
+	WifiMacHeader hdr = CreateDataHeader(from, to, GetTidForPacket(packet));
+	m_psBuffer->Enqueue(packet, hdr, aId,
+			strategy->GetTIMGroupFromAID(aId, m_rawGroupInterval));
+}
+
+void S1gApWifiMac::DeliverBufferedFrames(uint16_t aId) {
+	NS_LOG_FUNCTION(this << aId);
+	auto targetTIMGroup = strategy->GetTIMGroupFromAID(aId, m_rawGroupInterval);
+	auto targetSlotIndex = strategy->GetSlotIndexFromAID(aId, m_slotNum);
+
+	WifiMacHeader hdr;
+	while (m_psBuffer->HasData(aId)) {
+		Ptr<const Packet> packet = m_psBuffer->Dequeue(aId, &hdr);
+		LOG_TRAFFIC(
+				Simulator::Now().GetMicroSeconds() << " Data for [" << aId << "] --" << std::endl);
+		rawSlotsDCA[targetTIMGroup * m_slotNum + targetSlotIndex]->Queue(packet, hdr);
+	}
+}
+
 void S1gApWifiMac::Enqueue(Ptr<const Packet> packet, Mac48Address to, Mac48Address from) {
 	NS_LOG_FUNCTION(this << packet << to << from);
 	if (to.IsBroadcast() || to.IsMulticast6() || m_stationManager->IsAssociated(to)) {  //ami
-		uint16_t aId = macToAIDMap[to];
-
-		pendingDataSizeForStations[aId - 1]++;
-		LOG_TRAFFIC(Simulator::Now().GetMicroSeconds() << " Data for [" << aId << "] ++");
+		auto it = macToAIDMap.find(to);
+		if (it == macToAIDMap.end()) {
+			// group addressed or not (yet) known by AID, no power save buffering
+			ForwardDown(packet, from, to);
+			return;
+		}
+		uint16_t aId = it->second;
 
 		uint8_t slotIndex = strategy->GetSlotIndexFromAID(aId, m_slotNum);
 		// RAW period start is 0 at the moment
@@ -404,7 +513,7 @@ void S1gApWifiMac::Enqueue(Ptr<const Packet> packet, Mac48Address to, Mac48Addre
 		Time timeRemaining = Time(0);
 		bool inSlot = false;
 
-		if (!m_alwaysScheduleForNextSlot && staIsActiveDuringCurrentCycle[aId - 1]) {
+		if (!m_alwaysScheduleForNextSlot && (staIsActiveDuringCurrentCycle[aId] || IsPRAWOccurrence())) {
 
 			// station is active in its respective slot until at least the next DTIM beacon is sent
 			// calculate if we are still inside the appropriate slot and transmit immediately if we are
@@ -430,45 +539,10 @@ void S1gApWifiMac::Enqueue(Ptr<const Packet> packet, Mac48Address to, Mac48Addre
 		m_packetToTransmitReceivedFromUpperLayer(packet, to, schedulePacketForNextSlot, inSlot, timeRemaining);
 
 		if (schedulePacketForNextSlot) {
-			int remainingBeacons = 0;
-			int curStart = current_aid_start;
-			int curTIMBeaconNr = m_currentBeaconTIMGroup;
-			bool dtimBeaconPassed = false;
-
-			while (!(curTIMBeaconNr == timGroup && dtimBeaconPassed)) {
-
-				remainingBeacons++;
-				curTIMBeaconNr = (curTIMBeaconNr + 1);
-				curStart += m_rawGroupInterval;
-				if (curStart + m_rawGroupInterval > m_totalStaNum)
-					curStart = 1;
-
-				// ensure that the packet is enqueued to be sent AFTER
-				// a DTIM beacon has passed or the STA might not be listening
-				// because the bitmap of the previous DTIM will have indicated
-				// there's no data for that group
-
-				if (curTIMBeaconNr >= m_nrOfTIMGroups) {
-					curTIMBeaconNr = 0;
-					dtimBeaconPassed = true;
-				}
-			}
-
-			//std::cout << "Current TIM beacon " << std::to_string(m_currentBeaconTIMGroup) << ", scheduling packet in " << remainingBeacons << " beacons" << std::endl;
-			Time packetSendTime = m_beaconInterval * remainingBeacons;
-			packetSendTime += slotTimeOffset;
-
-			//align with beacon interval
-			packetSendTime -= (Simulator::Now() - lastBeaconTime);
-
-			// choose a time between 0 and 50% of the slot time
-			//packetSendTime = packetSendTime + MicroSeconds(rand() % (strategy->GetSlotDuration(m_slotDurationCount) / 2).GetMicroSeconds());
-
-			// transmit in second half of RAW window
-			//packetSendTime += MilliSeconds(m_beaconInterval/2);
-			void (S1gApWifiMac::*fp)(Ptr<const Packet>, Mac48Address,
-					Mac48Address) = &S1gApWifiMac::ForwardDown;
-			Simulator::Schedule(packetSendTime, fp, this, packet, from, to);
+			// keep it until the station wakes up for its slot after the next DTIM
+			// announcing the data, or until it polls for it
+			LOG_TRAFFIC(Simulator::Now().GetMicroSeconds() << " Data for [" << aId << "] ++");
+			BufferDown(packet, from, to, aId);
 		} else {
 			// still within the slot, transmit immediately, gogogo
 			ForwardDown(packet, from, to);
@@ -484,6 +558,10 @@ void S1gApWifiMac::Enqueue(Ptr<const Packet> packet, Mac48Address to) {
 	Enqueue(packet, to, m_low->GetAddress());
 }
 
+Ptr<S1gAPQueue> S1gApWifiMac::GetPowerSaveBuffer(void) const {
+	return m_psBuffer;
+}
+
 bool S1gApWifiMac::SupportsSendFrom(void) const {
 	NS_LOG_FUNCTION(this);
 	return true;
@@ -576,12 +654,28 @@ void S1gApWifiMac::SendAssocResp(Mac48Address to, bool success) {
 	hdr.SetDsNotFrom();
 	hdr.SetDsNotTo();
 	Ptr<Packet> packet = Create<Packet>();
-	MgtAssocResponseHeader assoc;
+	MgtAssocResponseHeader assoc = CreateAssocResp(to, success);
 
-	uint16_t aid = strategy->GetAIDFromMacAddress(to);
-	// keep track of a mac -> aid map
-	macToAIDMap[to] = aid;
+	if (m_htSupported) {
+		hdr.SetNoOrder();
+	}
+	packet->AddHeader(assoc);
 
+	//The standard is not clear on the correct queue for management
+	//frames if we are a QoS AP. The approach taken here is to always
+	//use the DCF for these regardless of whether we have a QoS
+	//association or not.
+	m_dca->Queue(packet, hdr);
+}
+
+MgtAssocResponseHeader S1gApWifiMac::CreateAssocResp(Mac48Address to, bool success) {
+	MgtAssocResponseHeader assoc;
+
+	uint16_t aid = 0;
+	if (success) {
+		aid = AllocateAID(to);
+		success = (aid != 0);
+	}
 	assoc.SetAID(aid); //
 	StatusCode code;
 	if (success) {
@@ -594,15 +688,220 @@ void S1gApWifiMac::SendAssocResp(Mac48Address to, bool success) {
 
 	if (m_htSupported) {
 		assoc.SetHtCapabilities(GetHtCapabilities());
-		hdr.SetNoOrder();
 	}
-	packet->AddHeader(assoc);
+	return assoc;
+}
 
-	//The standard is not clear on the correct queue for management
-	//frames if we are a QoS AP. The approach taken here is to always
-	//use the DCF for these regardless of whether we have a QoS
-	//association or not.
-	m_dca->Queue(packet, hdr);
+bool S1gApWifiMac::AcceptAssocRequest(Mac48Address from, const MgtAssocRequestHeader& assocReq) {
+	//first, verify that the the station's supported
+	//rate set is compatible with our Basic Rate set
+	SupportedRates rates = assocReq.GetSupportedRates();
+	for (uint32_t i = 0; i < m_stationManager->GetNBasicModes(); i++) {
+		WifiMode mode = m_stationManager->GetBasicMode(i);
+		if (!rates.IsSupportedRate(mode.GetDataRate())) {
+			return false;
+		}
+	}
+	if (m_htSupported) {
+		//check that the STA supports all MCSs in Basic MCS Set
+		HtCapabilities htcapabilities = assocReq.GetHtCapabilities();
+		for (uint32_t i = 0; i < m_stationManager->GetNBasicMcs(); i++) {
+			uint8_t mcs = m_stationManager->GetBasicMcs(i);
+			if (!htcapabilities.IsSupportedMcs(mcs)) {
+				return false;
+			}
+		}
+	}
+
+	//station supports all rates in Basic Rate Set.
+	//record all its supported modes in its associated WifiRemoteStation
+	for (uint32_t j = 0; j < m_phy->GetNModes(); j++) {
+		WifiMode mode = m_phy->GetMode(j);
+		if (rates.IsSupportedRate(mode.GetDataRate())) {
+			m_stationManager->AddSupportedMode(from, mode);
+		}
+	}
+	if (m_htSupported) {
+		HtCapabilities htcapabilities = assocReq.GetHtCapabilities();
+		m_stationManager->AddStationHtCapabilities(from, htcapabilities);
+		for (uint32_t j = 0; j < m_phy->GetNMcs(); j++) {
+			uint8_t mcs = m_phy->GetMcs(j);
+			if (htcapabilities.IsSupportedMcs(mcs)) {
+				m_stationManager->AddSupportedMcs(from, mcs);
+			}
+		}
+	}
+	return true;
+}
+
+MgtAssocResponseHeader S1gApWifiMac::PreAssociate(Mac48Address from, const MgtAssocRequestHeader& assocReq) {
+	NS_LOG_FUNCTION(this << from);
+	bool success = AcceptAssocRequest(from, assocReq);
+	MgtAssocResponseHeader assoc = CreateAssocResp(from, success);
+	if (assoc.GetStatusCode().IsSuccess()) {
+		// as if the association response was acknowledged
+		m_stationManager->RecordWaitAssocTxOk(from);
+		m_stationManager->RecordGotAssocTxOk(from);
+		m_nrOfAssociatedStas++;
+	}
+	return assoc;
+}
+
+uint16_t S1gApWifiMac::AllocateAID(Mac48Address address) {
+	// a reassociating STA keeps its AID
+	auto it = macToAIDMap.find(address);
+	if (it != macToAIDMap.end())
+		return it->second;
+
+	// STAs are numbered by the lower bits of their MAC address, keep that
+	// order so the TIM groups and slots are filled the same way
+	uint32_t maxStations = strategy->GetMaxNumberOfStations(m_rawGroupInterval);
+	uint32_t index = strategy->GetAIDFromMacAddress(address) - 1;
+	uint16_t aid = 0;
+	if (index < maxStations) {
+		aid = strategy->GetAIDFromStationIndex(index, m_rawGroupInterval);
+		if (m_aidToMac[aid] != Mac48Address())
+			aid = 0;
+	}
+	// otherwise take the first free AID
+	for (uint32_t i = 0; aid == 0 && i < maxStations; i++) {
+		uint16_t candidate = strategy->GetAIDFromStationIndex(i, m_rawGroupInterval);
+		if (m_aidToMac[candidate] == Mac48Address())
+			aid = candidate;
+	}
+	if (aid == 0) {
+		NS_LOG_DEBUG("No AID left for " << address);
+		return 0;
+	}
+
+	macToAIDMap[address] = aid;
+	m_aidToMac[aid] = address;
+	return aid;
+}
+
+void S1gApWifiMac::ReleaseAID(Mac48Address address) {
+	auto it = macToAIDMap.find(address);
+	if (it == macToAIDMap.end())
+		return;
+	uint16_t aid = it->second;
+	m_aidToMac[aid] = Mac48Address();
+	staIsActiveDuringCurrentCycle[aid] = false;
+	macToAIDMap.erase(it);
+}
+
+void S1gApWifiMac::BuildBeaconTemplates(const WifiMacHeader& hdr) {
+	NS_LOG_FUNCTION(this);
+	m_beaconTemplates.clear();
+	m_beaconTemplates.resize(m_nrOfTIMGroups);
+
+	// broadcast so disable rts, ack & fragmentation
+	MacLowTransmissionParameters params;
+	params.DisableRts();
+	params.DisableAck();
+	params.DisableNextData();
+
+	for (int group = 0; group < m_nrOfTIMGroups; group++) {
+		BeaconTemplate& beaconTemplate = m_beaconTemplates[group];
+		S1gBeaconHeader beacon;
+
+		S1gBeaconCompatibility compatibility;
+		compatibility.SetBeaconInterval(m_beaconInterval.GetMicroSeconds());
+		beacon.SetBeaconCompatibility(compatibility);
+
+		RPS::RawAssignment raw;
+		uint8_t control = 0;
+		raw.SetRawControl(control); //support paged STA or not
+		raw.SetSlotFormat(m_SlotFormat);
+		raw.SetSlotCrossBoundary(m_slotCrossBoundary);
+		raw.SetSlotDurationCount(m_slotDurationCount);
+		raw.SetSlotNum(m_slotNum);
+		raw.SetRawStart(0); // immediately after the beacon;
+		raw.SetRawGroup(0); // patched for every beacon
+		raw.SetChannelInd(0);
+		raw.SetPRAW(0);
+		if (m_prawValidity > 0) {
+			// the start offset is patched for every beacon
+			raw.SetPeriodicRaw(GetPRAWPeriodicity(), m_prawValidity, 0);
+		}
+		RPS rps;
+		rps.SetRawAssignment(raw);
+		beacon.SetRPS(rps);
+
+		AuthenticationCtrl AuthenCtrl;
+		AuthenCtrl.SetControlType(m_distributedAuthentication);
+		if (m_distributedAuthentication) {
+			AuthenCtrl.SetSlotDuration(GetAuthSlotDuration()); // patched for every beacon
+			AuthenCtrl.SetMinInterval(m_authMinInterval);
+			AuthenCtrl.SetMaxInterval(std::max(m_authMaxInterval, m_authMinInterval));
+		} else {
+			AuthenCtrl.SetThreshold(AuthenThreshold); // patched for every beacon
+		}
+		beacon.SetAuthCtrl(AuthenCtrl);
+
+		// the DTIM counters never change for a given TIM group, only the bitmap
+		// of the page slice beacons does
+		TIM tim;
+		tim.SetDTIMPeriod(m_nrOfTIMGroups);
+		tim.SetDTIMCount(group == 0 ? 0 : m_nrOfTIMGroups - group);
+		if (group % TIM::GROUPS_PER_PAGE_SLICE == 0) {
+			uint16_t firstAId = strategy->GetFirstAIDOfTIMGroup(group, m_rawGroupInterval);
+			tim.SetPageSlice(S1gStrategy::GetPageFromAID(firstAId), group / TIM::GROUPS_PER_PAGE_SLICE);
+		}
+		tim.SetPartialVBitmap(0);
+		if (m_psPollDelivery) {
+			// one bit per station of the TIM group, DoInitialize made sure it fits the element
+			tim.SetStationBitmapSize(strategy->GetTIMGroupSize(m_rawGroupInterval));
+		}
+		beacon.SetTIM(tim);
+
+		beaconTemplate.bytes.Build(beacon);
+		beaconTemplate.view = Create<S1gBeaconView>(beacon);
+
+		// only the content changes between beacons, not the size, so the airtime
+		// can be calculated once
+		Ptr<Packet> packet = Create<Packet>();
+		packet->AddHeader(beaconTemplate.bytes);
+		beaconTemplate.txTime = m_low->CalculateOverallTxTime(packet, &hdr, params);
+	}
+}
+
+void S1gApWifiMac::UpdateAuthenThreshold(void) {
+	// STAs draw a value in [0, 999] once and only send association requests
+	// while it is below the threshold
+	const uint16_t maxThreshold = 1000;
+	const uint16_t step = 50;
+
+	if (m_nrOfAssocRequests > 0) {
+		double rate = std::min(1.0, (double) m_nrOfAssociations / m_nrOfAssocRequests);
+		m_assocSuccessRate = 0.5 * m_assocSuccessRate + 0.5 * rate;
+	}
+
+	uint32_t mgtQueueSize = m_dca->GetQueue()->GetSize();
+	if (mgtQueueSize >= m_authMaxMgtQueueSize) {
+		// the responses do not get out fast enough, admit half as many STAs
+		AuthenThreshold = AuthenThreshold / 2;
+	} else if (m_nrOfAssocRequests == 0 || m_assocSuccessRate >= 0.9) {
+		// idle or hardly any lost responses, grow multiplicatively
+		AuthenThreshold = std::min<uint16_t>(AuthenThreshold + std::max<uint16_t>(AuthenThreshold / 2, step), maxThreshold);
+	} else if (m_assocSuccessRate >= 0.5) {
+		AuthenThreshold = std::min<uint16_t>(AuthenThreshold + step, maxThreshold);
+	} else {
+		// most responses are lost, shrink with the success rate
+		AuthenThreshold = std::max<uint16_t>(AuthenThreshold * m_assocSuccessRate, step);
+	}
+	NS_LOG_DEBUG("authentication threshold " << AuthenThreshold << ", success rate " << m_assocSuccessRate);
+}
+
+uint8_t S1gApWifiMac::GetAuthSlotDuration(void) const {
+	if (m_authSlotDuration > 0)
+		return m_authSlotDuration;
+
+	// a request, the response and their ACKs at the lowest MCS, including contention
+	const double assocExchangeTU = 20;
+	uint32_t unassociated = m_totalStaNum > m_nrOfAssociatedStas ? m_totalStaNum - m_nrOfAssociatedStas : 0;
+	uint32_t maxInterval = std::max(m_authMaxInterval, m_authMinInterval);
+	double duration = std::ceil(unassociated * assocExchangeTU / maxInterval);
+	return std::max(1.0, std::min(duration, 127.0));
 }
 
 void S1gApWifiMac::SendOneBeacon(void) {
@@ -612,6 +911,8 @@ void S1gApWifiMac::SendOneBeacon(void) {
 	lastBeaconTime = Simulator::Now();
 
 	m_currentBeaconTIMGroup = (m_currentBeaconTIMGroup + 1) % m_nrOfTIMGroups;
+	if (m_currentBeaconTIMGroup == 0)
+		m_dtimCycle++;
 
 	hdr.SetS1gBeacon();
 	//hdr.SetAddr1(Mac48Address::GetBroadcast());
@@ -619,61 +920,62 @@ void S1gApWifiMac::SendOneBeacon(void) {
 	hdr.SetAddr2(GetAddress()); // for debug, not accordance with draft, need change
 	hdr.SetAddr3(GetAddress()); // for debug
 
-	Ptr<Packet> packet = Create<Packet>();
-	S1gBeaconHeader beacon;
-	S1gBeaconCompatibility compatibility;
-	compatibility.SetBeaconInterval(m_beaconInterval.GetMicroSeconds());
-	beacon.SetBeaconCompatibility(compatibility);
-	RPS m_rps;
-	RPS::RawAssignment raw;
-	uint8_t control = 0;
-	raw.SetRawControl(control); //support paged STA or not
-	raw.SetSlotFormat(m_SlotFormat);
-	raw.SetSlotCrossBoundary(m_slotCrossBoundary);
-	raw.SetSlotDurationCount(m_slotDurationCount);
-	raw.SetSlotNum(m_slotNum);
-	raw.SetRawStart(0); // immediately after the beacon;
-
-	uint32_t page = 0;
-
-	uint32_t rawinfo = (current_aid_end << 13) | (current_aid_start << 2) | page;
-
-	raw.SetRawGroup(rawinfo); // (b0-b1, page index) (b2-b12, raw start AID) (b13-b23, raw end AID)
-
-	// TODO set partial bitmap for TIM beacon for individual station indices
-
-	m_rps.SetRawAssignment(raw);
-
-	beacon.SetRPS(m_rps);
-
-	AuthenticationCtrl AuthenCtrl;
-	AuthenCtrl.SetControlType(false); //centralized
-	Ptr<WifiMacQueue> MgtQueue = m_dca->GetQueue();
-	uint32_t MgtQueueSize = MgtQueue->GetSize();
-	if (MgtQueueSize < 10) {
-		if (AuthenThreshold <= 950) {
-			AuthenThreshold += 50;
-		}
-	} else {
-		if (AuthenThreshold > 50) {
-			AuthenThreshold -= 50;
-		}
+	if (m_beaconTemplates.size() != m_nrOfTIMGroups) {
+		BuildBeaconTemplates(hdr);
+	}
+	BeaconTemplate& beaconTemplate = m_beaconTemplates[m_currentBeaconTIMGroup];
+	if (beaconTemplate.view->GetReferenceCount() > 1) {
+		// the previous beacon of this TIM group is still published
+		beaconTemplate.view = beaconTemplate.view->Copy();
+	}
+	S1gBeaconView& view = *beaconTemplate.view;
+	RPS::RawAssignment& raw = view.GetRawAssignment();
+
+	uint16_t groupStart = strategy->GetFirstAIDOfTIMGroup(m_currentBeaconTIMGroup, m_rawGroupInterval);
+	uint16_t groupEnd = groupStart + strategy->GetTIMGroupSize(m_rawGroupInterval) - 1;
+	uint32_t page = S1gStrategy::GetPageFromAID(groupStart);
+	uint32_t aidMask = S1gStrategy::AID_PAGE_SIZE - 1;
+
+	uint32_t rawinfo = ((groupEnd & aidMask) << 13) | ((groupStart & aidMask) << 2) | page;
+
+	// (b0-b1, page index) (b2-b12, raw start AID) (b13-b23, raw end AID)
+	beaconTemplate.bytes.SetRawGroup(rawinfo);
+	raw.SetRawGroup(rawinfo);
+
+	if (m_prawValidity > 0) {
+		// all periodic RAWs follow the same grid of DTIM periods, whichever beacon
+		// a STA last listened to
+		uint32_t cyclesUntilOccurrence = (m_prawPeriod - m_dtimCycle % m_prawPeriod) % m_prawPeriod;
+		raw.SetPeriodicRaw(GetPRAWPeriodicity(), m_prawValidity,
+				cyclesUntilOccurrence * m_nrOfTIMGroups);
+		beaconTemplate.bytes.SetPRAW(raw.GetPRAW());
 	}
-	AuthenCtrl.SetThreshold(AuthenThreshold); //centralized
-	beacon.SetAuthCtrl(AuthenCtrl);
-
-	if (int(m_currentBeaconTIMGroup) == 0) {
-		//DTIM header
-		TIM tim;
-		tim.SetDTIMPeriod(m_nrOfTIMGroups);
-		tim.SetDTIMCount(0);
 
-		// support up to 32 TIM groups
+	if (m_distributedAuthentication) {
+		uint8_t authSlotDuration = GetAuthSlotDuration();
+		beaconTemplate.bytes.SetAuthSlotDuration(authSlotDuration);
+		view.GetAuthCtrl().SetSlotDuration(authSlotDuration);
+	} else {
+		UpdateAuthenThreshold();
+		beaconTemplate.bytes.SetAuthThreshold(AuthenThreshold);
+		view.GetAuthCtrl().SetThreshold(AuthenThreshold);
+	}
+	m_associationThroughput(Simulator::Now() - m_lastAssocReport, m_nrOfAssocRequests,
+			m_nrOfAssociations, m_nrOfAssociatedStas, AuthenThreshold);
+	m_lastAssocReport = Simulator::Now();
+	m_nrOfAssocRequests = 0;
+	m_nrOfAssociations = 0;
+
+	TIM& tim = view.GetTIM();
+	if (tim.CarriesPageSlice()) {
+		// page slice beacon, the bitmap covers the TIM groups of the slice
+		uint16_t sliceStart = m_currentBeaconTIMGroup;
+		uint16_t sliceEnd = std::min(sliceStart + TIM::GROUPS_PER_PAGE_SLICE, (int)m_nrOfTIMGroups);
 		uint32_t vmap = 0;
 
-		// check the DCA queues if there is pending data
-		for (int group = 0; group < m_nrOfTIMGroups; group++) {
-			bool hasPendingData = false;
+		// check the DCA queues and the power save buffer if there is pending data
+		for (int group = sliceStart; group < sliceEnd; group++) {
+			bool hasPendingData = m_psBuffer->HasDataForTimGroup(group);
 			for (uint32_t slot = 0; slot < m_slotNum; slot++) {
 				if (rawSlotsDCA[group * m_slotNum + slot]->NeedsAccess()) {
 					// pending data
@@ -682,34 +984,19 @@ void S1gApWifiMac::SendOneBeacon(void) {
 				}
 			}
 
-			// if there is no pending data in the DCA queues, check the panding data that is scheduled
-			// to be forwarded to the next layer. Both systems are still required because otherwise
-			// it's possible that data is sent directly through the DCA because it had RAW slot access
-			// but the station wasn't listening because the DTIM didn't flag that
-
 			if (hasPendingData) {
-				vmap = vmap | (1 << group);
-			}
-		}
-
-		for (auto& pair : macToAIDMap) {
-			uint16_t aId = pair.second;
-			if (pendingDataSizeForStations.at(aId - 1) > 0) {
-				int group = strategy->GetTIMGroupFromAID(aId, m_rawGroupInterval);
-				vmap = vmap | (1 << group);
+				vmap = vmap | (1 << (group - sliceStart));
 			}
 		}
 
-		// determine if stations will be active
-		for (auto& pair : macToAIDMap) {
-			uint16_t aId = pair.second;
-			int group = strategy->GetTIMGroupFromAID(aId, m_rawGroupInterval);
-
-			if (((vmap >> group) & 0x01) == 0x01) {
-				///std::cout << Simulator::Now().GetMicroSeconds() << " there is data for aId " << aId << "( " << " TIM group " << group << ")" << std::endl;
-				staIsActiveDuringCurrentCycle[aId - 1] = true;
-			} else
-				staIsActiveDuringCurrentCycle[aId - 1] = false;
+		// determine if stations will be active, when they poll for their data
+		// they only count as active once they have been heard
+		uint32_t groupSize = strategy->GetTIMGroupSize(m_rawGroupInterval);
+		for (int group = sliceStart; group < sliceEnd; group++) {
+			bool active = !m_psPollDelivery && ((vmap >> (group - sliceStart)) & 0x01) == 0x01;
+			uint16_t firstAId = strategy->GetFirstAIDOfTIMGroup(group, m_rawGroupInterval);
+			for (uint16_t aId = firstAId; aId < firstAId + groupSize; aId++)
+				staIsActiveDuringCurrentCycle[aId] = active;
 		}
 
 		/*
@@ -719,39 +1006,35 @@ void S1gApWifiMac::SendOneBeacon(void) {
 		 std::cout << std::endl;
 */
 
+		beaconTemplate.bytes.SetPartialVBitmap(vmap);
 		tim.SetPartialVBitmap(vmap);
+	}
 
-		beacon.SetTIM(tim);
-	} else {
-		TIM tim;
-		tim.SetDTIMPeriod(m_nrOfTIMGroups);
-		tim.SetDTIMCount(m_nrOfTIMGroups - m_currentBeaconTIMGroup);
-		tim.SetPartialVBitmap(0); // no map
-		beacon.SetTIM(tim);
+	if (m_psPollDelivery) {
+		// stations of this TIM group with buffered frames have to poll for them in their slot
+		for (uint16_t aId = groupStart; aId <= groupEnd; aId++) {
+			tim.SetStationBit(aId - groupStart, m_psBuffer->HasData(aId));
+		}
+		beaconTemplate.bytes.SetStationBitmap(tim);
 	}
 
-	packet->AddHeader(beacon);
+	Ptr<Packet> packet = Create<Packet>();
+	packet->AddHeader(beaconTemplate.bytes);
 
-	m_beaconDca->Queue(packet, hdr);
+	// receivers read the parsed beacon instead of deserializing it again, the
+	// beacon waits at most a beacon interval for the next one to replace it
+	S1gBeaconView::Publish(beaconTemplate.view, GetBeaconInterval() + beaconTemplate.txTime);
+	packet->AddPacketTag(S1gBeaconViewTag(view.GetId()));
 
-	m_transmitBeaconTrace(beacon, raw);
+	m_beaconDca->Queue(packet, hdr);
 
-	current_aid_start += m_rawGroupInterval;
-	current_aid_end += m_rawGroupInterval;
-	if (current_aid_end > m_totalStaNum) {
-		current_aid_start = 1;
-		current_aid_end = m_rawGroupInterval;
+	if (!m_transmitBeaconTrace.IsEmpty()) {
+		m_transmitBeaconTrace(view.GetBeacon(), raw);
 	}
 
-	// broadcast so disable rts, ack & fragmentation
 	// sending the beacon and starting the RAW at the same time will always mismatch
 	// a while due to the travel time of the beacon, try to compensate beacon travel time
-
-	MacLowTransmissionParameters params;
-	params.DisableRts();
-	params.DisableAck();
-	params.DisableNextData();
-	Time txTime = m_low->CalculateOverallTxTime(packet, &hdr, params);
+	Time txTime = beaconTemplate.txTime;
 	NS_LOG_DEBUG(
 			"Transmission of beacon will take " << txTime << ", delaying RAW start for that amount");
 	Time bufferTimeToAllowBeaconToBeReceived = txTime;
@@ -775,6 +1058,14 @@ void S1gApWifiMac::SendOneBeacon(void) {
 			&S1gApWifiMac::SendOneBeacon, this);
 }
 
+uint8_t S1gApWifiMac::GetPRAWPeriodicity(void) const {
+	return m_prawPeriod * m_nrOfTIMGroups;
+}
+
+bool S1gApWifiMac::IsPRAWOccurrence(void) const {
+	return m_prawValidity > 0 && m_dtimCycle % m_prawPeriod == 0;
+}
+
 void S1gApWifiMac::OnRAWSlotStart(uint8_t timGroup, uint8_t slot) {
 	LOG_TRAFFIC(
 			"AP RAW SLOT START FOR TIM GROUP " << std::to_string(timGroup) << " SLOT " << std::to_string(slot));
@@ -782,6 +1073,19 @@ void S1gApWifiMac::OnRAWSlotStart(uint8_t timGroup, uint8_t slot) {
 
 	m_rawSlotStarted(timGroup, slot);
 
+	// stations of this slot that were announced in the DTIM or that follow
+	// the periodic RAW are listening now
+	if (m_psBuffer->HasDataForTimGroup(timGroup)) {
+		bool prawOccurrence = IsPRAWOccurrence();
+		uint32_t groupStart = strategy->GetFirstAIDOfTIMGroup(timGroup, m_rawGroupInterval);
+		uint32_t groupEnd = groupStart + strategy->GetTIMGroupSize(m_rawGroupInterval) - 1;
+		uint32_t firstAId = groupStart + (slot + m_slotNum - groupStart % m_slotNum) % m_slotNum;
+		for (uint32_t aId = firstAId; aId <= groupEnd; aId += m_slotNum) {
+			if ((prawOccurrence || staIsActiveDuringCurrentCycle[aId]) && m_psBuffer->HasData(aId))
+				DeliverBufferedFrames(aId);
+		}
+	}
+
 	rawSlotsDCA[timGroup * m_slotNum + slot]->AccessAllowedIfRaw(true);
 	rawSlotsDCA[timGroup * m_slotNum + slot]->RawStart(
 			strategy->GetSlotDuration(m_slotDurationCount));
@@ -793,6 +1097,8 @@ void S1gApWifiMac::OnRAWSlotEnd(uint8_t timGroup, uint8_t slot) {
 
 	rawSlotsDCA[timGroup * m_slotNum + slot]->AccessAllowedIfRaw(false);
 	rawSlotsDCA[timGroup * m_slotNum + slot]->OutsideRawStart();
+
+	m_rawSlotEnded(timGroup, slot);
 }
 
 void S1gApWifiMac::TxOk(const WifiMacHeader &hdr) {
@@ -803,6 +1109,8 @@ void S1gApWifiMac::TxOk(const WifiMacHeader &hdr) {
 			&& m_stationManager->IsWaitAssocTxOk(hdr.GetAddr1())) {
 		NS_LOG_DEBUG("associated with sta=" << hdr.GetAddr1());
 		m_stationManager->RecordGotAssocTxOk(hdr.GetAddr1());
+		m_nrOfAssociations++;
+		m_nrOfAssociatedStas++;
 	}
 }
 
@@ -825,10 +1133,17 @@ void S1gApWifiMac::Receive(Ptr<Packet> packet, const WifiMacHeader *hdr) {
 
 
 
-	if (macToAIDMap.find(from) != macToAIDMap.end()) {
+	auto it = macToAIDMap.find(from);
+	if (it != macToAIDMap.end()) {
 		// we've received data from the STA, which means it's active during its slot
-		auto aId = macToAIDMap[from];
-		staIsActiveDuringCurrentCycle[aId - 1] = true;
+		auto aId = it->second;
+		staIsActiveDuringCurrentCycle[aId] = true;
+
+		if (hdr->IsPsPoll()) {
+			NS_LOG_DEBUG("PS-Poll from=" << from << ", " << m_psBuffer->GetNPackets(aId) << " frames buffered");
+			DeliverBufferedFrames(aId);
+			return;
+		}
 	}
 
 	if (hdr->IsData()) {
@@ -889,67 +1204,26 @@ void S1gApWifiMac::Receive(Ptr<Packet> packet, const WifiMacHeader *hdr) {
 					return; //test, avoid repeate assoc
 				}
 				//NS_LOG_LOGIC ("Received AssocReq "); // for test
-				//first, verify that the the station's supported
-				//rate set is compatible with our Basic Rate set
 				MgtAssocRequestHeader assocReq;
 				packet->RemoveHeader(assocReq);
-				SupportedRates rates = assocReq.GetSupportedRates();
-				bool problem = false;
-				for (uint32_t i = 0; i < m_stationManager->GetNBasicModes();
-						i++) {
-					WifiMode mode = m_stationManager->GetBasicMode(i);
-					if (!rates.IsSupportedRate(mode.GetDataRate())) {
-						problem = true;
-						break;
-					}
-				}
-				if (m_htSupported) {
-					//check that the STA supports all MCSs in Basic MCS Set
-					HtCapabilities htcapabilities =
-							assocReq.GetHtCapabilities();
-					for (uint32_t i = 0; i < m_stationManager->GetNBasicMcs();
-							i++) {
-						uint8_t mcs = m_stationManager->GetBasicMcs(i);
-						if (!htcapabilities.IsSupportedMcs(mcs)) {
-							problem = true;
-							break;
-						}
-					}
-
-				}
-				if (problem) {
+				m_nrOfAssocRequests++;
+				if (AcceptAssocRequest(from, assocReq)) {
+					m_stationManager->RecordWaitAssocTxOk(from);
+					//send assoc response with success status.
+					SendAssocResp(hdr->GetAddr2(), true);
+				} else {
 					//One of the Basic Rate set mode is not
 					//supported by the station. So, we return an assoc
 					//response with an error status.
 					SendAssocResp(hdr->GetAddr2(), false);
-				} else {
-					//station supports all rates in Basic Rate Set.
-					//record all its supported modes in its associated WifiRemoteStation
-					for (uint32_t j = 0; j < m_phy->GetNModes(); j++) {
-						WifiMode mode = m_phy->GetMode(j);
-						if (rates.IsSupportedRate(mode.GetDataRate())) {
-							m_stationManager->AddSupportedMode(from, mode);
-						}
-					}
-					if (m_htSupported) {
-						HtCapabilities htcapabilities =
-								assocReq.GetHtCapabilities();
-						m_stationManager->AddStationHtCapabilities(from,
-								htcapabilities);
-						for (uint32_t j = 0; j < m_phy->GetNMcs(); j++) {
-							uint8_t mcs = m_phy->GetMcs(j);
-							if (htcapabilities.IsSupportedMcs(mcs)) {
-								m_stationManager->AddSupportedMcs(from, mcs);
-							}
-						}
-					}
-					m_stationManager->RecordWaitAssocTxOk(from);
-					//send assoc response with success status.
-					SendAssocResp(hdr->GetAddr2(), true);
 				}
 				return;
 			} else if (hdr->IsDisassociation()) {
+				if (m_stationManager->IsAssociated(from) && m_nrOfAssociatedStas > 0) {
+					m_nrOfAssociatedStas--;
+				}
 				m_stationManager->RecordDisassociated(from);
+				ReleaseAID(from);
 				return;
 			}
 		}
@@ -1032,13 +1306,29 @@ void S1gApWifiMac::DoInitialize(void) {
 			GetSifs() + GetSlot() + GetDefaultCompressedBlockAckDelay()
 					+ GetDefaultMaxPropagationDelay() * 2);
 
-	m_nrOfTIMGroups = ceil(m_totalStaNum / (float) m_rawGroupInterval);
+	if (m_totalStaNum > strategy->GetMaxNumberOfStations(m_rawGroupInterval)) {
+		NS_FATAL_ERROR("Only " << strategy->GetMaxNumberOfStations(m_rawGroupInterval) << " stations fit in " << S1gStrategy::NR_OF_AID_PAGES << " AID pages with TIM groups of " << m_rawGroupInterval << " stations");
+	}
+	uint32_t nrOfTIMGroups = ceil(m_totalStaNum / (float) strategy->GetTIMGroupSize(m_rawGroupInterval));
+	if (nrOfTIMGroups > 255) {
+		NS_FATAL_ERROR(nrOfTIMGroups << " TIM groups do not fit in the DTIM period, increase the number of stations per TIM group");
+	}
+	m_nrOfTIMGroups = nrOfTIMGroups;
+	if (m_psPollDelivery && strategy->GetTIMGroupSize(m_rawGroupInterval) > TIM::MAX_STATION_BITMAP_SIZE) {
+		NS_FATAL_ERROR("With PsPollDelivery the TIM indicates every station of a TIM group, which fits at most "
+				<< TIM::MAX_STATION_BITMAP_SIZE << " stations, not " << strategy->GetTIMGroupSize(m_rawGroupInterval)
+				<< ", use smaller TIM groups");
+	}
+	if (m_prawValidity > 0 && m_prawPeriod * m_nrOfTIMGroups > 255) {
+		NS_FATAL_ERROR("The periodic RAW periodicity (" << m_prawPeriod * m_nrOfTIMGroups << " beacon intervals) does not fit the PRAW field");
+	}
 	// initialize queue
-	pendingDataSizeForStations = std::vector<int>(m_totalStaNum, 0);
-	staIsActiveDuringCurrentCycle = std::vector<bool>(m_totalStaNum, false);
-
-	current_aid_start = 1;
-	current_aid_end = m_rawGroupInterval;
+	m_psBuffer->SetMaxDelay(m_maxTimeInQueue);
+	m_psBuffer->TraceConnect("PacketDropped", "",
+			MakeCallback(&S1gApWifiMac::OnQueuePacketDropped, this));
+	// indexed by AID
+	staIsActiveDuringCurrentCycle = std::vector<bool>(S1gStrategy::MAX_AID + 1, false);
+	m_aidToMac = std::vector<Mac48Address>(S1gStrategy::MAX_AID + 1);
 
 	rawSlotsDCA = std::vector<Ptr<DcaTxop>>();
 	for (uint32_t i = 0; i < (m_nrOfTIMGroups * m_slotNum); i++) {
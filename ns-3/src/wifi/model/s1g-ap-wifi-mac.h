@@ -27,11 +27,14 @@
 #include "ht-capabilities.h"
 #include "amsdu-subframe-header.h"
 #include "supported-rates.h"
+#include "mgt-headers.h"
 #include "ns3/random-variable-stream.h"
 #include "extension-headers.h"
+#include "s1g-beacon-view.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
 #include "s1g-strategy.h"
+#include "s1g-ap-queue.h"
 #include <vector>
 #include <queue>
 
@@ -59,6 +62,12 @@ public:
  typedef void (* RawSlotStartedCallback)
       (uint16_t timGroup, uint16_t rawSlot);
 
+ typedef void (* RawSlotEndedCallback)
+      (uint16_t timGroup, uint16_t rawSlot);
+
+ typedef void (* AssociationThroughputCallback)
+      (Time interval, uint32_t nrOfAssocRequests, uint32_t nrOfAssociations, uint32_t nrOfAssociatedStas, uint16_t threshold);
+
 
   S1gApWifiMac ();
   virtual ~S1gApWifiMac ();
@@ -114,6 +123,11 @@ public:
 
   bool GetAlwaysScheduleForNextSlot(void) const;
 
+  /**
+   * \return the buffer holding downlink frames for stations in power save
+   */
+  Ptr<S1gAPQueue> GetPowerSaveBuffer (void) const;
+
   void SetAlwaysScheduleForNextSlot(bool value);
 
   /**
@@ -121,6 +135,17 @@ public:
    */
   void StartBeaconing (void);
 
+  /**
+   * Associate a STA without the probe and association exchange over the air.
+   * The request is handled as if it was received, and the STA is associated
+   * as soon as the response is created.
+   *
+   * \param from the address of the STA
+   * \param assocReq the association request of the STA
+   * \return the association response, with the AID of the STA on success
+   */
+  MgtAssocResponseHeader PreAssociate (Mac48Address from, const MgtAssocRequestHeader& assocReq);
+
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model.  Return the number of streams (possibly zero) that
@@ -139,6 +164,16 @@ private:
 
   void OnRAWSlotStart(uint8_t timGroup, uint8_t slot);
 
+  /**
+   * \return the periodicity of the periodic RAW in beacon intervals
+   */
+  uint8_t GetPRAWPeriodicity (void) const;
+  /**
+   * \return true if the RAWs of the current DTIM period are periodic RAW
+   * occurrences, i.e. the STAs following the periodic RAW wake up for them
+   */
+  bool IsPRAWOccurrence (void) const;
+
   void OnRAWSlotEnd(uint8_t timGroup, uint8_t slot);
 
   virtual void Receive (Ptr<Packet> packet, const WifiMacHeader *hdr);
@@ -190,6 +225,23 @@ private:
    * \param tid the traffic id for the packet
    */
   void ForwardDown (Ptr<const Packet> packet, Mac48Address from, Mac48Address to, uint8_t tid);
+  /**
+   * Keep the packet in the power save buffer until the station is awake.
+   *
+   * \param packet the packet to buffer
+   * \param from the address to be used for Address 3 field in the header
+   * \param to the address to be used for Address 1 field in the header
+   * \param aId the AID of the destination station
+   */
+  void BufferDown (Ptr<const Packet> packet, Mac48Address from, Mac48Address to, uint16_t aId);
+  /**
+   * Move everything that is buffered for a station to the DCA of its RAW slot.
+   *
+   * \param aId the AID of the station
+   */
+  void DeliverBufferedFrames (uint16_t aId);
+  uint8_t GetTidForPacket (Ptr<const Packet> packet) const;
+  WifiMacHeader CreateDataHeader (Mac48Address from, Mac48Address to, uint8_t tid) const;
   /**
    * Forward a probe response packet to the DCF. The standard is not clear on the correct
    * queue for management frames if QoS is supported. We always use the DCF.
@@ -205,10 +257,59 @@ private:
    * \param success indicates whether the association was successful or not
    */
   void SendAssocResp (Mac48Address to, bool success);
+  /**
+   * \param to the address of the STA
+   * \param success indicates whether the association was successful or not
+   * \return the association response, an AID is allocated on success
+   */
+  MgtAssocResponseHeader CreateAssocResp (Mac48Address to, bool success);
+  /**
+   * Check that the STA supports our Basic Rate set and record the modes
+   * it supports.
+   *
+   * \param from the address of the STA
+   * \param assocReq the association request of the STA
+   * \return true if the STA can be associated
+   */
+  bool AcceptAssocRequest (Mac48Address from, const MgtAssocRequestHeader& assocReq);
+  /**
+   * Give the STA an AID. A reassociating STA keeps its AID, a new STA gets
+   * the AID that follows from its MAC address if it is still free, and the
+   * first free AID otherwise.
+   *
+   * \param address the address of the STA
+   * \return the AID, or 0 if all AIDs are in use
+   */
+  uint16_t AllocateAID (Mac48Address address);
+  /**
+   * Free the AID of a disassociated STA.
+   *
+   * \param address the address of the STA
+   */
+  void ReleaseAID (Mac48Address address);
+  /**
+   * Adapt the centralized authentication control threshold to the
+   * association success rate and the backlog of management frames
+   * since the previous beacon.
+   */
+  void UpdateAuthenThreshold (void);
+  /**
+   * \return the slot duration of the distributed authentication control
+   * in TUs, the configured one or one that lets the largest transmission
+   * interval fit the STAs that are not associated yet
+   */
+  uint8_t GetAuthSlotDuration (void) const;
   /**
    * Forward a beacon packet to the beacon special DCF.
    */
   void SendOneBeacon (void);
+  /**
+   * Serialize one beacon per TIM group and calculate its airtime. SendOneBeacon
+   * only patches the fields that change between beacons of the same group.
+   *
+   * \param hdr the MAC header the beacons are sent with
+   */
+  void BuildBeaconTemplates (const WifiMacHeader& hdr);
   /**
    * Return the HT capability of the current AP.
    *
@@ -258,11 +359,25 @@ private:
   TracedCallback<S1gBeaconHeader, RPS::RawAssignment> m_transmitBeaconTrace;
 
   TracedCallback<uint16_t,uint16_t> m_rawSlotStarted;
+  TracedCallback<uint16_t,uint16_t> m_rawSlotEnded;
 
   TracedCallback<Ptr<const Packet>, Mac48Address, bool, bool, Time> m_packetToTransmitReceivedFromUpperLayer;
 
+  TracedCallback<Time, uint32_t, uint32_t, uint32_t, uint16_t> m_associationThroughput;
+
 
   uint16_t  AuthenThreshold;
+  bool m_psPollDelivery;             //!< announce buffered frames per station and deliver them on PS-Poll
+  bool m_distributedAuthentication;  //!< distributed instead of centralized authentication control
+  uint32_t m_authSlotDuration;       //!< distributed control slot duration, in TUs
+  uint32_t m_authMinInterval;        //!< distributed control initial transmission interval, in slots
+  uint32_t m_authMaxInterval;        //!< distributed control maximum transmission interval, in slots
+  uint32_t m_authMaxMgtQueueSize;    //!< management frames queued before the threshold is cut
+  double m_assocSuccessRate;         //!< smoothed ratio of acknowledged responses to received requests
+  uint32_t m_nrOfAssocRequests = 0;  //!< association requests received since the last beacon
+  uint32_t m_nrOfAssociations = 0;   //!< associations completed since the last beacon
+  uint32_t m_nrOfAssociatedStas = 0;
+  Time m_lastAssocReport;
   uint32_t m_totalStaNum;
   uint32_t m_rawGroupInterval;
   uint32_t m_SlotFormat;
@@ -278,20 +393,30 @@ private:
   uint8_t m_currentBeaconTIMGroup = -1; // -1 because first beacon will have to be 0
   uint8_t m_currentTIMGroupSlot = -1;
 
-  uint32_t current_aid_start = 1;
-  uint32_t current_aid_end = m_rawGroupInterval; //m_rawGroupInterval;
+  uint32_t m_prawPeriod;          //!< DTIM periods between two periodic RAW occurrences
+  uint32_t m_prawValidity;        //!< number of announced periodic RAW occurrences, 0 if disabled
+  uint32_t m_dtimCycle = 0;       //!< number of DTIM periods since the first beacon
 
   Time lastBeaconTime = Time();
 
   std::map<Mac48Address, uint16_t> macToAIDMap;
+  std::vector<Mac48Address> m_aidToMac; //!< indexed by AID, all zero if the AID is free
 
 
   std::vector<Ptr<DcaTxop>> rawSlotsDCA;
-  std::vector<int> pendingDataSizeForStations;
+  Ptr<S1gAPQueue> m_psBuffer; //!< downlink frames waiting for their station to wake up
   std::vector<bool> staIsActiveDuringCurrentCycle;
 
   S1gStrategy* strategy;
 
+  struct BeaconTemplate
+  {
+    S1gBeaconTemplate bytes;    //!< serialized beacon, patched for every transmission
+    Ptr<S1gBeaconView> view;    //!< parsed beacon for the receivers, patched along with the bytes
+    Time txTime;                //!< airtime of the beacon
+  };
+  std::vector<BeaconTemplate> m_beaconTemplates; //!< one per TIM group
+
   Ptr<DcaTxop> m_beaconDca;                  //!< Dedicated DcaTxop for beacons
   Time m_beaconInterval;                     //!< Interval between beacons
   bool m_enableBeaconGeneration;             //!< Flag if beacons are being generated
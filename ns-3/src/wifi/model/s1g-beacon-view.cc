@@ -0,0 +1,221 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "s1g-beacon-view.h"
+#include "ns3/tag.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include <map>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("S1gBeaconView");
+
+namespace {
+
+std::map<uint64_t, Ptr<const S1gBeaconView> > &
+GetPublishedViews (void)
+{
+  static std::map<uint64_t, Ptr<const S1gBeaconView> > views;
+  return views;
+}
+
+uint64_t g_nextViewId = 1;
+
+} //anonymous namespace
+
+S1gBeaconView::S1gBeaconView (const S1gBeaconHeader &beacon)
+  : m_id (g_nextViewId++),
+    m_compatibility (beacon.GetBeaconCompatibility ()),
+    m_tim (beacon.GetTIM ()),
+    m_auth (beacon.GetAuthCtrl ()),
+    m_raw (beacon.GetRPS ().GetRawAssigmentObj ())
+{
+}
+
+uint64_t
+S1gBeaconView::GetId (void) const
+{
+  return m_id;
+}
+
+S1gBeaconHeader
+S1gBeaconView::GetBeacon (void) const
+{
+  S1gBeaconHeader beacon;
+  beacon.SetBeaconCompatibility (m_compatibility);
+  beacon.SetTIM (m_tim);
+  RPS rps;
+  rps.SetRawAssignment (m_raw);
+  beacon.SetRPS (rps);
+  beacon.SetAuthCtrl (m_auth);
+  return beacon;
+}
+
+const S1gBeaconCompatibility &
+S1gBeaconView::GetBeaconCompatibility (void) const
+{
+  return m_compatibility;
+}
+
+const TIM &
+S1gBeaconView::GetTIM (void) const
+{
+  return m_tim;
+}
+
+const AuthenticationCtrl &
+S1gBeaconView::GetAuthCtrl (void) const
+{
+  return m_auth;
+}
+
+const RPS::RawAssignment &
+S1gBeaconView::GetRawAssignment (void) const
+{
+  return m_raw;
+}
+
+TIM &
+S1gBeaconView::GetTIM (void)
+{
+  return m_tim;
+}
+
+AuthenticationCtrl &
+S1gBeaconView::GetAuthCtrl (void)
+{
+  return m_auth;
+}
+
+RPS::RawAssignment &
+S1gBeaconView::GetRawAssignment (void)
+{
+  return m_raw;
+}
+
+Ptr<S1gBeaconView>
+S1gBeaconView::Copy (void) const
+{
+  Ptr<S1gBeaconView> copy = Create<S1gBeaconView> (*this);
+  copy->m_id = g_nextViewId++;
+  return copy;
+}
+
+void
+S1gBeaconView::Publish (Ptr<const S1gBeaconView> view, Time lifetime)
+{
+  GetPublishedViews ()[view->GetId ()] = view;
+  Simulator::Schedule (lifetime, &S1gBeaconView::Unpublish, view->GetId ());
+}
+
+void
+S1gBeaconView::Unpublish (uint64_t id)
+{
+  GetPublishedViews ().erase (id);
+}
+
+Ptr<const S1gBeaconView>
+S1gBeaconView::PeekView (Ptr<const Packet> packet)
+{
+  S1gBeaconViewTag tag;
+  if (!packet->PeekPacketTag (tag))
+    {
+      return 0;
+    }
+  const std::map<uint64_t, Ptr<const S1gBeaconView> > &views = GetPublishedViews ();
+  std::map<uint64_t, Ptr<const S1gBeaconView> >::const_iterator it = views.find (tag.GetId ());
+  if (it == views.end ())
+    {
+      NS_LOG_DEBUG ("view " << tag.GetId () << " is no longer published");
+      return 0;
+    }
+  return it->second;
+}
+
+Ptr<const S1gBeaconView>
+S1gBeaconView::FromPacket (Ptr<const Packet> packet)
+{
+  Ptr<const S1gBeaconView> view = PeekView (packet);
+  if (view != 0)
+    {
+      return view;
+    }
+  S1gBeaconHeader beacon;
+  packet->PeekHeader (beacon);
+  return Create<S1gBeaconView> (beacon);
+}
+
+NS_OBJECT_ENSURE_REGISTERED (S1gBeaconViewTag);
+
+TypeId
+S1gBeaconViewTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::S1gBeaconViewTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<S1gBeaconViewTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+S1gBeaconViewTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+S1gBeaconViewTag::S1gBeaconViewTag ()
+  : m_id (0)
+{
+}
+
+S1gBeaconViewTag::S1gBeaconViewTag (uint64_t id)
+  : m_id (id)
+{
+}
+
+uint64_t
+S1gBeaconViewTag::GetId (void) const
+{
+  return m_id;
+}
+
+uint32_t
+S1gBeaconViewTag::GetSerializedSize (void) const
+{
+  return 8;
+}
+
+void
+S1gBeaconViewTag::Serialize (TagBuffer i) const
+{
+  i.WriteU64 (m_id);
+}
+
+void
+S1gBeaconViewTag::Deserialize (TagBuffer i)
+{
+  m_id = i.ReadU64 ();
+}
+
+void
+S1gBeaconViewTag::Print (std::ostream &os) const
+{
+  os << "S1G beacon view=" << m_id;
+}
+
+} //namespace ns3
@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef S1G_BEACON_VIEW_H
+#define S1G_BEACON_VIEW_H
+
+#include "ns3/packet.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include "extension-headers.h"
+
+namespace ns3 {
+
+class Tag;
+
+/**
+ * \ingroup wifi
+ *
+ * An already parsed S1G beacon.
+ *
+ * The AP keeps a view per TIM group, patches it along with the serialized
+ * beacon and publishes it for every beacon it transmits. The
+ * packet only carries the id of the view in an S1gBeaconViewTag, so every
+ * STA that receives the beacon can read the RPS, TIM and compatibility
+ * elements without deserializing the beacon again.
+ *
+ * A view is kept for as long as its beacon can take to reach the receivers,
+ * whether the AP sends one beacon or many APs send them at once. A packet
+ * whose view is no longer available (or a packet without tag) falls back
+ * to deserializing the beacon.
+ *
+ * The tag only carries the id: packet tags are stored as serialized bytes
+ * and shared between packet copies without a hook when the last copy goes
+ * away, so they cannot hold a reference themselves.
+ */
+class S1gBeaconView : public SimpleRefCount<S1gBeaconView>
+{
+public:
+  /**
+   * \param beacon the beacon as it is transmitted
+   */
+  S1gBeaconView (const S1gBeaconHeader &beacon);
+
+  uint64_t GetId (void) const;
+
+  /**
+   * \return the beacon assembled from the elements of the view
+   */
+  S1gBeaconHeader GetBeacon (void) const;
+  const S1gBeaconCompatibility & GetBeaconCompatibility (void) const;
+  const TIM & GetTIM (void) const;
+  const AuthenticationCtrl & GetAuthCtrl (void) const;
+  /**
+   * \return the RAW assignment of the RPS element, parsed once
+   */
+  const RPS::RawAssignment & GetRawAssignment (void) const;
+
+  /**
+   * The elements the AP patches between beacons of the same TIM group. A
+   * published view must not be patched, see Copy.
+   */
+  TIM & GetTIM (void);
+  AuthenticationCtrl & GetAuthCtrl (void);
+  RPS::RawAssignment & GetRawAssignment (void);
+
+  /**
+   * \return a view with the same elements and a new id, to patch while
+   * this one is still published
+   */
+  Ptr<S1gBeaconView> Copy (void) const;
+
+  /**
+   * Keep the view available for receivers of packets tagged with its id.
+   *
+   * \param view the view of the beacon that is about to be sent
+   * \param lifetime how long the beacon can be queued and on the air
+   */
+  static void Publish (Ptr<const S1gBeaconView> view, Time lifetime);
+  /**
+   * \param packet a received packet, with or without MAC header
+   * \return the published view the packet refers to, or 0 if there is none
+   */
+  static Ptr<const S1gBeaconView> PeekView (Ptr<const Packet> packet);
+  /**
+   * \param packet a received packet that starts with the S1G beacon
+   * \return the published view, or a view parsed from the packet
+   */
+  static Ptr<const S1gBeaconView> FromPacket (Ptr<const Packet> packet);
+
+private:
+  /**
+   * Stop publishing a view once its lifetime has passed.
+   *
+   * \param id the id of the view
+   */
+  static void Unpublish (uint64_t id);
+
+  uint64_t m_id;
+  S1gBeaconCompatibility m_compatibility;
+  TIM m_tim;
+  AuthenticationCtrl m_auth;
+  RPS::RawAssignment m_raw;
+};
+
+/**
+ * \ingroup wifi
+ *
+ * Refers an S1G beacon packet to its published S1gBeaconView.
+ */
+class S1gBeaconViewTag : public Tag
+{
+public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  S1gBeaconViewTag ();
+  /**
+   * \param id the id of the published view
+   */
+  S1gBeaconViewTag (uint64_t id);
+
+  uint64_t GetId (void) const;
+
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual uint32_t GetSerializedSize () const;
+  virtual void Print (std::ostream &os) const;
+
+private:
+  uint64_t m_id;
+};
+
+} //namespace ns3
+
+#endif /* S1G_BEACON_VIEW_H */
@@ -6,6 +6,7 @@
  */
 
 #include "s1g-strategy.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -25,9 +26,54 @@ uint16_t S1gStrategy::GetAIDFromMacAddress(Mac48Address to) {
 	return aid;
 }
 
+uint8_t S1gStrategy::GetPageFromAID(uint16_t aid) {
+	return (aid >> 11) & 0x03;
+}
+
+uint8_t S1gStrategy::GetBlockFromAID(uint16_t aid) {
+	return (aid >> 6) & 0x1f;
+}
+
+uint8_t S1gStrategy::GetSubblockFromAID(uint16_t aid) {
+	return (aid >> 3) & 0x07;
+}
+
+uint8_t S1gStrategy::GetSubblockIndexFromAID(uint16_t aid) {
+	return aid & 0x07;
+}
+
+uint16_t S1gStrategy::GetAID(uint8_t page, uint8_t block, uint8_t subblock, uint8_t index) {
+	return ((page & 0x03) << 11) | ((block & 0x1f) << 6) | ((subblock & 0x07) << 3) | (index & 0x07);
+}
+
+uint32_t S1gStrategy::GetTIMGroupSize(uint32_t rawGroupInterval) {
+	return std::min(rawGroupInterval, (uint32_t)AID_PAGE_SIZE - 1);
+}
+
+uint32_t S1gStrategy::GetTIMGroupsPerPage(uint32_t rawGroupInterval) {
+	return (AID_PAGE_SIZE - 1) / GetTIMGroupSize(rawGroupInterval);
+}
+
+uint32_t S1gStrategy::GetMaxNumberOfStations(uint32_t rawGroupInterval) {
+	return GetTIMGroupsPerPage(rawGroupInterval) * GetTIMGroupSize(rawGroupInterval) * NR_OF_AID_PAGES;
+}
+
 uint16_t S1gStrategy::GetTIMGroupFromAID(uint16_t aId,
 		uint32_t rawGroupInterval) {
-	return (aId - 1) / rawGroupInterval;
+	uint32_t groupSize = GetTIMGroupSize(rawGroupInterval);
+	uint16_t aIdInPage = aId & (AID_PAGE_SIZE - 1);
+	return GetPageFromAID(aId) * GetTIMGroupsPerPage(rawGroupInterval) + (aIdInPage - 1) / groupSize;
+}
+
+uint16_t S1gStrategy::GetFirstAIDOfTIMGroup(uint16_t timGroup, uint32_t rawGroupInterval) {
+	uint32_t groupsPerPage = GetTIMGroupsPerPage(rawGroupInterval);
+	uint16_t page = timGroup / groupsPerPage;
+	return page * AID_PAGE_SIZE + (timGroup % groupsPerPage) * GetTIMGroupSize(rawGroupInterval) + 1;
+}
+
+uint16_t S1gStrategy::GetAIDFromStationIndex(uint32_t index, uint32_t rawGroupInterval) {
+	uint32_t groupSize = GetTIMGroupSize(rawGroupInterval);
+	return GetFirstAIDOfTIMGroup(index / groupSize, rawGroupInterval) + index % groupSize;
 }
 
 uint8_t S1gStrategy::GetSlotIndexFromAID(uint16_t aId, uint8_t nrOfSlots) {
@@ -39,14 +85,19 @@ Time S1gStrategy::GetSlotDuration(uint16_t slotDurationCount) {
 }
 
 bool S1gStrategy::STABelongsToRAWGroup(uint16_t aid, RPS& rps) {
+	return STABelongsToRAWGroup(aid, rps.GetRawAssigmentObj());
+}
+
+bool S1gStrategy::STABelongsToRAWGroup(uint16_t aid, const RPS::RawAssignment& rawObj) {
 
-	auto rawObj = rps.GetRawAssigmentObj();
 	auto pageindex = rawObj.GetRawGroupPage();
 
-	if (pageindex == ((aid >> 11) & 0x0003)) //in the page indexed
+	if (pageindex == GetPageFromAID(aid)) //in the page indexed
 	{
-		if (aid >= rawObj.GetRawGroupAIDStart()
-				&& aid <= rawObj.GetRawGroupAIDEnd()) {
+		// the RAW group AIDs are relative to the page
+		uint16_t aidInPage = aid & (AID_PAGE_SIZE - 1);
+		if (aidInPage >= rawObj.GetRawGroupAIDStart()
+				&& aidInPage <= rawObj.GetRawGroupAIDEnd()) {
 
 			return true;
 		}
@@ -54,8 +105,4 @@ bool S1gStrategy::STABelongsToRAWGroup(uint16_t aid, RPS& rps) {
 	return false;
 }
 
-Time S1gStrategy::GetEarlyWakeTime() {
-	return MilliSeconds(4);//too much bilo 10
-}
-
 } /* namespace ns3 */
@@ -23,21 +23,51 @@ public:
 	S1gStrategy();
 	virtual ~S1gStrategy();
 
+	/**
+	 * AIDs are 13 bits: page (b11-b12), block (b6-b10), subblock (b3-b5)
+	 * and STA index within the subblock (b0-b2). RAW groups and TIM groups
+	 * never cross a page, the AID 0 of every page is left unused.
+	 */
+	static const uint16_t AID_PAGE_SIZE = 2048;
+	static const uint16_t NR_OF_AID_PAGES = 4;
+	static const uint16_t MAX_AID = 8191;
+
+	static uint8_t GetPageFromAID(uint16_t aid);
+	static uint8_t GetBlockFromAID(uint16_t aid);
+	static uint8_t GetSubblockFromAID(uint16_t aid);
+	static uint8_t GetSubblockIndexFromAID(uint16_t aid);
+	static uint16_t GetAID(uint8_t page, uint8_t block, uint8_t subblock, uint8_t index);
+
 	virtual uint16_t GetAIDFromMacAddress(Mac48Address mac);
 
+	/**
+	 * Number of STAs in a TIM group, a group never exceeds one page
+	 */
+	virtual uint32_t GetTIMGroupSize(uint32_t rawGroupInterval);
+
+	virtual uint32_t GetTIMGroupsPerPage(uint32_t rawGroupInterval);
+
+	/**
+	 * Number of STAs that can be given an AID for the given TIM group size
+	 */
+	virtual uint32_t GetMaxNumberOfStations(uint32_t rawGroupInterval);
+
 	virtual uint16_t GetTIMGroupFromAID(uint16_t aid, uint32_t rawGroupInterval);
 
+	virtual uint16_t GetFirstAIDOfTIMGroup(uint16_t timGroup, uint32_t rawGroupInterval);
+
+	/**
+	 * The AID of the n-th STA (0 based), STAs fill the TIM groups in order
+	 */
+	virtual uint16_t GetAIDFromStationIndex(uint32_t index, uint32_t rawGroupInterval);
+
 	virtual uint8_t GetSlotIndexFromAID(uint16_t aId, uint8_t nrOfSlots);
 
 	virtual Time GetSlotDuration(uint16_t slotDurationCount);
 
 	virtual bool STABelongsToRAWGroup(uint16_t aid, RPS& rps);
 
-	/**
-	 * Time to wake early for events such as beacons etc
-	 * This is time needed for the radio to go from sleeping to on and actively receive data
-	 */
-	virtual Time GetEarlyWakeTime();
+	virtual bool STABelongsToRAWGroup(uint16_t aid, const RPS::RawAssignment& raw);
 };
 
 } /* namespace ns3 */
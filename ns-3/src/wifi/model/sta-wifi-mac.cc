@@ -26,6 +26,7 @@
 #include "ns3/string.h"
 #include "ns3/pointer.h"
 #include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/trace-source-accessor.h"
 #include "qos-tag.h"
 #include "mac-low.h"
@@ -34,6 +35,7 @@
 #include "mac-tx-middle.h"
 #include "wifi-mac-header.h"
 #include "extension-headers.h"
+#include "s1g-beacon-view.h"
 #include "msdu-aggregator.h"
 #include "amsdu-subframe-header.h"
 #include "mgt-headers.h"
@@ -90,6 +92,33 @@ StaWifiMac::GetTypeId (void)
 				   MakeTimeAccessor(&StaWifiMac::m_maxTimeInQueue),
 				   MakeTimeChecker ())
 
+    .AddAttribute ("PsPollTimeout",
+                   "How long to wait for the AP to answer a PS-Poll with a data frame "
+                   "before polling again. Polls are retried at most MaxSlrc times and "
+                   "never beyond the end of the RAW slot.",
+                   TimeValue (MilliSeconds (10)),
+                   MakeTimeAccessor (&StaWifiMac::m_pspollTimeout),
+                   MakeTimeChecker ())
+    .AddAttribute ("RadioWakeUpTime",
+                   "The time the radio needs to go from sleep to a state in which it can receive. "
+                   "The station wakes up at least this long before a beacon or RAW slot it follows, "
+                   "this also has to absorb a beacon that the AP delays behind an ongoing transmission.",
+                   TimeValue (MilliSeconds (4)),
+                   MakeTimeAccessor (&StaWifiMac::m_radioWakeUpTime),
+                   MakeTimeChecker ())
+    .AddAttribute ("ClockDrift",
+                   "The worst-case drift in ppm between the clock of the station and that of the AP. "
+                   "On top of the RadioWakeUpTime the station wakes up earlier by this fraction of the "
+                   "time since it last synchronized to a beacon.",
+                   DoubleValue (20),
+                   MakeDoubleAccessor (&StaWifiMac::m_clockDrift),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("SlotEndGuardTime",
+                   "The time the station keeps listening after its RAW slot has ended, to catch "
+                   "the ACK of a transmission that finished right at the end of the slot.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&StaWifiMac::m_slotEndGuardTime),
+                   MakeTimeChecker ())
     .AddAttribute ("MaxMissedBeacons",
                    "Number of beacons which much be consecutively missed before "
                    "we attempt to restart association.",
@@ -119,6 +148,11 @@ StaWifiMac::GetTypeId (void)
 					 "Nr of transmissions during RAW slot",
 					 MakeTraceSourceAccessor (&StaWifiMac::nrOfTransmissionsDuringRAWSlot),
 					 "ns3::TracedValueCallback::Uint16")
+	.AddTraceSource ("WakeUpGuard",
+					 "Fired when the station wakes up from a doze, with the time it woke up ahead of "
+					 "its beacon or RAW slot and the time since it last synchronized to a beacon",
+					 MakeTraceSourceAccessor (&StaWifiMac::m_wakeUpGuardTrace),
+					 "ns3::StaWifiMac::WakeUpGuardCallback")
   ;
   return tid;
 }
@@ -132,6 +166,15 @@ StaWifiMac::StaWifiMac ()
   NS_LOG_FUNCTION (this);
   m_rawStart = false;
   m_dataBuffered = false;
+  m_pspollRetries = 0;
+  m_lastBeaconRx = Seconds (0);
+  m_beaconAirtime = Seconds (0);
+  m_prawRemaining = 0;
+  m_powerState = S1G_AWAKE;
+  m_slotPending = false;
+  m_slotIsPRAW = false;
+  m_appliedRawParameters.rawSlotDuration = Seconds (-1);
+  m_appliedRawParameters.maxDelay = Seconds (-1);
   m_aid = 8192;
   uint32_t cwmin = 15;
   uint32_t cwmax = 1023;
@@ -146,6 +189,10 @@ StaWifiMac::StaWifiMac ()
   fastAssocThreshold = 0; // allow some station to associate at the begining
     Ptr<UniformRandomVariable> m_rv = CreateObject<UniformRandomVariable> ();
   assocVaule = m_rv->GetValue (0, 999);
+  m_authMinInterval = 0;
+  m_authMaxInterval = 0;
+  m_authInterval = 0;
+  m_authBackoffDone = false;
 
   //Let the lower layers know that we are acting as a non-AP STA in
   //an infrastructure BSS.
@@ -304,29 +351,52 @@ StaWifiMac::SendPspoll (void)
   //use the DCF for these regardless of whether we have a QoS
   //association or not.
   m_pspollDca->Queue (packet, hdr);
+
+  // a PS-Poll is not acknowledged, without an answer from the AP we poll again
+  m_pspollTimeoutEvent.Cancel ();
+  m_pspollTimeoutEvent = Simulator::Schedule (m_pspollTimeout, &StaWifiMac::PspollTimeout, this);
+}
+
+void
+StaWifiMac::PspollTimeout (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_pspollDca->NeedsAccess ())
+    {
+      // the poll is still contending for the channel
+      m_pspollTimeoutEvent = Simulator::Schedule (m_pspollTimeout, &StaWifiMac::PspollTimeout, this);
+      return;
+    }
+  if (m_pspollRetries < m_stationManager->GetMaxSlrc ())
+    {
+      m_pspollRetries++;
+      NS_LOG_DEBUG ("no answer to PS-Poll, retry " << m_pspollRetries);
+      SendPspoll ();
+    }
 }
 
 void
 StaWifiMac::SendPspollIfnecessary (void)
 {
-  //assume only send one beacon during RAW
-  if ( m_rawStart && m_inRawGroup && m_pagedStaRaw && m_dataBuffered )
+  // the TIM of our TIM group beacon announced data for us, the AP
+  // only delivers it once we poll for it in our slot
+  if (m_dataBuffered)
     {
-     // SendPspoll ();  //pspoll not really send, just put ps-poll frame in m_pspollDca queue
+      ClearDataBuffered ();
+      m_pspollRetries = 0;
+      SendPspoll ();
     }
-  else if (!m_rawStart && m_dataBuffered && !m_outsideRawEvent.IsRunning ()) //in case the next beacon coming during RAW, could it happen?
-   {
-     // SendPspoll ();
-   }
 }
 
 
 bool StaWifiMac::IsTherePendingOutgoingData() {
-    return m_dca->NeedsAccess() ||
-    m_edca.find (AC_VO)->second->NeedsAccess() ||
-	m_edca.find (AC_VI)->second->NeedsAccess() ||
-	m_edca.find (AC_BE)->second->NeedsAccess() ||
-	m_edca.find (AC_BK)->second->NeedsAccess();
+	if (m_dca->NeedsAccess())
+		return true;
+	for (EdcaQueues::const_iterator i = m_edca.begin(); i != m_edca.end(); ++i) {
+		if (i->second->NeedsAccess())
+			return true;
+	}
+	return false;
 }
 
 void
@@ -384,6 +454,30 @@ StaWifiMac::SendProbeRequest (void)
                                              &StaWifiMac::ProbeRequestTimeout, this);
 }
 
+MgtAssocRequestHeader
+StaWifiMac::CreateAssocRequest (void) const
+{
+  MgtAssocRequestHeader assoc;
+  assoc.SetSsid (GetSsid ());
+  assoc.SetSupportedRates (GetSupportedRates ());
+  if (m_htSupported)
+    {
+      assoc.SetHtCapabilities (GetHtCapabilities ());
+    }
+  return assoc;
+}
+
+void
+StaWifiMac::PreAssociate (Mac48Address bssid, const MgtAssocResponseHeader& assocResp)
+{
+  NS_LOG_FUNCTION (this << bssid);
+  m_probeRequestEvent.Cancel ();
+  m_assocRequestEvent.Cancel ();
+  SetBssid (bssid);
+  SetState (WAIT_ASSOC_RESP);
+  HandleAssocResponse (bssid, assocResp);
+}
+
 void
 StaWifiMac::SendAssociationRequest (void)
 {
@@ -393,7 +487,34 @@ StaWifiMac::SendAssociationRequest (void)
         fastAssocThreshold = 1023;
     }
 
-if (assocVaule < fastAssocThreshold)
+  bool distributed = m_s1gSupported && fasTAssocType && m_authInterval > 0;
+  if (distributed && !m_authBackoffDone)
+    {
+      // distributed authentication control: defer the request to a random
+      // slot of the current transmission interval
+      m_authBackoffDone = true;
+      if (m_authBackoff == 0)
+        {
+          // created on first use so that stations without distributed
+          // authentication control don't take a random stream
+          m_authBackoff = CreateObject<UniformRandomVariable> ();
+        }
+      Time delay = m_authSlotDuration * m_authBackoff->GetInteger (0, m_authInterval);
+      if (m_assocRequestEvent.IsRunning ())
+        {
+          m_assocRequestEvent.Cancel ();
+        }
+      m_assocRequestEvent = Simulator::Schedule (delay, &StaWifiMac::SendAssociationRequest, this);
+      return;
+    }
+  if (distributed)
+    {
+      // the interval doubles for every further attempt
+      m_authBackoffDone = false;
+      m_authInterval = std::min<uint16_t> (2 * m_authInterval, m_authMaxInterval);
+    }
+
+if (distributed || assocVaule < fastAssocThreshold)
 {
   WifiMacHeader hdr;
   hdr.SetAssocReq ();
@@ -403,12 +524,9 @@ if (assocVaule < fastAssocThreshold)
   hdr.SetDsNotFrom ();
   hdr.SetDsNotTo ();
   Ptr<Packet> packet = Create<Packet> ();
-  MgtAssocRequestHeader assoc;
-  assoc.SetSsid (GetSsid ());
-  assoc.SetSupportedRates (GetSupportedRates ());
+  MgtAssocRequestHeader assoc = CreateAssocRequest ();
   if (m_htSupported)
     {
-      assoc.SetHtCapabilities (GetHtCapabilities ());
       hdr.SetNoOrder ();
     }
 
@@ -597,7 +715,7 @@ StaWifiMac::Enqueue (Ptr<const Packet> packet, Mac48Address to)
     {
       //Sanity check that the TID is valid
       NS_ASSERT (tid < 8);
-      m_edca[QosUtilsMapTidToAc (tid)]->Queue (packet, hdr);
+      GetEdcaForAc (QosUtilsMapTidToAc (tid))->Queue (packet, hdr);
 
     }
   else
@@ -636,6 +754,8 @@ StaWifiMac::Receive(Ptr<Packet> packet, const WifiMacHeader *hdr)
 			NotifyRxDrop(packet);
 			return;
 		}
+		// the AP answered our PS-Poll
+		m_pspollTimeoutEvent.Cancel();
 		if (hdr->IsQosData()) {
 			if (hdr->IsQosAmsdu()) {
 				NS_ASSERT(hdr->GetAddr3() == GetBssid());
@@ -680,8 +800,8 @@ StaWifiMac::Receive(Ptr<Packet> packet, const WifiMacHeader *hdr)
 		}
 		return;
 	} else if (hdr->IsS1gBeacon()) {
-		S1gBeaconHeader beacon;
-		packet->RemoveHeader(beacon);
+		// the beacon is parsed once at the AP and shared by all receivers
+		Ptr<const S1gBeaconView> beacon = S1gBeaconView::FromPacket(packet);
 		bool goodBeacon = false;
 		if ((IsWaitAssocResp() || IsAssociated())
 				&& hdr->GetAddr3() != GetBssid()) // for debug
@@ -691,8 +811,11 @@ StaWifiMac::Receive(Ptr<Packet> packet, const WifiMacHeader *hdr)
 			goodBeacon = true;
 
 		if (goodBeacon) {
+			// the beacon resynchronizes our clock to that of the AP
+			m_lastBeaconRx = Simulator::Now();
+			m_beaconAirtime = Simulator::Now() - m_phy->GetLastRxStartTime();
 			Time delay = MicroSeconds(
-					beacon.GetBeaconCompatibility().GetBeaconInterval()
+					beacon->GetBeaconCompatibility().GetBeaconInterval()
 							* m_maxMissedBeacons);
 
 			RestartBeaconWatchdog(delay);
@@ -708,16 +831,9 @@ StaWifiMac::Receive(Ptr<Packet> packet, const WifiMacHeader *hdr)
 
 			UnsetInRAWgroup();
 
-			auto rawObj = beacon.GetRPS().GetRawAssigmentObj();
-
-			uint8_t * rawassign;
-			rawassign = beacon.GetRPS().GetRawAssignment();
-			uint8_t raw_len = beacon.GetRPS().GetInformationFieldSize();
-			uint8_t rawtypeindex = rawassign[0] & 0x07;
-			uint8_t pageindex = rawassign[4] & 0x03;
+			const RPS::RawAssignment& rawObj = beacon->GetRawAssignment();
 
 			uint8_t m_SlotFormat = rawObj.GetSlotFormat();
-			uint8_t m_slotCrossBoundary = rawObj.GetSlotCrossBoundary();
 			uint16_t m_slotDurationCount = rawObj.GetSlotDurationCount();
 			uint16_t m_slotNum = rawObj.GetSlotNum();
 
@@ -726,18 +842,11 @@ StaWifiMac::Receive(Ptr<Packet> packet, const WifiMacHeader *hdr)
 			m_slotDuration = strategy->GetSlotDuration(m_slotDurationCount);
 			m_lastRawDurationus = m_slotDuration * m_slotNum;
 
-			auto rps = beacon.GetRPS();
-			if (strategy->STABelongsToRAWGroup(GetAID(), rps)) {
+			if (strategy->STABelongsToRAWGroup(GetAID(), rawObj)) {
 
 				SetInRAWgroup();
-				uint16_t statsPerSlot = 0;
 				uint16_t statRawSlot = 0;
 
-				Ptr<UniformRandomVariable> m_rv = CreateObject<UniformRandomVariable>();
-				uint16_t offset = m_rv->GetValue(0, 1023);
-				offset = 0; // for test
-				statsPerSlot = (rawObj.GetRawGroupAIDEnd()
-						- rawObj.GetRawGroupAIDStart() + 1) / m_slotNum;
 				//statRawSlot = ((GetAID() & 0x03ff)-raw_start)/statsPerSlot;
 				statRawSlot = strategy->GetSlotIndexFromAID(GetAID(), m_slotNum);
 				m_statSlotStart = MicroSeconds(rawObj.GetRawStart()) + m_slotDuration * statRawSlot;
@@ -750,17 +859,26 @@ StaWifiMac::Receive(Ptr<Packet> packet, const WifiMacHeader *hdr)
 				m_pagedStaRaw = false;
 			*/
 
-			AuthenticationCtrl AuthenCtrl;
-			AuthenCtrl = beacon.GetAuthCtrl();
+			const AuthenticationCtrl& AuthenCtrl = beacon->GetAuthCtrl();
 			fasTAssocType = AuthenCtrl.GetControlType();
-			if (!fasTAssocType)  //only support centralized cnotrol
+			if (!fasTAssocType) {
 				fastAssocThreshold = AuthenCtrl.GetThreshold();
+			} else {
+				// distributed control, slot duration is given in TUs
+				m_authSlotDuration = MicroSeconds(1024 * AuthenCtrl.GetSlotDuration());
+				m_authMinInterval = std::max<uint8_t>(AuthenCtrl.GetMinInterval(), 1);
+				m_authMaxInterval = std::max(AuthenCtrl.GetMaxInterval(), m_authMinInterval);
+				if (m_authInterval == 0) {
+					m_authInterval = m_authMinInterval;
+				}
+				m_authInterval = std::min<uint16_t>(m_authInterval, m_authMaxInterval);
+			}
 
 		}
 
-		EnsureBackoffDoesNotExceedRAWSlot(beacon);
-		EnsureQueuesKeepDataLongEnough(beacon);
-		HandleS1gSleepAndSlotTimingsFromBeacon(beacon);
+		EnsureBackoffDoesNotExceedRAWSlot(*beacon);
+		EnsureQueuesKeepDataLongEnough(*beacon);
+		HandleS1gSleepAndSlotTimingsFromBeacon(*beacon);
 
 		return;
 	} else if (hdr->IsProbeResp()) {
@@ -796,50 +914,7 @@ StaWifiMac::Receive(Ptr<Packet> packet, const WifiMacHeader *hdr)
 			if (m_assocRequestEvent.IsRunning()) {
 				m_assocRequestEvent.Cancel();
 			}
-			if (assocResp.GetStatusCode().IsSuccess()) {
-				SetAID(assocResp.GetAID());
-
-				SetState(ASSOCIATED);
-				NS_LOG_DEBUG("assoc completed");
-
-				SupportedRates rates = assocResp.GetSupportedRates();
-				if (m_htSupported) {
-					HtCapabilities htcapabilities =
-							assocResp.GetHtCapabilities();
-					m_stationManager->AddStationHtCapabilities(hdr->GetAddr2(),
-							htcapabilities);
-				}
-
-				for (uint32_t i = 0; i < m_phy->GetNModes(); i++) {
-					WifiMode mode = m_phy->GetMode(i);
-					if (rates.IsSupportedRate(mode.GetDataRate())) {
-						m_stationManager->AddSupportedMode(hdr->GetAddr2(),
-								mode);
-						if (rates.IsBasicRate(mode.GetDataRate())) {
-							m_stationManager->AddBasicMode(mode);
-						}
-					}
-				}
-				if (m_htSupported) {
-					HtCapabilities htcapabilities =
-							assocResp.GetHtCapabilities();
-					for (uint32_t i = 0; i < m_phy->GetNMcs(); i++) {
-						uint8_t mcs = m_phy->GetMcs(i);
-						if (htcapabilities.IsSupportedMcs(mcs)) {
-							m_stationManager->AddSupportedMcs(hdr->GetAddr2(),
-									mcs);
-							//here should add a control to add basic MCS when it is implemented
-						}
-					}
-				}
-				if (!m_linkUp.IsNull()) {
-					m_linkUp();
-				}
-
-			} else {
-				NS_LOG_DEBUG("assoc refused");
-				SetState(REFUSED);
-			}
+			HandleAssocResponse(hdr->GetAddr2(), assocResp);
 		}
 		return;
 	}
@@ -851,9 +926,67 @@ StaWifiMac::Receive(Ptr<Packet> packet, const WifiMacHeader *hdr)
 }
 
 void
-StaWifiMac::EnsureBackoffDoesNotExceedRAWSlot(S1gBeaconHeader& beacon) {
+StaWifiMac::HandleAssocResponse(Mac48Address from, MgtAssocResponseHeader assocResp) {
+	if (assocResp.GetStatusCode().IsSuccess()) {
+		SetAID(assocResp.GetAID());
+		// a later re-association starts again from the smallest interval
+		m_authInterval = m_authMinInterval;
+		m_authBackoffDone = false;
+
+		SetState(ASSOCIATED);
+		NS_LOG_DEBUG("assoc completed");
+
+		SupportedRates rates = assocResp.GetSupportedRates();
+		if (m_htSupported) {
+			HtCapabilities htcapabilities =
+					assocResp.GetHtCapabilities();
+			m_stationManager->AddStationHtCapabilities(from,
+					htcapabilities);
+		}
+
+		for (uint32_t i = 0; i < m_phy->GetNModes(); i++) {
+			WifiMode mode = m_phy->GetMode(i);
+			if (rates.IsSupportedRate(mode.GetDataRate())) {
+				m_stationManager->AddSupportedMode(from,
+						mode);
+				if (rates.IsBasicRate(mode.GetDataRate())) {
+					m_stationManager->AddBasicMode(mode);
+				}
+			}
+		}
+		if (m_htSupported) {
+			HtCapabilities htcapabilities =
+					assocResp.GetHtCapabilities();
+			for (uint32_t i = 0; i < m_phy->GetNMcs(); i++) {
+				uint8_t mcs = m_phy->GetMcs(i);
+				if (htcapabilities.IsSupportedMcs(mcs)) {
+					m_stationManager->AddSupportedMcs(from,
+							mcs);
+					//here should add a control to add basic MCS when it is implemented
+				}
+			}
+		}
+		if (!m_linkUp.IsNull()) {
+			m_linkUp();
+		}
+
+	} else {
+		NS_LOG_DEBUG("assoc refused");
+		SetState(REFUSED);
+	}
+}
+
+void
+StaWifiMac::EnsureBackoffDoesNotExceedRAWSlot(const S1gBeaconView& beacon) {
+
+	Time slotDuration = strategy->GetSlotDuration(beacon.GetRawAssignment().GetSlotDurationCount());
+	if (slotDuration == m_appliedRawParameters.rawSlotDuration) {
+		// the timings already follow this slot duration, nothing to propagate
+		return;
+	}
+	m_appliedRawParameters.rawSlotDuration = slotDuration;
 
-	 auto rawSlotDuration = strategy->GetSlotDuration(beacon.GetRPS().GetRawAssigmentObj().GetSlotDurationCount()).GetMicroSeconds();
+	 auto rawSlotDuration = slotDuration.GetMicroSeconds();
 
 	  // CWMax is 1023 so max backoff slot duration has to be RAWslotduration / 1023
 	  uint16_t backoffSlotDuration = rawSlotDuration / 1023;
@@ -869,20 +1002,23 @@ StaWifiMac::EnsureBackoffDoesNotExceedRAWSlot(S1gBeaconHeader& beacon) {
 }
 
 void
-StaWifiMac::EnsureQueuesKeepDataLongEnough(S1gBeaconHeader& beacon) {
+StaWifiMac::EnsureQueuesKeepDataLongEnough(const S1gBeaconView& beacon) {
 //	Time entireCycle = MicroSeconds(beacon.GetTIM().GetDTIMPeriod() * beacon.GetBeaconCompatibility().GetBeaconInterval());
 
 	Time duration = m_maxTimeInQueue; //entireCycle * 10;
+	if (duration == m_appliedRawParameters.maxDelay) {
+		return;
+	}
+	m_appliedRawParameters.maxDelay = duration;
 	m_dca->GetQueue()->SetMaxDelay(duration);
-	m_edca.find (AC_VO)->second->GetEdcaQueue()->SetMaxDelay(duration);
-	m_edca.find (AC_VI)->second->GetEdcaQueue()->SetMaxDelay(duration);
-	m_edca.find (AC_BE)->second->GetEdcaQueue()->SetMaxDelay(duration);
-	m_edca.find (AC_BK)->second->GetEdcaQueue()->SetMaxDelay(duration);
+	for (EdcaQueues::iterator i = m_edca.begin(); i != m_edca.end(); ++i) {
+		i->second->GetEdcaQueue()->SetMaxDelay(duration);
+	}
 }
 
 void
-StaWifiMac::HandleS1gSleepFromSTATIMGroupBeacon(S1gBeaconHeader& beacon) {
-	auto rawObj = beacon.GetRPS().GetRawAssigmentObj();
+StaWifiMac::HandleS1gSleepFromSTATIMGroupBeacon(const S1gBeaconView& beacon) {
+	const RPS::RawAssignment& rawObj = beacon.GetRawAssignment();
 
 	uint16_t slotIndex = strategy->GetSlotIndexFromAID(GetAID(), rawObj.GetSlotNum());
 
@@ -893,7 +1029,6 @@ StaWifiMac::HandleS1gSleepFromSTATIMGroupBeacon(S1gBeaconHeader& beacon) {
 	if(slotStartOffset > Time(0)) {
 		// go to sleep to wait until the slot comes up
 		LOG_SLEEP(Simulator::Now().GetMicroSeconds() << " Our slot only starts after " << slotStartOffset << " sleeping until then.");
-		GoToSleep(slotStartOffset);
 	}
 	else {
 		// no time for sleep, RAW slot immediately follows the beacon
@@ -911,6 +1046,10 @@ StaWifiMac::HandleS1gSleepFromSTATIMGroupBeacon(S1gBeaconHeader& beacon) {
 		// nr of TIM groups
 		remainingBeaconsUntilDTIM = beacon.GetTIM().GetDTIMPeriod();
 	}
+	// and from there on to the beacon of our page slice
+	int rawGroupSize = (rawObj.GetRawGroupAIDEnd() - rawObj.GetRawGroupAIDStart()) + 1;
+	uint8_t staTIMGroup = strategy->GetTIMGroupFromAID(GetAID(), rawGroupSize);
+	remainingBeaconsUntilDTIM += staTIMGroup - staTIMGroup % TIM::GROUPS_PER_PAGE_SLICE;
 
 	auto beaconTime = beacon.GetBeaconCompatibility().GetBeaconInterval() * remainingBeaconsUntilDTIM;
 
@@ -930,58 +1069,106 @@ StaWifiMac::HandleS1gSleepFromSTATIMGroupBeacon(S1gBeaconHeader& beacon) {
 
 	LOG_SLEEP("Scheduling sleep on " << (Simulator::Now() + endOfSlotTime).GetMicroSeconds() << "µs to sleep for " << sleepTime.GetMicroSeconds() << "µs");
 
-	// for the same reason, only sleep 2 ms later than the slot has passed because when transmissions at the end of the slot
-	// are sent, the AP will respond with a short 802.11 ACK that if missed will start a cascade of packet drop
-	Simulator::Schedule(endOfSlotTime, &StaWifiMac::GoToSleep, this, sleepTime);
+	uint16_t groupStartAId = (rawObj.GetRawGroupPage() << 11) | rawObj.GetRawGroupAIDStart();
+	if (beacon.GetTIM().IsStationBitSet(GetAID() - groupStartAId)) {
+		LOG_SLEEP("Data is buffered for us at the AP, polling for it in our slot");
+		SetDataBuffered();
+	} else {
+		ClearDataBuffered();
+	}
 
-	Simulator::Schedule(slotStartOffset, &StaWifiMac::OnRAWSlotStart, this);
-	Simulator::Schedule(endOfSlotTime, &StaWifiMac::OnRAWSlotEnd, this);
+	m_prawRemaining = 0;
+	if (rawObj.IsPeriodic() && rawObj.GetPRAWValidity() > 0) {
+		// follow the periodic RAW from here on, the beacons in between don't have to be received
+		Time beaconInterval = MicroSeconds(beacon.GetBeaconCompatibility().GetBeaconInterval());
+		m_prawPeriod = beaconInterval * rawObj.GetPRAWPeriodicity();
+		m_prawRemaining = rawObj.GetPRAWValidity();
+		m_prawSlotDuration = slotDuration;
+		m_prawSleepAfterLastSlot = sleepTime;
+		m_prawNextSlotStart = Simulator::Now() + beaconInterval * rawObj.GetPRAWStartOffset() + slotStartOffset;
+		if (rawObj.GetPRAWStartOffset() == 0) {
+			// the RAW of this beacon is the first occurrence
+			m_prawRemaining--;
+			m_prawNextSlotStart += m_prawPeriod;
+		}
+		if (m_prawRemaining > 0) {
+			LOG_SLEEP("Following periodic RAW, next slot at " << m_prawNextSlotStart.GetMicroSeconds() << "µs, " << std::to_string(m_prawRemaining) << " occurrences left");
+			sleepTime = m_prawNextSlotStart - (Simulator::Now() + endOfSlotTime);
+			RestartBeaconWatchdog(m_prawNextSlotStart - Simulator::Now() + m_prawPeriod * (m_prawRemaining - 1) + beaconInterval * m_maxMissedBeacons);
+		}
+	}
+
+	// the station keeps listening for SlotEndGuardTime after the slot, because when transmissions at the end of the slot
+	// are sent, the AP will respond with a short 802.11 ACK that if missed will start a cascade of packet drop
+	ScheduleRAWSlot(Simulator::Now() + slotStartOffset, slotDuration, sleepTime);
 
 	m_dcfManager->RawStart(Simulator::Now() + slotStartOffset, endOfSlotTime);
 }
 
 void
-StaWifiMac::HandleS1gSleepAndSlotTimingsFromBeacon(S1gBeaconHeader& beacon) {
+StaWifiMac::HandleS1gSleepAndSlotTimingsFromBeacon(const S1gBeaconView& beacon) {
 
 	// actively try to associate if not associated, so don't go to sleep
 	if(!IsAssociated())
 		return;
 
-	auto rawObj = beacon.GetRPS().GetRawAssigmentObj();
+	const RPS::RawAssignment& rawObj = beacon.GetRawAssignment();
+
+	if (rawObj.IsPeriodic() && strategy->STABelongsToRAWGroup(GetAID(), rawObj)) {
+		// our TIM group beacon announcing a periodic RAW, follow it regardless of the TIM
+		LOG_SLEEP(Simulator::Now().GetMicroSeconds() << " We've received our TIM group beacon with a periodic RAW");
+		HandleS1gSleepFromSTATIMGroupBeacon(beacon);
+		return;
+	}
+	if (m_prawRemaining > 0) {
+		// following a periodic RAW, the beacons in between are of no interest
+		LOG_SLEEP(Simulator::Now().GetMicroSeconds() << " Following periodic RAW, sleeping until the next slot");
+		if (m_slotPending) {
+			// otherwise the station is in its slot or listening after it, and the
+			// end of that plans the next occurrence
+			DozeUntil(m_slotStart);
+		}
+		return;
+	}
 
 	int rawGroupSize = (rawObj.GetRawGroupAIDEnd() - rawObj.GetRawGroupAIDStart()) + 1;
 
 	uint8_t staTIMGroup = strategy->GetTIMGroupFromAID(GetAID(), rawGroupSize);
+	// the traffic indication for our TIM group is in the first beacon of our page slice,
+	// with up to 32 TIM groups that is the DTIM beacon
+	uint8_t staPageSlice = staTIMGroup / TIM::GROUPS_PER_PAGE_SLICE;
+	uint8_t sliceTIMGroup = staPageSlice * TIM::GROUPS_PER_PAGE_SLICE;
 	auto beaconInterval = MicroSeconds(beacon.GetBeaconCompatibility().GetBeaconInterval());
 
-	if(beacon.GetTIM().GetTIMCount() == 0) {
-		// DTIM beacon
-		uint32_t vmap = beacon.GetTIM().GetPartialVBitmap();
+	const TIM& tim = beacon.GetTIM();
+	if(tim.CarriesPageSlice() && tim.GetPageSliceNumber() == staPageSlice) {
+		// page slice beacon
+		uint32_t vmap = tim.GetPartialVBitmap();
 
-		bool isThereDataToBeReceived = (vmap >> staTIMGroup) & 0x01 == 0x01;
+		bool isThereDataToBeReceived = (vmap >> (staTIMGroup - sliceTIMGroup)) & 0x01 == 0x01;
 		bool isThereDataToBeTransmitted = this->IsTherePendingOutgoingData();
 
 		if (isThereDataToBeReceived || isThereDataToBeTransmitted) {
 
 			// there is data or we need to send data, sleep until our TIM group beacon arrives
-			if(staTIMGroup == 0) {
+			if(staTIMGroup == sliceTIMGroup) {
 				// but wait, it's this beacon!
-				LOG_SLEEP(Simulator::Now().GetMicroSeconds() << " There is pending data to be received or transmitted (R:" << isThereDataToBeReceived << "," << "S:" << isThereDataToBeTransmitted << ")" << " , the DTIM beacon IS our TIM group");
+				LOG_SLEEP(Simulator::Now().GetMicroSeconds() << " There is pending data to be received or transmitted (R:" << isThereDataToBeReceived << "," << "S:" << isThereDataToBeTransmitted << ")" << " , the page slice beacon IS our TIM group");
 				HandleS1gSleepFromSTATIMGroupBeacon(beacon);
 			}
 			else {
 				//m_phy->SetSleepMode();
-				// this is TIM group 0, we're waiting for TIM group x
-				// so sleep x * beaconInterval
+				// this is the first TIM group of the slice, we're waiting for TIM group x
+				// so sleep (x - first) * beaconInterval
 				//Simulator::Schedule(beaconInterval * staTIMGroup, &StaWifiMac::OnSleepEnd, this);
 				LOG_SLEEP(Simulator::Now().GetMicroSeconds() << " There is pending data to be received or transmitted," << "(R:" << isThereDataToBeReceived << "," << "S:" << isThereDataToBeTransmitted << ")" << " go to sleep until our TIM beacon is scheduled to arrive");
-				GoToSleep(beaconInterval * staTIMGroup);
+				GoToSleep(beaconInterval * (staTIMGroup - sliceTIMGroup));
 			}
 		} else {
 			// no pending data, sleep for entire period
 
-			LOG_SLEEP(Simulator::Now().GetMicroSeconds() << " No pending data flagged in DTIM or in the queues, go to sleep for entire cycle");
-			GoToSleep(beaconInterval * beacon.GetTIM().GetDTIMPeriod());
+			LOG_SLEEP(Simulator::Now().GetMicroSeconds() << " No pending data flagged in the TIM or in the queues, go to sleep for entire cycle");
+			GoToSleep(beaconInterval * tim.GetDTIMPeriod());
 			//m_phy->SetSleepMode();
 
 			// next DTIM beacon will be in beacon interval * nr of beacons
@@ -990,8 +1177,7 @@ StaWifiMac::HandleS1gSleepAndSlotTimingsFromBeacon(S1gBeaconHeader& beacon) {
 	}
 	else {
 
-		auto rps = beacon.GetRPS();
-		if(strategy->STABelongsToRAWGroup(GetAID(),rps)) {
+		if(strategy->STABelongsToRAWGroup(GetAID(), beacon.GetRawAssignment())) {
 			// our TIM group beacon
 			// great, let's process the RAW then go back to sleep again
 			// let's sleep until our slot comes up
@@ -1000,10 +1186,20 @@ StaWifiMac::HandleS1gSleepAndSlotTimingsFromBeacon(S1gBeaconHeader& beacon) {
 		}
 		else {
 			// not our TIM group beacon
-			uint8_t beaconTIMGroup = strategy->GetTIMGroupFromAID(rawObj.GetRawGroupAIDStart(), rawGroupSize);
+			uint16_t beaconAID = (rawObj.GetRawGroupPage() << 11) | rawObj.GetRawGroupAIDStart();
+			uint8_t beaconTIMGroup = strategy->GetTIMGroupFromAID(beaconAID, rawGroupSize);
+
+			if(beaconTIMGroup < sliceTIMGroup) {
+				// the beacon of our page slice is still to come, sleep until then
+				int nrOfBeacons = sliceTIMGroup - beaconTIMGroup;
+
+				LOG_SLEEP(Simulator::Now().GetMicroSeconds() << " Starting sleep because beacon received is not ours (beacon TIM group is " << std::to_string(beaconTIMGroup) << "), page slice beacon comes first");
+				GoToSleep(beaconInterval * nrOfBeacons);
 
+				m_beaconMissed(false);
+			}
 			// is our beacon still to come?
-			if(beaconTIMGroup < staTIMGroup) {
+			else if(beaconTIMGroup < staTIMGroup) {
 				// sleep until our TIM group beacon arrives
 				int nrOfBeacons = staTIMGroup - beaconTIMGroup;
 
@@ -1015,8 +1211,8 @@ StaWifiMac::HandleS1gSleepAndSlotTimingsFromBeacon(S1gBeaconHeader& beacon) {
 				//Simulator::Schedule(beaconInterval * nrOfBeacons, &StaWifiMac::OnSleepEnd, this);
 			}
 			else {
-				// DTIM is first, sleep until DTIM
-				int remainingBeaconsUntilDTIM = beacon.GetTIM().GetTIMCount();
+				// DTIM is first, sleep until the beacon of our page slice after it
+				int remainingBeaconsUntilDTIM = tim.GetTIMCount() + sliceTIMGroup;
 
 				LOG_SLEEP(Simulator::Now().GetMicroSeconds() << " Starting sleep because beacon received is not ours, (beacon TIM group is " << std::to_string(beaconTIMGroup) << ")" << " DTIM comes first");
 				GoToSleep(beaconInterval * remainingBeaconsUntilDTIM);
@@ -1039,6 +1235,7 @@ StaWifiMac::OnAssociated() {
 void
 StaWifiMac::OnDeassociated() {
     m_deAssocLogger (GetBssid ());
+    ResetPowerState ();
     // allow tranmissions until reassociated
     GrantDCAAccess();
     TryToEnsureAssociated();
@@ -1048,36 +1245,31 @@ void
 StaWifiMac::GrantDCAAccess() {
 	m_pspollDca->AccessAllowedIfRaw (true);
 	m_dca->AccessAllowedIfRaw (true);
-	m_edca.find (AC_VO)->second->AccessAllowedIfRaw (true);
-	m_edca.find (AC_VI)->second->AccessAllowedIfRaw (true);
-	m_edca.find (AC_BE)->second->AccessAllowedIfRaw (true);
-	m_edca.find (AC_BK)->second->AccessAllowedIfRaw (true);
+	for (EdcaQueues::iterator i = m_edca.begin(); i != m_edca.end(); ++i) {
+		i->second->AccessAllowedIfRaw (true);
+	}
+	m_pspollDca->RawStart(m_slotDuration);
 	m_dca->RawStart(m_slotDuration);
-	m_edca.find (AC_VO)->second->RawStart(m_slotDuration);
-	m_edca.find (AC_VI)->second->RawStart(m_slotDuration);
-	m_edca.find (AC_BE)->second->RawStart(m_slotDuration);
-	m_edca.find (AC_BK)->second->RawStart(m_slotDuration);
+	for (EdcaQueues::iterator i = m_edca.begin(); i != m_edca.end(); ++i) {
+		i->second->RawStart(m_slotDuration);
+	}
 }
 
 void
 StaWifiMac::DenyDCAAccess() {
 	m_pspollDca->AccessAllowedIfRaw (false);
 	m_dca->AccessAllowedIfRaw (false);
-	m_edca.find (AC_VO)->second->AccessAllowedIfRaw (false);
-	m_edca.find (AC_VI)->second->AccessAllowedIfRaw (false);
-	m_edca.find (AC_BE)->second->AccessAllowedIfRaw (false);
-	m_edca.find (AC_BK)->second->AccessAllowedIfRaw (false);
+	for (EdcaQueues::iterator i = m_edca.begin(); i != m_edca.end(); ++i) {
+		i->second->AccessAllowedIfRaw (false);
+	}
+	m_pspollDca->OutsideRawStart();
 	m_dca->OutsideRawStart();
-	m_edca.find (AC_VO)->second->OutsideRawStart();
-	m_edca.find (AC_VI)->second->OutsideRawStart();
-	m_edca.find (AC_BE)->second->OutsideRawStart();
-	m_edca.find (AC_BK)->second->OutsideRawStart();
-
-	nrOfTransmissionsDuringRAWSlot = m_dca->GetNrOfTransmissionsDuringRaw() +
-			m_edca.find (AC_VO)->second->GetNrOfTransmissionsDuringRaw() +
-			m_edca.find (AC_VI)->second->GetNrOfTransmissionsDuringRaw() +
-			m_edca.find (AC_BE)->second->GetNrOfTransmissionsDuringRaw() +
-			m_edca.find (AC_BK)->second->GetNrOfTransmissionsDuringRaw();
+	uint16_t nrOfTransmissions = m_dca->GetNrOfTransmissionsDuringRaw();
+	for (EdcaQueues::iterator i = m_edca.begin(); i != m_edca.end(); ++i) {
+		i->second->OutsideRawStart();
+		nrOfTransmissions += i->second->GetNrOfTransmissionsDuringRaw();
+	}
+	nrOfTransmissionsDuringRAWSlot = nrOfTransmissions;
 }
 
 void
@@ -1085,6 +1277,7 @@ StaWifiMac::OnRAWSlotStart() {
 	LOG_SLEEP(Simulator::Now().GetMicroSeconds() <<  " RAW SLOT START ");
 	LOG_SLEEP("Is there pending data to be transmitted: " << this->IsTherePendingOutgoingData())
 	GrantDCAAccess();
+	SendPspollIfnecessary();
 
 }
 
@@ -1092,26 +1285,144 @@ void
 StaWifiMac::OnRAWSlotEnd() {
 	LOG_SLEEP(Simulator::Now().GetMicroSeconds() <<  " RAW SLOT END ");
 	DenyDCAAccess();
+	// a poll that did not get out in the slot is stale by the next one
+	m_pspollDca->GetQueue()->Flush();
+	m_pspollTimeoutEvent.Cancel();
 }
 
+void
+StaWifiMac::GoToSleep(Time duration) {
+	if (m_powerState == S1G_IN_SLOT) {
+		// a beacon cut the slot short
+		OnRAWSlotEnd();
+	}
+	m_slotPending = false;
+	DozeUntil(Simulator::Now() + duration);
+}
 
 void
-StaWifiMac::OnSleepEnd() {
-	m_phy->ResumeFromSleep();
+StaWifiMac::ScheduleRAWSlot(Time slotStart, Time slotDuration, Time sleepTime) {
+	if (m_powerState == S1G_IN_SLOT) {
+		OnRAWSlotEnd();
+	}
+	m_slotPending = true;
+	m_slotIsPRAW = false;
+	m_slotStart = slotStart;
+	m_slotEnd = slotStart + slotDuration;
+	m_wakeUpAfterSlot = m_slotEnd + sleepTime;
+	DozeUntil(slotStart);
 }
 
 void
-StaWifiMac::GoToSleep(Time duration) {
-	// wake up sliiiiiiiiiiiightly earlier or the station will miss the
-	// data that it's supposed to receive
-	// this greatly depends on how fast the radio can go from sleep -> active
-	auto earlyWake = strategy->GetEarlyWakeTime();
+StaWifiMac::DozeUntil(Time wakeUp) {
+	m_powerStateEvent.Cancel();
+	// wake up earlier or the station will miss the data that it's supposed to receive
+	auto earlyWake = GetWakeUpGuard(wakeUp);
+	Time duration = wakeUp - Simulator::Now();
 	if(duration > earlyWake) {
 		m_phy->SetSleepMode();
+		m_wakeUpGuard = earlyWake;
+		m_wakeUpSinceSync = wakeUp - m_lastBeaconRx;
 		auto sleepTime = duration - earlyWake;
 		LOG_SLEEP(Simulator::Now().GetMicroSeconds() << " Sleeping for " << sleepTime.GetMicroSeconds() << "µs");
-		Simulator::Schedule(sleepTime, &StaWifiMac::OnSleepEnd, this);
+		m_powerState = S1G_DOZE;
+		m_powerStateEvent = Simulator::Schedule(sleepTime, &StaWifiMac::OnPowerStateTimer, this);
+	} else if (m_slotPending) {
+		m_powerState = S1G_WAIT_SLOT;
+		m_powerStateEvent = Simulator::Schedule(std::max(m_slotStart - Simulator::Now(), Time(0)), &StaWifiMac::OnPowerStateTimer, this);
+	} else {
+		m_powerState = S1G_AWAKE;
+	}
+}
+
+void
+StaWifiMac::OnPowerStateTimer() {
+	switch (m_powerState) {
+	case S1G_DOZE:
+		m_phy->ResumeFromSleep();
+		m_wakeUpGuardTrace(m_wakeUpGuard, m_wakeUpSinceSync);
+		if (m_slotPending) {
+			m_powerState = S1G_WAIT_SLOT;
+			m_powerStateEvent = Simulator::Schedule(m_slotStart - Simulator::Now(), &StaWifiMac::OnPowerStateTimer, this);
+		} else {
+			m_powerState = S1G_AWAKE;
+		}
+		break;
+
+	case S1G_WAIT_SLOT:
+		m_slotPending = false;
+		if (m_slotIsPRAW) {
+			// woke up for a periodic RAW slot without receiving its beacon
+			m_prawRemaining--;
+			LOG_SLEEP(Simulator::Now().GetMicroSeconds() << " PERIODIC RAW SLOT START, " << std::to_string(m_prawRemaining) << " occurrences left");
+			// after the last occurrence, sleep until the DTIM beacon again
+			m_wakeUpAfterSlot = m_slotEnd + m_prawSleepAfterLastSlot;
+			m_dcfManager->RawStart(Simulator::Now(), m_slotEnd - m_slotStart);
+		}
+		m_powerState = S1G_IN_SLOT;
+		OnRAWSlotStart();
+		m_powerStateEvent = Simulator::Schedule(m_slotEnd - Simulator::Now(), &StaWifiMac::OnPowerStateTimer, this);
+		break;
+
+	case S1G_IN_SLOT:
+		OnRAWSlotEnd();
+		if (m_slotEndGuardTime.IsStrictlyPositive()) {
+			m_powerState = S1G_SLOT_GUARD;
+			m_powerStateEvent = Simulator::Schedule(m_slotEndGuardTime, &StaWifiMac::OnPowerStateTimer, this);
+			break;
+		}
+		DozeAfterSlot();
+		break;
+
+	case S1G_SLOT_GUARD:
+		DozeAfterSlot();
+		break;
+
+	case S1G_AWAKE:
+		break;
+	}
+}
+
+void
+StaWifiMac::DozeAfterSlot() {
+	if (m_prawRemaining > 0) {
+		// the next periodic RAW occurrence follows
+		if (m_slotIsPRAW) {
+			m_prawNextSlotStart += m_prawPeriod;
+		}
+		m_slotPending = true;
+		m_slotIsPRAW = true;
+		m_slotStart = m_prawNextSlotStart;
+		m_slotEnd = m_prawNextSlotStart + m_prawSlotDuration;
+		DozeUntil(m_slotStart);
+	} else {
+		DozeUntil(m_wakeUpAfterSlot);
+	}
+}
+
+Time
+StaWifiMac::GetWakeUpGuard(Time wakeUp) const {
+	// our clock may have drifted from that of the AP since the last beacon we
+	// received, so the longer we were not synchronized the earlier we wake up
+	Time sinceSync = wakeUp - m_lastBeaconRx;
+	Time guard = m_radioWakeUpTime + NanoSeconds(sinceSync.GetNanoSeconds() * m_clockDrift / 1e6);
+	if (!m_slotPending) {
+		// beacon times are derived from the end of the last beacon, the next one
+		// already starts its airtime before that
+		guard += m_beaconAirtime;
+	}
+	return guard;
+}
+
+void
+StaWifiMac::ResetPowerState() {
+	m_powerStateEvent.Cancel();
+	if (m_powerState == S1G_DOZE) {
+		m_phy->ResumeFromSleep();
 	}
+	m_powerState = S1G_AWAKE;
+	m_slotPending = false;
+	m_prawRemaining = 0;
 }
 
 
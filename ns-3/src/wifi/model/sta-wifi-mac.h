@@ -27,14 +27,18 @@
 #include "ns3/packet.h"
 #include "ns3/traced-callback.h"
 #include "supported-rates.h"
+#include "mgt-headers.h"
 #include "amsdu-subframe-header.h"
 #include "s1g-beacon-compatibility.h"
 #include "extension-headers.h"
+#include "s1g-beacon-view.h"
 #include "s1g-strategy.h"
 #include "ns3/traced-value.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
 
+class StaPrawSlotGuardTest;
+
 
 namespace ns3  {
 
@@ -48,10 +52,16 @@ class MgtAddBaRequestHeader;
 class StaWifiMac : public RegularWifiMac
 {
 public:
+  // Allow test cases to access private members
+  friend class ::StaPrawSlotGuardTest;
+
 
 	typedef void (* S1gBeaconMissedCallback)
 		              (bool nextBeaconIsDTIM);
 
+	typedef void (* WakeUpGuardCallback)
+		              (Time guard, Time sinceSync);
+
   static TypeId GetTypeId (void);
 
   StaWifiMac ();
@@ -97,6 +107,19 @@ public:
    */
   void StartActiveAssociation (void);
 
+  /**
+   * \return the association request this STA sends to an AP
+   */
+  MgtAssocRequestHeader CreateAssocRequest (void) const;
+  /**
+   * Associate with an AP without the probe and association exchange over
+   * the air, the response is handled as if it was received from the AP.
+   *
+   * \param bssid the address of the AP
+   * \param assocResp the association response of the AP
+   */
+  void PreAssociate (Mac48Address bssid, const MgtAssocResponseHeader& assocResp);
+
   /**
    * Get Station AID.
    */
@@ -202,12 +225,24 @@ private:
    * \param aid the AID received from assoc response frame
    */
   void SetAID (uint32_t aid);
+  /**
+   * Take over the AID and the supported rates of the AP, or record that
+   * the association was refused.
+   *
+   * \param from the address of the AP
+   * \param assocResp the association response of the AP
+   */
+  void HandleAssocResponse (Mac48Address from, MgtAssocResponseHeader assocResp);
   
   void SetRawDuration (Time interval);
   Time GetRawDuration (void) const;
     
   void SendPspoll (void);
   void SendPspollIfnecessary (void);
+  /**
+   * The AP did not answer the last PS-Poll in time, poll again
+   */
+  void PspollTimeout (void);
 
   bool Is(uint8_t blockbitmap, uint8_t j);
     
@@ -218,8 +253,44 @@ private:
   void SetInRAWgroup(void);
   void UnsetInRAWgroup(void);
 
-  void OnSleepEnd();
+  /**
+   * Doze for the given duration, waking up early enough to hear the
+   * beacon that follows. Replaces whatever the STA had planned.
+   */
   void GoToSleep(Time duration);
+  /**
+   * Doze until the given RAW slot, take part in it and doze again until
+   * the STA has to listen to a beacon or a periodic RAW slot.
+   *
+   * \param slotStart the start of the RAW slot
+   * \param slotDuration the duration of the RAW slot
+   * \param sleepTime the time between the end of the slot and the next wake up
+   */
+  void ScheduleRAWSlot(Time slotStart, Time slotDuration, Time sleepTime);
+  /**
+   * Doze until the given time if it is far enough away, then continue with
+   * the pending RAW slot if there is one.
+   */
+  void DozeUntil(Time wakeUp);
+  /**
+   * Advance the power state machine, called by its single timer.
+   */
+  void OnPowerStateTimer();
+  /**
+   * Doze after the RAW slot until the next periodic RAW occurrence or the
+   * next beacon the STA has to listen to.
+   */
+  void DozeAfterSlot();
+  /**
+   * How long before the given time the radio has to wake up: the time it
+   * takes to power up plus the clock drift since the last beacon, and the
+   * airtime of the beacon when waking up for one.
+   */
+  Time GetWakeUpGuard(Time wakeUp) const;
+  /**
+   * Drop every planned transition and stay awake.
+   */
+  void ResetPowerState();
 
   void OnRAWSlotStart();
   void OnRAWSlotEnd();
@@ -237,21 +308,21 @@ private:
    */
 
   void
-  EnsureBackoffDoesNotExceedRAWSlot(S1gBeaconHeader& beacon);
+  EnsureBackoffDoesNotExceedRAWSlot(const S1gBeaconView& beacon);
 
   void
-  EnsureQueuesKeepDataLongEnough(S1gBeaconHeader& beacon);
+  EnsureQueuesKeepDataLongEnough(const S1gBeaconView& beacon);
 
   /**
    * Handle sleeping based on the beacon information
    */
-  void HandleS1gSleepAndSlotTimingsFromBeacon(S1gBeaconHeader& beacon);
+  void HandleS1gSleepAndSlotTimingsFromBeacon(const S1gBeaconView& beacon);
 
   /**
    * Handle sleeping when the STA processes the beacon of the TIM group
    * it belongs to
    */
-  void HandleS1gSleepFromSTATIMGroupBeacon(S1gBeaconHeader& beacon);
+  void HandleS1gSleepFromSTATIMGroupBeacon(const S1gBeaconView& beacon);
 
   TracedValue<uint16_t> nrOfTransmissionsDuringRAWSlot = 0;
 
@@ -264,7 +335,43 @@ private:
   bool m_inRawGroup;
   bool m_pagedStaRaw;
   bool m_dataBuffered;
-  EventId m_outsideRawEvent;
+  Time m_pspollTimeout;
+  EventId m_pspollTimeoutEvent;
+  uint32_t m_pspollRetries;
+
+  /**
+   * Where the STA is between two beacons. Every transition is driven by the
+   * single m_powerStateEvent timer.
+   */
+  enum S1gPowerState
+  {
+    S1G_AWAKE,          //!< listening, nothing planned
+    S1G_DOZE,           //!< radio asleep until the early wake up
+    S1G_WAIT_SLOT,      //!< awake, waiting for the RAW slot to start
+    S1G_IN_SLOT,        //!< channel access granted until the slot ends
+    S1G_SLOT_GUARD      //!< slot has ended, still listening for a late ACK
+  };
+  S1gPowerState m_powerState;
+  EventId m_powerStateEvent;
+  bool m_slotPending;             //!< whether a RAW slot follows the current doze
+  bool m_slotIsPRAW;              //!< whether the pending slot is a periodic RAW occurrence
+  Time m_slotStart;
+  Time m_slotEnd;
+  Time m_wakeUpAfterSlot;         //!< when to listen again after the slot
+
+  Time m_prawNextSlotStart;
+  Time m_prawPeriod;
+  Time m_prawSlotDuration;
+  Time m_prawSleepAfterLastSlot;  //!< from the end of the slot to the next DTIM beacon
+  uint8_t m_prawRemaining;        //!< occurrences of the periodic RAW still to come, the PRAW is followed while non-zero
+
+  Time m_radioWakeUpTime;
+  double m_clockDrift;            //!< in ppm
+  Time m_slotEndGuardTime;
+  Time m_lastBeaconRx;            //!< when the clock was last synchronized to a beacon
+  Time m_beaconAirtime;           //!< how long the last beacon took to receive
+  Time m_wakeUpGuard;             //!< early wake up of the current doze
+  Time m_wakeUpSinceSync;         //!< time since the last beacon at the end of the current doze
 
   enum MacState m_state;
   Time m_probeRequestTimeout;
@@ -278,6 +385,12 @@ private:
   bool fasTAssocType;
   uint16_t fastAssocThreshold;
     uint16_t assocVaule;
+  Time m_authSlotDuration;        //!< slot duration of the distributed authentication control
+  uint8_t m_authMinInterval;      //!< initial transmission interval, in authentication slots
+  uint8_t m_authMaxInterval;      //!< upper bound of the transmission interval, in authentication slots
+  uint16_t m_authInterval;        //!< current transmission interval, 0 until announced by the AP
+  bool m_authBackoffDone;         //!< whether the pending assoc request already waited for its slot
+  Ptr<UniformRandomVariable> m_authBackoff;
   
   bool m_activeProbing;
   Ptr<DcaTxop> m_pspollDca;  //!< Dedicated DcaTxop for beacons
@@ -288,7 +401,19 @@ private:
 
   Time m_maxTimeInQueue;
 
+  /**
+   * The beacon parameters the MAC timings and the queue delays were last
+   * derived from. Beacons announcing the same ones leave both alone.
+   */
+  struct RawParameterDigest
+  {
+    Time rawSlotDuration;  //!< negative until the first beacon is handled
+    Time maxDelay;         //!< negative until the first beacon is handled
+  };
+  RawParameterDigest m_appliedRawParameters;
+
   TracedCallback<bool> m_beaconMissed;
+  TracedCallback<Time, Time> m_wakeUpGuardTrace;
 
 
   TracedCallback<Mac48Address> m_assocLogger;
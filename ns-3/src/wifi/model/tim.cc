@@ -20,6 +20,7 @@
 
 #include "tim.h"
 #include "ns3/assert.h"
+#include "ns3/abort.h"
 #include "ns3/log.h" //for test
 
 namespace ns3 {
@@ -141,6 +142,10 @@ TIM::EncodedBlock::Is (uint8_t info, uint8_t n)
 */
 
 TIM::TIM ()
+  : m_DTIMCount (0),
+    m_DTIMPeriod (0),
+    m_BitmapControl (0),
+    m_partialVBitmap (0)
 {
 }
 
@@ -160,13 +165,37 @@ TIM::SetDTIMPeriod (uint8_t count)
   m_DTIMPeriod = count;
 }
 
-//to be implemented, should divided into traffic indicator, page slice and page index
+// bit 0: traffic indicator, bits 1-5: page slice number, bits 6-7: page index
 void
 TIM::SetBitmapControl (uint8_t control)
 {
-  //to be implemented
   m_BitmapControl = control;
 }
+
+void
+TIM::SetPageSlice (uint8_t page, uint8_t slice)
+{
+  NS_ASSERT (page <= 3 && slice <= 31);
+  m_BitmapControl = ((page & 0x03) << 6) | ((slice & 0x1f) << 1) | 0x01;
+}
+
+bool
+TIM::CarriesPageSlice (void) const
+{
+  return (m_BitmapControl & 0x01) == 0x01;
+}
+
+uint8_t
+TIM::GetPageSliceNumber (void) const
+{
+  return (m_BitmapControl >> 1) & 0x1f;
+}
+
+uint8_t
+TIM::GetPageIndex (void) const
+{
+  return (m_BitmapControl >> 6) & 0x03;
+}
     
 void
 TIM::SetPartialVBitmap (uint32_t val)
@@ -198,6 +227,45 @@ TIM::SetPartialVBitmap (uint32_t val)
    */
 }
     
+void
+TIM::SetStationBitmapSize (uint16_t nStations)
+{
+  NS_ABORT_MSG_IF (nStations > MAX_STATION_BITMAP_SIZE,
+                   "A TIM can indicate at most " << MAX_STATION_BITMAP_SIZE << " stations, not " << nStations);
+  m_stationBitmap.assign ((nStations + 7) / 8, 0);
+}
+
+void
+TIM::SetStationBit (uint16_t index, bool buffered)
+{
+  NS_ASSERT (index / 8 < m_stationBitmap.size ());
+  uint8_t mask = 1 << (index % 8);
+  if (buffered)
+    {
+      m_stationBitmap[index / 8] |= mask;
+    }
+  else
+    {
+      m_stationBitmap[index / 8] &= ~mask;
+    }
+}
+
+bool
+TIM::IsStationBitSet (uint16_t index) const
+{
+  if (index / 8 >= m_stationBitmap.size ())
+    {
+      return false;
+    }
+  return (m_stationBitmap[index / 8] >> (index % 8)) & 0x01;
+}
+
+const std::vector<uint8_t>&
+TIM::GetStationBitmap (void) const
+{
+  return m_stationBitmap;
+}
+
 uint8_t
 TIM::GetTIMCount (void) const
 {
@@ -231,7 +299,7 @@ TIM::ElementId () const
 uint8_t
 TIM::GetInformationFieldSize () const
 {
-  return (4 + 3);
+  return (4 + 3 + m_stationBitmap.size ());
 }
 
 void
@@ -241,6 +309,10 @@ TIM::SerializeInformationField (Buffer::Iterator start) const
  start.WriteU8 (m_DTIMPeriod);
  start.WriteU8 (m_BitmapControl);
  start.WriteU32(m_partialVBitmap);
+ for (uint8_t octet : m_stationBitmap)
+   {
+     start.WriteU8 (octet);
+   }
 }
 
 uint8_t
@@ -250,6 +322,11 @@ TIM::DeserializeInformationField (Buffer::Iterator start, uint8_t length)
   m_DTIMPeriod = start.ReadU8 ();
   m_BitmapControl = start.ReadU8 ();
   m_partialVBitmap = start.ReadU32();
+  m_stationBitmap.resize (length - 7);
+  for (uint8_t i = 0; i < length - 7; i++)
+    {
+      m_stationBitmap[i] = start.ReadU8 ();
+    }
   //start.Read (m_partialVBitmap, (length-3));
 //    m_length = length-3;
   return length;
@@ -22,6 +22,7 @@
 #define TIM_H
 
 #include <stdint.h>
+#include <vector>
 #include "ns3/buffer.h"
 #include "ns3/attribute-helper.h"
 #include "ns3/wifi-information-element.h"
@@ -105,6 +106,79 @@ public:
    * \Set the Partial Virtual Bitmap
    */
   void SetPartialVBitmap (uint32_t map);
+  /**
+   * Mark the partial virtual bitmap as the traffic indication of a page
+   * slice, i.e. of the TIM groups [slice * GROUPS_PER_PAGE_SLICE,
+   * (slice + 1) * GROUPS_PER_PAGE_SLICE). Bit n of the bitmap is set when
+   * data is buffered for TIM group slice * GROUPS_PER_PAGE_SLICE + n.
+   *
+   * \param page the page index of the first TIM group of the slice
+   * \param slice the page slice number
+   */
+  void SetPageSlice (uint8_t page, uint8_t slice);
+
+  /**
+   * Return true if the partial virtual bitmap is the traffic indication
+   * of a page slice.
+   *
+   * \return true if the partial virtual bitmap indicates traffic
+   */
+  bool CarriesPageSlice (void) const;
+  /**
+   * Return the page slice number.
+   *
+   * \return the page slice number
+   */
+  uint8_t GetPageSliceNumber (void) const;
+  /**
+   * Return the page index.
+   *
+   * \return the page index
+   */
+  uint8_t GetPageIndex (void) const;
+
+  /**
+   * Number of TIM groups covered by the partial virtual bitmap of one page slice
+   */
+  static const uint8_t GROUPS_PER_PAGE_SLICE = 32;
+
+  /**
+   * Number of stations the station bitmap can hold next to the other fields
+   * in the 255 octets of the element
+   */
+  static const uint16_t MAX_STATION_BITMAP_SIZE = (255 - 7) * 8;
+
+  /**
+   * Reserve a traffic indication bit for every station of the RAW group the
+   * beacon carries, cleared. Bit n is set when data is buffered for the n-th
+   * AID of the group. Without stations the TIM only has the partial virtual
+   * bitmap.
+   *
+   * \param nStations the number of stations of the RAW group, at most
+   *        MAX_STATION_BITMAP_SIZE
+   */
+  void SetStationBitmapSize (uint16_t nStations);
+  /**
+   * Set or clear the traffic indication of a station.
+   *
+   * \param index the index of the station in the RAW group of the beacon
+   * \param buffered true if data is buffered for the station
+   */
+  void SetStationBit (uint16_t index, bool buffered);
+  /**
+   * Return true if data is buffered for a station. Stations outside the
+   * station bitmap are never indicated.
+   *
+   * \param index the index of the station in the RAW group of the beacon
+   * \return true if data is buffered for the station
+   */
+  bool IsStationBitSet (uint16_t index) const;
+  /**
+   * Return the octets of the station bitmap.
+   *
+   * \return the station bitmap
+   */
+  const std::vector<uint8_t>& GetStationBitmap (void) const;
     
   /**
    * Return the TIM Count.
@@ -147,6 +221,7 @@ private:
 
   // slightly simplified representation of the vbitmap
   uint32_t m_partialVBitmap;
+  std::vector<uint8_t> m_stationBitmap; //!< traffic indication per station of the RAW group
 
   /*TIM::EncodedBlock m_encodeblock; //!< encoded block subfield of partial Virtual Bitmap field
   uint8_t * m_partialVBitmap;
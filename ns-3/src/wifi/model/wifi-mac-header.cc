@@ -377,8 +377,9 @@ WifiMacHeader::SetDuration (Time duration)
 
 void WifiMacHeader::SetId (uint16_t id)
 {
-  NS_ASSERT ((id << 14) == 3);
-  m_duration = id;
+  // the AID in the duration/ID field of a PS-Poll has the two most significant bits set
+  NS_ASSERT (id <= 0x3fff);
+  m_duration = id | 0xc000;
 }
 
 void WifiMacHeader::SetSequenceNumber (uint16_t seq)
@@ -22,6 +22,8 @@
 #include "wifi-mode.h"
 #include "wifi-channel.h"
 #include "wifi-preamble.h"
+#include "ampdu-tag.h"
+#include "ampdu-subframe-header.h"
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
 #include "ns3/assert.h"
@@ -844,7 +846,12 @@ void
 WifiPhy::NotifyTxDrop (Ptr<const Packet> packet, DropReason reason)
 {
   m_phyTxDropTrace (packet);
-  m_phyTxDropWithDropReasonTrace (packet, reason);
+  if (!m_phyTxDropWithDropReasonTrace.IsEmpty ())
+    {
+      WifiMacHeader hdr;
+      PeekMacHeader (packet, hdr);
+      m_phyTxDropWithDropReasonTrace (packet, reason, hdr);
+    }
 }
 
 void
@@ -863,7 +870,29 @@ void
 WifiPhy::NotifyRxDrop(Ptr<const Packet> packet, DropReason reason)
 {
   m_phyRxDropTrace (packet);
-  m_phyRxDropWithDropReasonTrace(packet, reason);
+  if (!m_phyRxDropWithDropReasonTrace.IsEmpty ())
+    {
+      WifiMacHeader hdr;
+      PeekMacHeader (packet, hdr);
+      m_phyRxDropWithDropReasonTrace (packet, reason, hdr);
+    }
+}
+
+void
+WifiPhy::PeekMacHeader (Ptr<const Packet> packet, WifiMacHeader &hdr)
+{
+  AmpduTag ampdu;
+  if (packet->PeekPacketTag (ampdu))
+    {
+      Ptr<Packet> mpdu = packet->Copy ();
+      AmpduSubframeHeader subframe;
+      mpdu->RemoveHeader (subframe);
+      mpdu->PeekHeader (hdr);
+    }
+  else
+    {
+      packet->PeekHeader (hdr);
+    }
 }
 
 void
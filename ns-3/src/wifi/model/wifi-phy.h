@@ -33,6 +33,7 @@
 #include "ns3/traced-callback.h"
 #include "wifi-tx-vector.h"
 #include "drop-reason.h"
+#include "wifi-mac-header.h"
 
 namespace ns3 {
 
@@ -170,11 +171,20 @@ public:
    */
   typedef Callback<void, Ptr<const Packet>, double> RxErrorCallback;
 
+  /**
+   * TracedCallback signature for a packet dropped by the PHY.
+   *
+   * \param [in] packet The packet that was dropped.
+   * \param [in] reason Why the packet was dropped.
+   * \param [in] hdr The MAC header of the packet, which carries the
+   *            transmitter, receiver and frame type without having to
+   *            walk the packet metadata.
+   */
   typedef void (* PhyRxDropWithReasonCallback)
-                (Ptr<const Packet> packet, DropReason reason);
+                (Ptr<const Packet> packet, DropReason reason, const WifiMacHeader &hdr);
 
   typedef void (* PhyTxDropWithReasonCallback)
-                  (Ptr<const Packet> packet, DropReason reason);
+                  (Ptr<const Packet> packet, DropReason reason, const WifiMacHeader &hdr);
 
 
   static TypeId GetTypeId (void);
@@ -1826,6 +1836,15 @@ private:
    */
   TracedCallback<Ptr<const Packet> > m_phyTxEndTrace;
 
+  /**
+   * Read the MAC header of a packet handed to or received from the channel,
+   * skipping the subframe header of an MPDU that is part of an A-MPDU.
+   *
+   * \param packet the packet
+   * \param hdr the MAC header of the packet
+   */
+  static void PeekMacHeader (Ptr<const Packet> packet, WifiMacHeader &hdr);
+
   /**
    * The trace source fired when the phy layer drops a packet as it tries
    * to transmit it.
@@ -1834,7 +1853,7 @@ private:
    */
   TracedCallback<Ptr<const Packet> > m_phyTxDropTrace;
 
-  TracedCallback<Ptr<const Packet>, DropReason> m_phyTxDropWithDropReasonTrace;
+  TracedCallback<Ptr<const Packet>, DropReason, const WifiMacHeader &> m_phyTxDropWithDropReasonTrace;
 
   /**
    * The trace source fired when a packet begins the reception process from
@@ -1858,7 +1877,7 @@ private:
    * \see class CallBackTraceSource
    */
   TracedCallback<Ptr<const Packet> > m_phyRxDropTrace;
-  TracedCallback<Ptr<const Packet>, DropReason> m_phyRxDropWithDropReasonTrace;
+  TracedCallback<Ptr<const Packet>, DropReason, const WifiMacHeader &> m_phyRxDropWithDropReasonTrace;
 
   /**
    * A trace source that emulates a wifi device in monitor mode
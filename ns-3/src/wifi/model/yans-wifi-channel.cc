@@ -89,7 +89,7 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
   NS_ASSERT (senderMobility != 0);
   uint32_t j = 0;
 
-  m_channelTransmission(sender->GetDevice(), packet->Copy());
+  m_channelTransmission(sender->GetDevice(), packet, duration);
 
 
   for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
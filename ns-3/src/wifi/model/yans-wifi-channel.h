@@ -55,7 +55,15 @@ class YansWifiChannel : public WifiChannel
 public:
   static TypeId GetTypeId (void);
 
-  typedef void (* TransmissionCallback)(Ptr<NetDevice> senderDevice, Ptr<Packet> packet);
+  /**
+   * TracedCallback signature for a transmission on the channel. The packet
+   * is the one being sent, not a copy, so it must not be modified.
+   *
+   * \param senderDevice the device that transmits
+   * \param packet the packet being sent
+   * \param duration the time the transmission occupies the channel
+   */
+  typedef void (* TransmissionCallback)(Ptr<NetDevice> senderDevice, Ptr<const Packet> packet, Time duration);
 
   YansWifiChannel ();
   virtual ~YansWifiChannel ();
@@ -133,7 +141,7 @@ private:
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
 
-  TracedCallback<Ptr<NetDevice>, Ptr<Packet>> m_channelTransmission;
+  TracedCallback<Ptr<NetDevice>, Ptr<const Packet>, Time> m_channelTransmission;
 };
 
 } //namespace ns3
@@ -0,0 +1,414 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/buffer.h"
+#include "ns3/authentication-control.h"
+#include "ns3/tim.h"
+#include "ns3/rps.h"
+#include "ns3/extension-headers.h"
+#include "ns3/simulator.h"
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Serialize an information element and deserialize it into a fresh one.
+ *
+ * \param element the element to serialize
+ * \return the element read back from the buffer
+ */
+template <typename T>
+static T
+RoundTrip (const T &element)
+{
+  Buffer buffer;
+  buffer.AddAtStart (element.GetSerializedSize ());
+  element.Serialize (buffer.Begin ());
+
+  T result;
+  result.Deserialize (buffer.Begin ());
+  return result;
+}
+
+/**
+ * The centralized and distributed forms of the authentication control
+ * element read back as they were written.
+ */
+class AuthenticationCtrlRoundTripTest : public TestCase
+{
+public:
+  AuthenticationCtrlRoundTripTest ();
+  virtual void DoRun (void);
+
+private:
+  void CheckCentralized (uint16_t threshold);
+  void CheckDistributed (uint8_t slotDuration, uint8_t maxInterval, uint8_t minInterval);
+};
+
+AuthenticationCtrlRoundTripTest::AuthenticationCtrlRoundTripTest ()
+  : TestCase ("Authentication control element serialization round trip")
+{
+}
+
+void
+AuthenticationCtrlRoundTripTest::CheckCentralized (uint16_t threshold)
+{
+  AuthenticationCtrl element;
+  element.SetControlType (false);
+  element.SetThreshold (threshold);
+
+  AuthenticationCtrl result = RoundTrip (element);
+  NS_TEST_ASSERT_MSG_EQ (result.GetControlType (), false, "centralized element read back as distributed");
+  NS_TEST_EXPECT_MSG_EQ (result.GetThreshold (), threshold, "wrong threshold");
+}
+
+void
+AuthenticationCtrlRoundTripTest::CheckDistributed (uint8_t slotDuration, uint8_t maxInterval, uint8_t minInterval)
+{
+  AuthenticationCtrl element;
+  element.SetControlType (true);
+  element.SetSlotDuration (slotDuration);
+  element.SetMaxInterval (maxInterval);
+  element.SetMinInterval (minInterval);
+
+  AuthenticationCtrl result = RoundTrip (element);
+  NS_TEST_ASSERT_MSG_EQ (result.GetControlType (), true, "distributed element read back as centralized");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) result.GetSlotDuration (), (uint32_t) slotDuration, "wrong slot duration");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) result.GetMaxInterval (), (uint32_t) maxInterval, "wrong max interval");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) result.GetMinInterval (), (uint32_t) minInterval, "wrong min interval");
+}
+
+void
+AuthenticationCtrlRoundTripTest::DoRun (void)
+{
+  CheckCentralized (0);
+  CheckCentralized (250);
+  CheckCentralized (1023);
+
+  CheckDistributed (1, 1, 1);
+  CheckDistributed (20, 255, 3);
+  // the intervals must not be taken for the control type bit
+  CheckDistributed (127, 200, 128);
+  CheckDistributed (0, 128, 0);
+}
+/**
+ * The TIM reads back with its station bitmap, up to the largest bitmap that
+ * fits the element.
+ */
+class TimRoundTripTest : public TestCase
+{
+public:
+  TimRoundTripTest ();
+  virtual void DoRun (void);
+
+private:
+  void Check (uint16_t nStations);
+};
+
+TimRoundTripTest::TimRoundTripTest ()
+  : TestCase ("TIM serialization round trip")
+{
+}
+
+void
+TimRoundTripTest::Check (uint16_t nStations)
+{
+  TIM element;
+  element.SetDTIMCount (3);
+  element.SetDTIMPeriod (8);
+  element.SetPageSlice (2, 17);
+  element.SetPartialVBitmap (0x80000401);
+  element.SetStationBitmapSize (nStations);
+  for (uint16_t i = 0; i < nStations; i += 3)
+    {
+      element.SetStationBit (i, true);
+    }
+
+  NS_TEST_ASSERT_MSG_EQ ((element.GetSerializedSize () <= 2 + 255), true, "element longer than its length octet allows");
+
+  TIM result = RoundTrip (element);
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) result.GetTIMCount (), 3, "wrong DTIM count");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) result.GetDTIMPeriod (), 8, "wrong DTIM period");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) result.GetPageIndex (), 2, "wrong page index");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) result.GetPageSliceNumber (), 17, "wrong page slice");
+  NS_TEST_EXPECT_MSG_EQ (result.GetPartialVBitmap (), 0x80000401, "wrong partial virtual bitmap");
+  NS_TEST_ASSERT_MSG_EQ (result.GetStationBitmap ().size (), (nStations + 7) / 8, "wrong station bitmap size");
+  for (uint16_t i = 0; i < nStations; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (result.IsStationBitSet (i), (i % 3 == 0), "wrong bit for station " << i);
+    }
+}
+
+void
+TimRoundTripTest::DoRun (void)
+{
+  Check (0);
+  Check (1);
+  Check (64);
+  Check (TIM::MAX_STATION_BITMAP_SIZE);
+}
+/**
+ * A RAW assignment reads back from the RPS element with both slot formats
+ * and with and without the periodic RAW parameters.
+ */
+class RpsRoundTripTest : public TestCase
+{
+public:
+  RpsRoundTripTest ();
+  virtual void DoRun (void);
+
+private:
+  void Check (uint8_t slotFormat, uint16_t slotDurationCount, uint16_t slotNum, bool periodic);
+};
+
+RpsRoundTripTest::RpsRoundTripTest ()
+  : TestCase ("RPS serialization round trip")
+{
+}
+
+void
+RpsRoundTripTest::Check (uint8_t slotFormat, uint16_t slotDurationCount, uint16_t slotNum, bool periodic)
+{
+  RPS::RawAssignment raw;
+  raw.SetRawControl (0);
+  raw.SetSlotFormat (slotFormat);
+  raw.SetSlotCrossBoundary (1);
+  raw.SetSlotDurationCount (slotDurationCount);
+  raw.SetSlotNum (slotNum);
+  raw.SetRawStart (200);
+  // page 2, AIDs 17 to 2047
+  raw.SetRawGroup ((2047 << 13) | (17 << 2) | 2);
+  raw.SetChannelInd (0x0302);
+  raw.SetPRAW (0);
+  if (periodic)
+    {
+      raw.SetPeriodicRaw (4, 10, 3);
+    }
+
+  RPS element;
+  element.SetRawAssignment (raw);
+  RPS::RawAssignment result = RoundTrip (element).GetRawAssigmentObj ();
+
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) result.GetSlotFormat (), (uint32_t) slotFormat, "wrong slot format");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) result.GetSlotCrossBoundary (), 1, "wrong cross slot boundary");
+  NS_TEST_EXPECT_MSG_EQ (result.GetSlotDurationCount (), slotDurationCount, "wrong slot duration count");
+  NS_TEST_EXPECT_MSG_EQ (result.GetSlotNum (), slotNum, "wrong number of slots");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) result.GetRawStart (), 200, "wrong RAW start");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) result.GetRawGroupPage (), 2, "wrong RAW group page");
+  NS_TEST_EXPECT_MSG_EQ (result.GetRawGroupAIDStart (), 17, "wrong first AID of the RAW group");
+  NS_TEST_EXPECT_MSG_EQ (result.GetRawGroupAIDEnd (), 2047, "wrong last AID of the RAW group");
+  NS_TEST_EXPECT_MSG_EQ (result.GetChannelInd (), 0x0302, "wrong channel indication");
+  NS_TEST_ASSERT_MSG_EQ (result.IsPeriodic (), periodic, "wrong periodic RAW indication");
+  if (periodic)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t) result.GetPRAWPeriodicity (), 4, "wrong PRAW periodicity");
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t) result.GetPRAWValidity (), 10, "wrong PRAW validity");
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t) result.GetPRAWStartOffset (), 3, "wrong PRAW start offset");
+    }
+}
+
+void
+RpsRoundTripTest::DoRun (void)
+{
+  Check (0, 255, 63, false);
+  Check (0, 100, 1, true);
+  Check (1, 2047, 7, false);
+  Check (1, 300, 5, true);
+}
+
+
+/**
+ * Every field an S1gBeaconTemplate patches ends up in the same octets as
+ * in a freshly serialized S1gBeaconHeader, including the upper TSF bits in
+ * the compatibility element.
+ */
+class S1gBeaconTemplateTest : public TestCase
+{
+public:
+  S1gBeaconTemplateTest ();
+  virtual void DoRun (void);
+
+private:
+  /// The fields the AP patches between beacons of the same TIM group
+  struct Fields
+  {
+    uint8_t dtimCount;
+    uint32_t vmap;
+    uint8_t stationBits;    //!< every station bit set in it is repeated over the station bitmap
+    uint32_t rawGroup;
+    uint8_t prawStartOffset;
+    uint16_t authThreshold;
+    uint8_t authSlotDuration;
+  };
+
+  S1gBeaconHeader CreateBeacon (const Fields &fields, bool distributed) const;
+  std::vector<uint8_t> Serialize (const Header &header) const;
+  void Compare (const S1gBeaconTemplate &beaconTemplate, const Fields &fields, bool distributed,
+                std::string patched);
+  void Check (bool distributed);
+};
+
+S1gBeaconTemplateTest::S1gBeaconTemplateTest ()
+  : TestCase ("S1G beacon template patches match a serialized beacon")
+{
+}
+
+S1gBeaconHeader
+S1gBeaconTemplateTest::CreateBeacon (const Fields &fields, bool distributed) const
+{
+  S1gBeaconCompatibility compatibility;
+  compatibility.SetBeaconInterval (102400);
+
+  TIM tim;
+  tim.SetDTIMPeriod (8);
+  tim.SetDTIMCount (fields.dtimCount);
+  tim.SetPageSlice (0, 0);
+  tim.SetPartialVBitmap (fields.vmap);
+  tim.SetStationBitmapSize (64);
+  for (uint16_t i = 0; i < 64; i++)
+    {
+      tim.SetStationBit (i, (fields.stationBits >> (i % 8)) & 0x01);
+    }
+
+  RPS::RawAssignment raw;
+  raw.SetRawControl (0);
+  raw.SetSlotFormat (0);
+  raw.SetSlotCrossBoundary (1);
+  raw.SetSlotDurationCount (100);
+  raw.SetSlotNum (4);
+  raw.SetRawStart (0);
+  raw.SetRawGroup (fields.rawGroup);
+  raw.SetChannelInd (0);
+  raw.SetPeriodicRaw (2, 5, fields.prawStartOffset);
+  RPS rps;
+  rps.SetRawAssignment (raw);
+
+  AuthenticationCtrl auth;
+  auth.SetControlType (distributed);
+  if (distributed)
+    {
+      auth.SetSlotDuration (fields.authSlotDuration);
+      auth.SetMinInterval (2);
+      auth.SetMaxInterval (40);
+    }
+  else
+    {
+      auth.SetThreshold (fields.authThreshold);
+    }
+
+  S1gBeaconHeader beacon;
+  beacon.SetBeaconCompatibility (compatibility);
+  beacon.SetTIM (tim);
+  beacon.SetRPS (rps);
+  beacon.SetAuthCtrl (auth);
+  return beacon;
+}
+
+std::vector<uint8_t>
+S1gBeaconTemplateTest::Serialize (const Header &header) const
+{
+  Buffer buffer;
+  buffer.AddAtStart (header.GetSerializedSize ());
+  header.Serialize (buffer.Begin ());
+  std::vector<uint8_t> bytes (buffer.GetSize ());
+  buffer.CopyData (bytes.data (), bytes.size ());
+  return bytes;
+}
+
+void
+S1gBeaconTemplateTest::Compare (const S1gBeaconTemplate &beaconTemplate, const Fields &fields, bool distributed,
+                                std::string patched)
+{
+  std::vector<uint8_t> expected = Serialize (CreateBeacon (fields, distributed));
+  std::vector<uint8_t> actual = Serialize (beaconTemplate);
+  NS_TEST_ASSERT_MSG_EQ (actual.size (), expected.size (), "wrong size after " << patched);
+  for (uint32_t i = 0; i < expected.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t) actual[i], (uint32_t) expected[i], "octet " << i << " differs after " << patched);
+    }
+}
+
+void
+S1gBeaconTemplateTest::Check (bool distributed)
+{
+  Fields fields = { 0, 0, 0, 0, 0, 0, 1 };
+  S1gBeaconTemplate beaconTemplate;
+  beaconTemplate.Build (CreateBeacon (fields, distributed));
+  Compare (beaconTemplate, fields, distributed, "building the template");
+
+  fields.dtimCount = 5;
+  beaconTemplate.SetDTIMCount (fields.dtimCount);
+  Compare (beaconTemplate, fields, distributed, "setting the DTIM count");
+
+  fields.vmap = 0x80c00401;
+  beaconTemplate.SetPartialVBitmap (fields.vmap);
+  Compare (beaconTemplate, fields, distributed, "setting the partial virtual bitmap");
+
+  fields.stationBits = 0xa5;
+  beaconTemplate.SetStationBitmap (CreateBeacon (fields, distributed).GetTIM ());
+  Compare (beaconTemplate, fields, distributed, "setting the station bitmap");
+
+  // page 2, AIDs 129 to 1500
+  fields.rawGroup = (1500 << 13) | (129 << 2) | 2;
+  beaconTemplate.SetRawGroup (fields.rawGroup);
+  Compare (beaconTemplate, fields, distributed, "setting the RAW group");
+
+  fields.prawStartOffset = 24;
+  beaconTemplate.SetPRAW (CreateBeacon (fields, distributed).GetRPS ().GetRawAssigmentObj ().GetPRAW ());
+  Compare (beaconTemplate, fields, distributed, "setting the periodic RAW");
+
+  if (distributed)
+    {
+      fields.authSlotDuration = 127;
+      beaconTemplate.SetAuthSlotDuration (fields.authSlotDuration);
+      Compare (beaconTemplate, fields, distributed, "setting the authentication slot duration");
+    }
+  else
+    {
+      fields.authThreshold = 0x3a5;
+      beaconTemplate.SetAuthThreshold (fields.authThreshold);
+      Compare (beaconTemplate, fields, distributed, "setting the authentication threshold");
+    }
+}
+
+void
+S1gBeaconTemplateTest::DoRun (void)
+{
+  // late enough for the TSF to need the completion field of the compatibility element
+  Time now = MicroSeconds ((uint64_t (3) << 32) + 12345);
+  Simulator::Schedule (now, &S1gBeaconTemplateTest::Check, this, false);
+  Simulator::Schedule (now, &S1gBeaconTemplateTest::Check, this, true);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+class S1gInformationElementTestSuite : public TestSuite
+{
+public:
+  S1gInformationElementTestSuite ();
+};
+
+S1gInformationElementTestSuite::S1gInformationElementTestSuite ()
+  : TestSuite ("devices-wifi-s1g-information-elements", UNIT)
+{
+  AddTestCase (new AuthenticationCtrlRoundTripTest, TestCase::QUICK);
+  AddTestCase (new TimRoundTripTest, TestCase::QUICK);
+  AddTestCase (new RpsRoundTripTest, TestCase::QUICK);
+  AddTestCase (new S1gBeaconTemplateTest, TestCase::QUICK);
+}
+
+static S1gInformationElementTestSuite g_s1gInformationElementTestSuite;
@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/s1g-wifi-mac-helper.h"
+#include "ns3/sta-wifi-mac.h"
+#include "ns3/nstime.h"
+#include "ns3/ssid.h"
+#include "ns3/string.h"
+
+using namespace ns3;
+
+/**
+ * A station following a periodic RAW keeps following it when a beacon of
+ * another group arrives while it listens after its slot for SlotEndGuardTime.
+ */
+class StaPrawSlotGuardTest : public TestCase
+{
+public:
+  StaPrawSlotGuardTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \param aidStart the first AID of the RAW group
+   * \param aidEnd the last AID of the RAW group
+   * \param periodic whether the RAW is a periodic RAW
+   * \return a beacon with a single RAW slot right after it
+   */
+  Ptr<S1gBeaconView> CreateBeacon (uint16_t aidStart, uint16_t aidEnd, bool periodic);
+  void ReceiveBeacon (Ptr<S1gBeaconView> beacon);
+  void CheckPowerState (uint32_t state, uint32_t prawRemaining, std::string when);
+
+  Ptr<StaWifiMac> m_mac;
+};
+
+StaPrawSlotGuardTest::StaPrawSlotGuardTest ()
+  : TestCase ("Periodic RAW survives a beacon during the slot end guard time")
+{
+}
+
+Ptr<S1gBeaconView>
+StaPrawSlotGuardTest::CreateBeacon (uint16_t aidStart, uint16_t aidEnd, bool periodic)
+{
+  RPS::RawAssignment raw;
+  raw.SetRawControl (0);
+  raw.SetSlotFormat (0);
+  raw.SetSlotCrossBoundary (0);
+  // 500 + 120 * 200 = 24.5 ms
+  raw.SetSlotDurationCount (200);
+  raw.SetSlotNum (1);
+  raw.SetRawStart (0);
+  raw.SetRawGroup ((aidEnd << 13) | (aidStart << 2));
+  raw.SetChannelInd (0);
+  raw.SetPRAW (0);
+  if (periodic)
+    {
+      // every other beacon, three occurrences starting with this one
+      raw.SetPeriodicRaw (2, 3, 0);
+    }
+  RPS rps;
+  rps.SetRawAssignment (raw);
+
+  TIM tim;
+  tim.SetDTIMCount (0);
+  tim.SetDTIMPeriod (1);
+
+  S1gBeaconCompatibility compatibility;
+  compatibility.SetBeaconInterval (102400);
+
+  S1gBeaconHeader beacon;
+  beacon.SetBeaconCompatibility (compatibility);
+  beacon.SetTIM (tim);
+  beacon.SetRPS (rps);
+  return Create<S1gBeaconView> (beacon);
+}
+
+void
+StaPrawSlotGuardTest::ReceiveBeacon (Ptr<S1gBeaconView> beacon)
+{
+  m_mac->HandleS1gSleepAndSlotTimingsFromBeacon (*beacon);
+}
+
+void
+StaPrawSlotGuardTest::CheckPowerState (uint32_t state, uint32_t prawRemaining, std::string when)
+{
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) m_mac->m_powerState, state, "wrong power state " << when);
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) m_mac->m_prawRemaining, prawRemaining, "wrong periodic RAW occurrences left " << when);
+}
+
+void
+StaPrawSlotGuardTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (1);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+
+  WifiHelper wifi = WifiHelper::Default ();
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ah);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate650KbpsBW2MHz"),
+                                "ControlMode", StringValue ("OfdmRate650KbpsBW2MHz"));
+
+  S1gWifiMacHelper mac = S1gWifiMacHelper::Default ();
+  mac.SetType ("ns3::StaWifiMac",
+               "Ssid", SsidValue (Ssid ("s1g-sleep")),
+               "SlotEndGuardTime", TimeValue (MilliSeconds (2)));
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  m_mac = DynamicCast<StaWifiMac> (DynamicCast<WifiNetDevice> (devices.Get (0))->GetMac ());
+  m_mac->Initialize ();
+  m_mac->SetAID (1);
+  m_mac->SetState (StaWifiMac::ASSOCIATED);
+
+  Ptr<S1gBeaconView> ourBeacon = CreateBeacon (1, 63, true);
+  Ptr<S1gBeaconView> otherBeacon = CreateBeacon (64, 127, false);
+  Time slotEnd = MicroSeconds (24500);
+  Time period = MicroSeconds (2 * 102400);
+
+  Simulator::Schedule (Seconds (0), &StaPrawSlotGuardTest::ReceiveBeacon, this, ourBeacon);
+  Simulator::Schedule (slotEnd + MilliSeconds (1), &StaPrawSlotGuardTest::CheckPowerState, this,
+                       StaWifiMac::S1G_SLOT_GUARD, 2, "after the first slot");
+  Simulator::Schedule (slotEnd + MilliSeconds (1), &StaPrawSlotGuardTest::ReceiveBeacon, this, otherBeacon);
+  Simulator::Schedule (slotEnd + MilliSeconds (3), &StaPrawSlotGuardTest::CheckPowerState, this,
+                       StaWifiMac::S1G_DOZE, 2, "between the occurrences");
+  Simulator::Schedule (period + MilliSeconds (1), &StaPrawSlotGuardTest::CheckPowerState, this,
+                       StaWifiMac::S1G_IN_SLOT, 1, "in the second occurrence");
+  Simulator::Schedule (period * 2 + MilliSeconds (1), &StaPrawSlotGuardTest::CheckPowerState, this,
+                       StaWifiMac::S1G_IN_SLOT, 0, "in the third occurrence");
+  Simulator::Stop (period * 2 + slotEnd + MilliSeconds (10));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_mac = 0;
+}
+
+class S1gSleepTestSuite : public TestSuite
+{
+public:
+  S1gSleepTestSuite ();
+};
+
+S1gSleepTestSuite::S1gSleepTestSuite ()
+  : TestSuite ("devices-wifi-s1g-sleep", UNIT)
+{
+  AddTestCase (new StaPrawSlotGuardTest, TestCase::QUICK);
+}
+
+static S1gSleepTestSuite g_s1gSleepTestSuite;
@@ -163,6 +163,8 @@ sub analyzeFile {
      my @configParts;
      my @statParts;
      my $nrOfSta = 0;
+     my @lastNodeStats;
+     my $lastNodeStatsTime;
 
      while(my $line = <$info>) {
 
@@ -190,17 +192,37 @@ sub analyzeFile {
 
 			resolveIdxNames();
 		}
-		elsif($parts[1] eq "nodestats" && $parts[0] >= $skipTimeUntil) {
-			$hasNodeStats = 1;
-			if($parts[2] == 0) {
-				# start of new nodestats batch
-				@statParts = ();
-				for my $idx (@statsIdx) {
-					push @statParts, [];
+		elsif($parts[1] eq "nodestats") {
+			$lastNodeStats[$parts[2]] = [@parts];
+			$lastNodeStatsTime = $parts[0];
+		}
+		elsif($parts[1] eq "nodestatsdelta") {
+			# only the changed values, as pairs of their index in the nodestats line and the value
+			my $last = $lastNodeStats[$parts[2]];
+			if(defined $last) {
+				my @full = @{ $last };
+				$full[0] = $parts[0];
+				for(my $j = 3; $j + 1 < scalar @parts; $j += 2) {
+					$full[$parts[$j]] = $parts[$j + 1];
 				}
-				$nrOfSta=0;
+				$lastNodeStats[$parts[2]] = [@full];
+				$lastNodeStatsTime = $parts[0];
 			}
-			
+		}
+     }
+     close $info;
+
+     # the statistics at the end of the simulation, nodes of which nothing changed in the
+     # last interval have no record in it
+     if(defined $lastNodeStatsTime && $lastNodeStatsTime >= $skipTimeUntil) {
+		$hasNodeStats = 1;
+		for my $idx (@statsIdx) {
+			push @statParts, [];
+		}
+		for my $nodeParts (@lastNodeStats) {
+			next if !defined $nodeParts;
+			my @parts = @{ $nodeParts };
+
 			my $i = 0;
 			for my $idx (@statsIdx) {
 				my $val;
@@ -211,7 +233,7 @@ sub analyzeFile {
                         	                $val = 0;
                 	                        my @subParts = split(",",$parts[25]);
         	                                $val += $subParts[13];
-	
+
 	                                        @subParts = split(",", $parts[26]);
                                 	        $val += $subParts[13];
                         	        }
@@ -226,7 +248,6 @@ sub analyzeFile {
 			$nrOfSta+=1;
 		}
      }
-     close $info;
 
 #     for(my $i = 0; $i < scalar @statParts; $i++) {
 #  	$statParts[$i] /= $nrOfSta;